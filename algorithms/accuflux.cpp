@@ -14,6 +14,11 @@ bool cellsAreNeigbours(Cell c1, Cell c2)
 
 Cell getNeighbour(uint8_t direction, Cell cell)
 {
+    if (direction >= std::size(lookupOffsets)) {
+        // invalid ldd value, like a pit it does not point to a neighbour
+        return cell;
+    }
+
     const Offset& offset = lookupOffsets[direction];
     return Cell(cell.r + offset.y, cell.c + offset.x);
 }
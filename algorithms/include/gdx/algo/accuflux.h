@@ -218,6 +218,255 @@ void traverse_ldd_upstream(const Cell cell, const RasterType<uint8_t>& lddMap, s
     }
 }
 
+// Counts for every cell the number of neighbouring cells that flow into it
+// Throws on unsound ldd values or flows that leave the map or end in nodata (pcraster behaviour)
+template <template <typename> typename RasterType>
+std::vector<uint8_t> compute_upstream_counts(const RasterType<uint8_t>& lddMap)
+{
+    const int32_t rows = lddMap.rows();
+    const int32_t cols = lddMap.cols();
+    const auto& meta   = lddMap.metadata();
+
+    enum class LddError
+    {
+        None,
+        InvalidValue,
+        OutsideOfMap,
+        EndsInNodata,
+    };
+
+    std::vector<uint8_t> counts(size_t(rows) * size_t(cols), 0);
+    std::vector<std::pair<LddError, int32_t>> rowErrors(rows, {LddError::None, 0});
+
+#pragma omp parallel for
+    for (int32_t r = 0; r < rows; ++r) {
+        for (int32_t c = 0; c < cols; ++c) {
+            if (lddMap.is_nodata(r, c)) {
+                continue;
+            }
+
+            const uint8_t dir = lddMap(r, c);
+            if (9 < dir) {
+                if (rowErrors[r].first == LddError::None) {
+                    rowErrors[r] = {LddError::InvalidValue, c};
+                }
+                continue;
+            }
+
+            if (dir != 5) {
+                const Offset& offset = lookupOffsets[dir];
+                const Cell destCell(r + offset.y, c + offset.x);
+                if (!meta.is_on_map(destCell)) {
+                    if (rowErrors[r].first == LddError::None) {
+                        rowErrors[r] = {LddError::OutsideOfMap, c};
+                    }
+                    continue;
+                }
+
+                if (lddMap.is_nodata(destCell)) {
+                    if (rowErrors[r].first == LddError::None) {
+                        rowErrors[r] = {LddError::EndsInNodata, c};
+                    }
+                    continue;
+                }
+            }
+
+            // gather the incoming flows, so every thread only writes to the cells of its own row
+            uint8_t incoming = 0;
+            for (uint8_t i = 1; i <= 9; ++i) {
+                if (i == 5) {
+                    continue;
+                }
+
+                const Offset& offset = lookupOffsets[i];
+                const Cell neighbour(r + offset.y, c + offset.x);
+                if (meta.is_on_map(neighbour) && !lddMap.is_nodata(neighbour) && lddMap[neighbour] == 10 - i) {
+                    ++incoming;
+                }
+            }
+
+            counts[size_t(r) * cols + c] = incoming;
+        }
+    }
+
+    for (int32_t r = 0; r < rows; ++r) {
+        const auto [error, c] = rowErrors[r];
+        switch (error) {
+        case LddError::None:
+            break;
+        case LddError::InvalidValue:
+            throw RuntimeError("ldd map is unsound: ldd value outside [0..9] {}", Cell(r, c));
+        case LddError::OutsideOfMap:
+            throw RuntimeError("ldd map is unsound : it has flows out of the map {}", Cell(r, c));
+        case LddError::EndsInNodata:
+            throw RuntimeError("ldd map is unsound : it has flows into NODATA ldd cells {}", Cell(r, c));
+        }
+    }
+
+    return counts;
+}
+
+// Returns the pits of the ldd, every pit is the outlet of an independent catchment
+template <template <typename> typename RasterType>
+std::vector<Cell> find_pits(const RasterType<uint8_t>& lddMap, int64_t& dataCells)
+{
+    const int32_t rows = lddMap.rows();
+    const int32_t cols = lddMap.cols();
+
+    dataCells = 0;
+    std::vector<Cell> pits;
+    for (int32_t r = 0; r < rows; ++r) {
+        for (int32_t c = 0; c < cols; ++c) {
+            if (lddMap.is_nodata(r, c)) {
+                continue;
+            }
+
+            ++dataCells;
+            if (lddMap(r, c) == 5) {
+                pits.emplace_back(r, c);
+            }
+        }
+    }
+
+    return pits;
+}
+
+// Cells that were not visited from one of the pits are part of, or flow into a loop
+// The upstream counts of the visited cells are expected to be reset to 0
+template <template <typename> typename RasterType>
+void throw_ldd_loop_error(const RasterType<uint8_t>& lddMap, const std::vector<uint8_t>& upstreamCounts)
+{
+    const int32_t rows = lddMap.rows();
+    const int32_t cols = lddMap.cols();
+
+    for (int32_t r = 0; r < rows; ++r) {
+        for (int32_t c = 0; c < cols; ++c) {
+            if (!lddMap.is_nodata(r, c) && upstreamCounts[size_t(r) * cols + c] != 0) {
+                // traversing the ldd from this cell will throw with the location of the loop
+                traverse_ldd(Cell(r, c), lddMap, [](Cell, Cell) { return true; });
+            }
+        }
+    }
+
+    throw RuntimeError("lddMap contains a loop");
+}
+
+// Visits every data cell of the ldd exactly once in flow order: a cell is only visited when all of its upstream cells have been visited.
+// The upstream counts are computed once, after which every catchment is processed with a Kahn style topological sweep:
+// walk downstream from the source cells and only continue in a cell once its last upstream cell was visited.
+// The catchments are independent, so they are processed in parallel. The visitor is called with the cell and its downstream cell
+// (for pits the downstream cell is the cell itself) and should only modify state of those two cells.
+// Throws when the ldd is unsound or contains loops.
+template <template <typename> typename RasterType, typename VisitCb>
+void visit_ldd_in_flow_order(const RasterType<uint8_t>& lddMap, VisitCb&& visitCb, const std::function<void(int32_t, int32_t)>& progressCb = nullptr)
+{
+    const int32_t cols = lddMap.cols();
+    const int32_t total = lddMap.rows() * cols;
+
+    auto upstreamCounts = compute_upstream_counts(lddMap);
+
+    int64_t dataCells     = 0;
+    const auto pits       = find_pits(lddMap, dataCells);
+    int32_t processed     = total - inf::truncate<int32_t>(dataCells);
+    int64_t visited       = 0;
+    std::mutex progressMutex;
+
+#pragma omp parallel reduction(+ : visited)
+    {
+        std::vector<Cell> upstreamCells;
+
+#pragma omp for schedule(dynamic)
+        for (int32_t i = 0; i < int32_t(pits.size()); ++i) {
+            int32_t catchmentSize = 0;
+
+            upstreamCells.push_back(pits[i]);
+            while (!upstreamCells.empty()) {
+                auto cell = upstreamCells.back();
+                upstreamCells.pop_back();
+
+                if (upstreamCounts[size_t(cell.r) * cols + cell.c] != 0) {
+                    visit_neighbouring_upstream_cells(cell, lddMap, [&](const Cell& upstream) {
+                        if (!lddMap.is_nodata(upstream)) {
+                            upstreamCells.push_back(upstream);
+                        }
+                    });
+                    continue;
+                }
+
+                // source cell: follow the flow until we reach a cell that still has unvisited upstream cells
+                for (;;) {
+                    const auto destCell = getDestinationCell(cell, lddMap);
+                    visitCb(cell, destCell);
+                    ++catchmentSize;
+
+                    if (destCell == cell || --upstreamCounts[size_t(destCell.r) * cols + destCell.c] != 0) {
+                        break;
+                    }
+
+                    cell = destCell;
+                }
+            }
+
+            visited += catchmentSize;
+
+            if (progressCb) {
+                std::scoped_lock lock(progressMutex);
+                processed += catchmentSize;
+                progressCb(processed, total);
+            }
+        }
+    }
+
+    if (visited != dataCells) {
+        throw_ldd_loop_error(lddMap, upstreamCounts);
+    }
+}
+
+// Visits every data cell of the ldd exactly once against the flow: a cell is only visited after its downstream cell.
+// The visitor is called with the cell, its downstream cell (for pits the downstream cell is the cell itself) and the
+// state that was returned when visiting the downstream cell (a default constructed state for pits).
+// The returned state is passed on to the upstream cells. The catchments are processed in parallel.
+// Throws when the ldd is unsound or contains loops.
+template <typename State, template <typename> typename RasterType, typename VisitCb>
+void visit_ldd_against_flow_order(const RasterType<uint8_t>& lddMap, VisitCb&& visitCb)
+{
+    const int32_t cols = lddMap.cols();
+
+    auto upstreamCounts = compute_upstream_counts(lddMap);
+
+    int64_t dataCells = 0;
+    const auto pits   = find_pits(lddMap, dataCells);
+    int64_t visited   = 0;
+
+#pragma omp parallel reduction(+ : visited)
+    {
+        std::vector<std::tuple<Cell, Cell, State>> upstreamCells;
+
+#pragma omp for schedule(dynamic)
+        for (int32_t i = 0; i < int32_t(pits.size()); ++i) {
+            upstreamCells.emplace_back(pits[i], pits[i], State());
+            while (!upstreamCells.empty()) {
+                auto [cell, destCell, destState] = std::move(upstreamCells.back());
+                upstreamCells.pop_back();
+
+                auto state = visitCb(cell, destCell, destState);
+                upstreamCounts[size_t(cell.r) * cols + cell.c] = 0;
+                ++visited;
+
+                visit_neighbouring_upstream_cells(cell, lddMap, [&](const Cell& upstream) {
+                    if (!lddMap.is_nodata(upstream)) {
+                        upstreamCells.emplace_back(upstream, cell, state);
+                    }
+                });
+            }
+        }
+    }
+
+    if (visited != dataCells) {
+        throw_ldd_loop_error(lddMap, upstreamCounts);
+    }
+}
+
 template <template <typename> typename RasterType, typename VisitCb1, typename VisitCb2, typename VisitCb3, typename VisitCb4>
 void traverseInvalidLdd(Cell cell, const RasterType<uint8_t>& lddMap,
                         VisitCb1&& loopCb,
@@ -557,17 +806,17 @@ RasterType<float> accuflux(const RasterType<uint8_t>& lddMap, const RasterType<f
         for (int32_t c = 0; c < cols; ++c) {
             if (lddMap.is_nodata(r, c)) {
                 result.mark_as_nodata(r, c);
-                continue;
             }
-
-            const auto freight = freightMap(r, c);
-            detail::traverse_ldd(Cell(r, c), lddMap, [&result, freight](Cell /*cell*/, Cell destCell) {
-                result[destCell] += freight;
-                return true;
-            });
         }
     }
 
+    // every cell is visited after its upstream cells, so it contains the accumulated freight when passing it on
+    detail::visit_ldd_in_flow_order(lddMap, [&result](Cell cell, Cell destCell) {
+        if (destCell != cell) {
+            result[destCell] += result[cell];
+        }
+    });
+
     return result;
 }
 
@@ -588,35 +837,28 @@ RasterType<float> accufractionflux(
     auto meta      = lddMap.metadata();
     meta.nodata    = std::numeric_limits<float>::quiet_NaN();
 
-    RasterType<float> result(meta);
+    // contains the incoming flux from the upstream cells during the traversal
+    RasterType<float> result(meta, 0.f);
 
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            result(r, c) = freightMap(r, c) * fractionMap(r, c);
+    // the flux leaving a cell is the fraction of the cell freight and all the incoming flux
+    detail::visit_ldd_in_flow_order(lddMap, [&](Cell cell, Cell destCell) {
+        double flux = static_cast<double>(freightMap[cell]);
+        if (freightMap.is_nodata(cell) || fractionMap.is_nodata(cell)) {
+            flux = std::numeric_limits<double>::quiet_NaN();
         }
-    }
+
+        flux          = (flux + result[cell]) * fractionMap[cell];
+        result[cell]  = static_cast<float>(flux);
+        if (destCell != cell) {
+            result[destCell] += static_cast<float>(flux);
+        }
+    });
 
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
-            if (lddMap.is_nodata(r, c)) {
-                result.mark_as_nodata(r, c);
-                continue;
-            }
-
-            if (freightMap.is_nodata(r, c) || fractionMap.is_nodata(r, c)) {
+            if (lddMap.is_nodata(r, c) || std::isnan(result(r, c))) {
                 result.mark_as_nodata(r, c);
             }
-
-            auto freight = static_cast<double>(freightMap(r, c)) * fractionMap(r, c);
-            detail::traverse_ldd(Cell(r, c), lddMap, [&](Cell /*cell*/, Cell destCell) {
-                freight *= fractionMap[destCell];
-                if (std::isnan(freight)) {
-                    result.mark_as_nodata(destCell.r, destCell.c);
-                } else {
-                    result[destCell] += static_cast<float>(freight);
-                }
-                return true;
-            });
         }
     }
 
@@ -643,46 +885,37 @@ RasterType<float> flux_origin(const RasterType<uint8_t>& lddMap,
 
     RasterType<float> result(meta, 0.f);
 
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            if (lddMap.is_nodata(r, c)) {
-                result.mark_as_nodata(r, c);
-                continue;
-            }
-
-            double freight = nan;
-            if (!freightMap.is_nodata(r, c) && !fractionMap.is_nodata(r, c)) {
-                freight = static_cast<double>(freightMap(r, c)) * fractionMap(r, c);
-            }
-
-            if (stationMap(r, c) != 0) {
-                if (std::isnan(freight)) {
-                    result.mark_as_nodata(r, c);
-                } else {
-                    result(r, c) = static_cast<float>(freight);
-                }
-                continue;
+    // The state passed upstream is the product of the fractions on the path from the downstream cell to the first station
+    // An empty state indicates that there is no station downstream
+    detail::visit_ldd_against_flow_order<std::optional<double>>(lddMap, [&](Cell cell, Cell destCell, std::optional<double> destFactor) {
+        std::optional<double> factor;
+        if (destCell != cell) {
+            if (stationMap[destCell] == 1) {
+                factor = 1.0;
+            } else if (destFactor.has_value()) {
+                factor = fractionMap.is_nodata(destCell) ? nan : *destFactor * fractionMap[destCell];
             }
+        }
 
-            detail::traverse_ldd(Cell(r, c), lddMap, [&](Cell /*cell*/, Cell destCell) -> bool {
-                if (stationMap[destCell] == 1) {
-                    if (std::isnan(freight)) {
-                        result.mark_as_nodata(r, c);
-                    } else {
-                        result(r, c) = static_cast<float>(freight);
-                    }
+        double freight = nan;
+        if (!freightMap.is_nodata(cell) && !fractionMap.is_nodata(cell)) {
+            freight = static_cast<double>(freightMap[cell]) * fractionMap[cell];
+        }
 
-                    return false;
-                }
+        if (stationMap[cell] != 0) {
+            result[cell] = static_cast<float>(freight);
+        } else if (factor.has_value()) {
+            result[cell] = static_cast<float>(freight * *factor);
+        }
 
-                if (fractionMap.is_nodata(destCell)) {
-                    freight = nan;
-                } else {
-                    freight *= fractionMap[destCell];
-                }
+        return factor;
+    });
 
-                return true;
-            });
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            if (lddMap.is_nodata(r, c) || std::isnan(result(r, c))) {
+                result.mark_as_nodata(r, c);
+            }
         }
     }
 
@@ -903,45 +1136,34 @@ RasterType<float> max_upstream_dist(const RasterType<uint8_t>& ldd, std::functio
 
     RasterType<float> result(meta, 0.f);
 
-    auto total    = rows * cols;
-    int processed = 0;
-
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
-            Cell cell(r, c);
-
-            if (progressCb) {
-                progressCb(++processed, total);
+            if (ldd.is_nodata(r, c)) {
+                result.mark_as_nodata(r, c);
             }
+        }
+    }
 
-            if (ldd.is_nodata(cell)) {
-                result.mark_as_nodata(cell);
-                continue;
+    // the most upstream cells keep distance 0, every cell passes its longest distance on to the downstream cell
+    detail::visit_ldd_in_flow_order(
+        ldd, [&](Cell cell, Cell destCell) {
+            if (destCell == cell) {
+                return;
             }
 
-            if (detail::has_upstream_cells(cell, ldd)) {
-                continue;
+            float distance = result[cell];
+            if (cell.r != destCell.r && cell.c != destCell.c) {
+                distance += cellSizeDiag;
+            } else {
+                distance += cellSize;
             }
 
-            // traverse the ldd for the most upstream cells
-            float totalDistance = 0.f;
-            detail::traverse_ldd(cell, ldd, [&](Cell cell, Cell destCell) -> bool {
-                if (cell.r != destCell.r && cell.c != destCell.c) {
-                    totalDistance += cellSizeDiag;
-                } else {
-                    totalDistance += cellSize;
-                }
-
-                auto& cellValue = result[destCell];
-                if (cellValue < totalDistance) {
-                    cellValue = totalDistance;
-                    return true;
-                }
-
-                return false;
-            });
-        }
-    }
+            auto& destValue = result[destCell];
+            if (destValue < distance) {
+                destValue = distance;
+            }
+        },
+        progressCb);
 
     return result;
 }
@@ -3,65 +3,81 @@
 #include "gdx/algo/cast.h"
 #include "gdx/algo/categoryio.h"
 #include "gdx/algo/clusterutils.h"
+#include "gdx/algo/zonalstatistics.h"
 #include "gdx/cell.h"
 #include "gdx/exception.h"
 
 #include <cassert>
 #include <limits>
-#include <map>
-#include <set>
+#include <optional>
 #include <unordered_map>
 #include <utility> // pair
 
 namespace gdx {
 
 namespace details {
-template <template <typename> typename RasterType, typename T, typename BinaryPredicate>
-std::unordered_map<int32_t, T> category_map_func(const RasterType<int32_t>& clusters, const RasterType<T>& values, T initValue, BinaryPredicate&& pred)
+// Number of rows of which category_sum_in_buffer keeps one partial sum of the clusters
+static constexpr int32_t s_bufferSumBlockRows = 16;
+
+// The zones of the categories, nodata cells and cells with category 0 do not belong to a zone
+template <template <typename> typename RasterType>
+internal::ZoneIndex category_zones(const RasterType<int32_t>& clusters)
 {
-    const auto size = clusters.size();
+    return internal::ZoneIndex(
+        clusters.size(), [&clusters](std::size_t i) { return clusters[i]; }, [&clusters](std::size_t i) { return !clusters.is_nodata(i) && clusters[i] != 0; });
+}
 
-    if (values.size() != size) {
+// The result of zoneValue(statistics) for every category with nonzero values, the nodata and zero values are ignored
+template <template <typename> typename RasterType, typename T, typename ZoneValue>
+std::vector<std::optional<T>> category_zone_values(const RasterType<int32_t>& clusters, const RasterType<T>& values, const internal::ZoneIndex& zones, ZoneValue&& zoneValue)
+{
+    if (values.size() != clusters.size()) {
         throw InvalidArgument("Cluster raster dimensions should match values raster dimensions");
     }
 
-    std::unordered_map<int32_t, T> m;
+    const auto stats = internal::zonal_statistics(zones, values);
 
-    for (std::size_t i = 0; i < size; ++i) {
-        if (!clusters.is_nodata(i) && !values.is_nodata(i)) {
-            const int cat = clusters[i];
-            const T value = values[i];
-            if (cat != 0 && value != 0) {
-                auto iter = m.find(cat);
-                if (iter == m.end()) {
-                    m[cat] = pred(initValue, value);
-                } else {
-                    m[cat] = pred(m[cat], value);
-                }
-            }
+    std::vector<std::optional<T>> result(zones.zone_count());
+    for (std::size_t zone = 0; zone < stats.size(); ++zone) {
+        if (stats[zone].nonZeroCount > 0) {
+            result[zone] = zoneValue(stats[zone]);
+        }
+    }
+
+    return result;
+}
+
+template <template <typename> typename RasterType, typename T, typename ZoneValue>
+std::unordered_map<int32_t, T> category_map_func(const RasterType<int32_t>& clusters, const RasterType<T>& values, ZoneValue&& zoneValue)
+{
+    const auto zones      = category_zones(clusters);
+    const auto zoneValues = category_zone_values(clusters, values, zones, zoneValue);
+
+    std::unordered_map<int32_t, T> m;
+    for (std::size_t zone = 0; zone < zoneValues.size(); ++zone) {
+        if (zoneValues[zone].has_value()) {
+            m.emplace(int32_t(zones.zone_id(int32_t(zone))), *zoneValues[zone]);
         }
     }
 
     return m;
 }
 
-template <template <typename> typename RasterType, typename T, typename BinaryPredicate>
-RasterType<T> category_func(const RasterType<int32_t>& clusters, const RasterType<T>& values, T initValue, BinaryPredicate&& pred)
+template <template <typename> typename RasterType, typename T, typename ZoneValue>
+RasterType<T> category_func(const RasterType<int32_t>& clusters, const RasterType<T>& values, ZoneValue&& zoneValue)
 {
     const auto size = clusters.size();
 
     RasterType<T> result(values.metadata(), 0);
-    auto m = category_map_func(clusters, values, initValue, pred);
+    const auto zones      = category_zones(clusters);
+    const auto zoneValues = category_zone_values(clusters, values, zones, zoneValue);
 
     for (std::size_t i = 0; i < size; ++i) {
         if (clusters.is_nodata(i)) {
             result.mark_as_nodata(i);
-        } else {
-            const auto cat = clusters[i];
-            if (cat != 0) {
-                result[i] = m[cat];
-                result.mark_as_data(i);
-            }
+        } else if (const auto zone = zones.cell_zone(i); zone >= 0) {
+            result[i] = zoneValues[zone].value_or(T(0));
+            result.mark_as_data(i);
         }
     }
 
@@ -72,19 +88,25 @@ RasterType<T> category_func(const RasterType<int32_t>& clusters, const RasterTyp
 template <template <typename> typename RasterType, typename T>
 RasterType<T> category_sum(const RasterType<int32_t>& clusters, const RasterType<T>& values)
 {
-    return details::category_func(clusters, values, T(0), std::plus<T>());
+    return details::category_func(clusters, values, [](const internal::ZoneStatistics<T>& stats) {
+        return static_cast<T>(stats.sum);
+    });
 }
 
 template <template <typename> typename RasterType, typename T>
 std::unordered_map<int32_t, T> category_sum_map(const RasterType<int32_t>& clusters, const RasterType<T>& values)
 {
-    return details::category_map_func(clusters, values, T(0), std::plus<T>());
+    return details::category_map_func(clusters, values, [](const internal::ZoneStatistics<T>& stats) {
+        return static_cast<T>(stats.sum);
+    });
 }
 
 template <template <typename> typename RasterType>
 RasterType<int32_t> category_sum(const RasterType<int32_t>& clusters, const RasterType<uint8_t>& values)
 {
-    return details::category_func(clusters, raster_cast<int32_t>(values), int32_t(0), std::plus<int32_t>());
+    return details::category_func(clusters, raster_cast<int32_t>(values), [](const internal::ZoneStatistics<int32_t>& stats) {
+        return static_cast<int32_t>(stats.sum);
+    });
 }
 
 template <template <typename> typename RasterType, typename T>
@@ -98,42 +120,15 @@ RasterType<T> category_mode(const RasterType<int32_t>& clusters, const RasterTyp
 
     RasterType<T> result(values.metadata(), 0);
 
-    // count
-    std::map<std::pair<int32_t, T>, int> counts;
-    for (std::size_t i = 0; i < size; ++i) {
-        if (!clusters.is_nodata(i) && !values.is_nodata(i)) {
-            auto cat = clusters[i];
-            if (cat != 0) {
-                const auto key = std::pair(cat, values[i]);
-                if (counts.find(key) == counts.end()) {
-                    counts[key] = 1;
-                } else {
-                    counts[key] += 1;
-                }
-            }
-        }
-    }
-
-    // get max_count
-    std::unordered_map<int32_t, T> top_count;
-    for (auto& cat_value_count : counts) {
-        auto cat   = cat_value_count.first.first;
-        auto value = cat_value_count.first.second;
-        auto count = cat_value_count.second;
-        if (top_count.find(cat) == top_count.end()) {
-            top_count[cat] = value;
-        } else {
-            if (count > counts[std::pair(cat, top_count[cat])]) {
-                top_count[cat] = value;
-            }
-        }
-    }
+    const auto zones = details::category_zones(clusters);
+    const auto modes = internal::zonal_mode(zones, values);
 
-    // assign value with max_count
+    // assign the mode of the category, nodata cells use the category of their underlying value
     for (std::size_t i = 0; i < size; ++i) {
         const auto cat = clusters[i];
         if (cat != 0) {
-            result[i] = top_count[cat];
+            const auto zone = clusters.is_nodata(i) ? zones.find(cat) : zones.cell_zone(i);
+            result[i]       = zone >= 0 ? modes[zone] : T(0);
         }
     }
 
@@ -143,16 +138,16 @@ RasterType<T> category_mode(const RasterType<int32_t>& clusters, const RasterTyp
 template <template <typename> typename RasterType, typename T>
 RasterType<T> category_max(const RasterType<int32_t>& clusters, const RasterType<T>& values)
 {
-    return details::category_func(clusters, values, std::numeric_limits<T>::lowest(), [](auto lhs, auto rhs) {
-        return std::max(lhs, rhs);
+    return details::category_func(clusters, values, [](const internal::ZoneStatistics<T>& stats) {
+        return stats.maxNonZero;
     });
 }
 
 template <template <typename> typename RasterType, typename T>
 RasterType<T> category_min(const RasterType<int32_t>& clusters, const RasterType<T>& values)
 {
-    return details::category_func(clusters, values, std::numeric_limits<T>::max(), [](auto lhs, auto rhs) {
-        return std::min(lhs, rhs);
+    return details::category_func(clusters, values, [](const internal::ZoneStatistics<T>& stats) {
+        return stats.minNonZero;
     });
 }
 
@@ -220,45 +215,64 @@ RasterType<int32_t> category_filter_not(const RasterType<int32_t>& clusters, con
 }
 
 namespace internal {
-template <template <typename> typename RasterType>
-std::set<int32_t> get_clusters_around(const int32_t row, const int32_t col, const RasterType<int32_t>& clusters, const float radiusInCells)
+
+// The zones in a moving window, counts the cells of every zone and keeps track of the zones that are present
+class ZoneWindow
 {
-    std::set<int32_t> idAround;
-    int32_t radius = static_cast<int32_t>(radiusInCells);
-
-    const auto rows = clusters.rows();
-    const auto cols = clusters.cols();
-
-    int r0 = row - radius;
-    if (r0 < 0) r0 = 0;
-    int r1 = row + radius;
-    if (r1 > rows - 1) r1 = rows - 1;
-    int c0 = col - radius;
-    if (c0 < 0) c0 = 0;
-    int c1 = col + radius;
-    if (c1 > cols - 1) c1 = cols - 1;
-    const int radiusSqr = int(radiusInCells * radiusInCells);
-    for (int r = r0; r <= r1; ++r) {
-        for (int c = c0; c <= c1; ++c) {
-            if (clusters.is_nodata(r, c)) {
-                continue;
-            }
+public:
+    explicit ZoneWindow(std::size_t zoneCount)
+    : _counts(zoneCount, 0)
+    , _activePosition(zoneCount, 0)
+    {
+    }
 
-            int dr = r - row;
-            int dc = c - col;
-            if (dr * dr + dc * dc <= radiusSqr) {
-                const int id = clusters(r, c);
-                if (id) {
-                    idAround.insert(id);
-                }
-            }
+    void add(int32_t zone)
+    {
+        if (_counts[zone]++ == 0) {
+            _activePosition[zone] = int32_t(_active.size());
+            _active.push_back(zone);
         }
     }
 
-    return idAround;
-}
+    void remove(int32_t zone)
+    {
+        assert(_counts[zone] > 0);
+        if (--_counts[zone] == 0) {
+            const auto last                = _active.back();
+            _active[_activePosition[zone]] = last;
+            _activePosition[last]          = _activePosition[zone];
+            _active.pop_back();
+        }
+    }
+
+    void clear()
+    {
+        for (auto zone : _active) {
+            _counts[zone] = 0;
+        }
+        _active.clear();
+    }
+
+    // The zones that have cells in the window
+    const std::vector<int32_t>& active() const noexcept
+    {
+        return _active;
+    }
+
+private:
+    std::vector<int32_t> _counts;
+    std::vector<int32_t> _activePosition;
+    std::vector<int32_t> _active;
+};
+
 }
 
+/* Every cluster gets the sum of the nonzero values that have the cluster within the radius
+ * The clusters within the radius are kept in a window that slides along the rows, moving one cell
+ * only adds and removes the cells on the left and right border of the circle.
+ * Blocks of rows are processed in parallel, every block keeps the partial sums of the clusters it encountered.
+ * The partial sums are added in block order so the sums do not depend on the number of threads.
+ */
 template <template <typename> typename RasterType, typename T>
 RasterType<T> category_sum_in_buffer(const RasterType<int32_t>& clusters, const RasterType<T>& mapToSum, const float radiusInMeter)
 {
@@ -269,47 +283,132 @@ RasterType<T> category_sum_in_buffer(const RasterType<int32_t>& clusters, const
     const auto rows           = mapToSum.rows();
     const auto cols           = mapToSum.cols();
     const float radiusInCells = static_cast<float>(radiusInMeter / mapToSum.metadata().cellSize.x);
+    const int32_t radius      = static_cast<int32_t>(radiusInCells);
+    const int32_t radiusSqr   = int(radiusInCells * radiusInCells);
     auto resultMeta           = mapToSum.metadata();
 
     RasterType<T> result(resultMeta);
-    std::unordered_map<int, double> sum;
 
-    // loop over all cells in mapToSum
-    for (int32_t r = 0; r < rows; ++r) {
-        for (int32_t c = 0; c < cols; ++c) {
-            if (mapToSum.is_nodata(r, c)) {
-                result(r, c) = mapToSum(r, c);
-                result.mark_as_nodata(r, c);
-                continue;
-            }
+    const auto zones = details::category_zones(clusters);
+    std::vector<double> sums(zones.zone_count(), 0.0);
+
+    // the columns within the radius on every row of the circle are [-halfWidth, halfWidth]
+    std::vector<int32_t> halfWidths(std::max(0, 2 * radius + 1), 0);
+    for (int32_t dr = -radius; dr <= radius; ++dr) {
+        auto& halfWidth = halfWidths[dr + radius];
+        while (halfWidth < radius && dr * dr + (halfWidth + 1) * (halfWidth + 1) <= radiusSqr) {
+            ++halfWidth;
+        }
+    }
+
+    const auto blockCount = (rows + details::s_bufferSumBlockRows - 1) / details::s_bufferSumBlockRows;
+    std::vector<std::vector<std::pair<int32_t, double>>> blockSums(blockCount);
 
-            const T valueToSum = mapToSum(r, c);
-            if (valueToSum != 0) {
-                // bepaal rond iedere cel welke clusters er binnen een straat van radius cellen liggen
-                auto idAround = internal::get_clusters_around(r, c, clusters, radiusInCells);
+#pragma omp parallel
+    {
+        internal::ZoneWindow window(zones.zone_count());
+        std::vector<double> threadSums(zones.zone_count(), 0.0);
+        std::vector<uint8_t> zoneEncountered(zones.zone_count(), 0);
+        std::vector<int32_t> blockZones;
+
+#pragma omp for schedule(dynamic)
+        for (int32_t block = 0; block < blockCount; ++block) {
+            const auto lastRow = std::min(rows, (block + 1) * details::s_bufferSumBlockRows);
+            for (int32_t r = block * details::s_bufferSumBlockRows; r < lastRow; ++r) {
+                bool rowHasValues = false;
+                for (int32_t c = 0; c < cols && !rowHasValues; ++c) {
+                    rowHasValues = !mapToSum.is_nodata(r, c) && mapToSum(r, c) != 0;
+                }
 
-                // tel de waarde uit mapToSum op bij ieder van die clusters
-                for (auto& id : idAround) {
-                    sum[id] += valueToSum;
+                if (!rowHasValues || radius < 0) {
+                    continue;
                 }
+
+                const int32_t dr0 = std::max(-radius, -r);
+                const int32_t dr1 = std::min(radius, rows - 1 - r);
+
+                auto visitCell = [&](int32_t rr, int32_t cc, bool add) {
+                    if (cc < 0 || cc >= cols) {
+                        return;
+                    }
+
+                    if (const auto zone = zones.cell_zone(size_t(rr) * cols + cc); zone >= 0) {
+                        if (add) {
+                            window.add(zone);
+                        } else {
+                            window.remove(zone);
+                        }
+                    }
+                };
+
+                window.clear();
+                for (int32_t dr = dr0; dr <= dr1; ++dr) {
+                    const auto halfWidth = halfWidths[dr + radius];
+                    for (int32_t dc = -halfWidth; dc <= halfWidth; ++dc) {
+                        visitCell(r + dr, dc, true);
+                    }
+                }
+
+                for (int32_t c = 0; c < cols; ++c) {
+                    if (c > 0) {
+                        // slide the window one cell to the right
+                        for (int32_t dr = dr0; dr <= dr1; ++dr) {
+                            const auto halfWidth = halfWidths[dr + radius];
+                            visitCell(r + dr, c - halfWidth - 1, false);
+                            visitCell(r + dr, c + halfWidth, true);
+                        }
+                    }
+
+                    if (mapToSum.is_nodata(r, c)) {
+                        continue;
+                    }
+
+                    const T valueToSum = mapToSum(r, c);
+                    if (valueToSum != 0) {
+                        for (auto zone : window.active()) {
+                            if (!zoneEncountered[zone]) {
+                                zoneEncountered[zone] = 1;
+                                blockZones.push_back(zone);
+                            }
+
+                            threadSums[zone] += valueToSum;
+                        }
+                    }
+                }
+            }
+
+            auto& blockSum = blockSums[block];
+            blockSum.reserve(blockZones.size());
+            for (auto zone : blockZones) {
+                blockSum.emplace_back(zone, threadSums[zone]);
+                threadSums[zone]      = 0.0;
+                zoneEncountered[zone] = 0;
             }
+            blockZones.clear();
         }
     }
 
+    for (auto& blockSum : blockSums) {
+        for (auto& [zone, sum] : blockSum) {
+            sums[zone] += sum;
+        }
+
+        blockSum = {};
+    }
+
     for (int32_t r = 0; r < rows; ++r) {
         for (int32_t c = 0; c < cols; ++c) {
+            if (mapToSum.is_nodata(r, c)) {
+                result(r, c) = mapToSum(r, c);
+                result.mark_as_nodata(r, c);
+            }
+
             if (clusters.is_nodata(r, c)) {
                 continue;
             }
 
-            const int id = clusters(r, c);
-            if (id != 0) {
-                auto iterSum = sum.find(id);
-                if (iterSum != sum.end()) {
-                    result(r, c) = static_cast<T>(iterSum->second);
-                } else {
-                    result(r, c) = T(0);
-                }
+            if (const auto zone = zones.cell_zone(size_t(r) * cols + c); zone >= 0) {
+                result(r, c) = static_cast<T>(sums[zone]);
             } else {
                 result(r, c) = T(0);
             }
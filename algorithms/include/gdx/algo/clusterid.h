@@ -3,6 +3,7 @@
 #include "gdx/algo/clusterutils.h"
 #include "gdx/exception.h"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <map>
@@ -15,9 +16,6 @@ RasterType<int32_t> cluster_id(const RasterType<T>& ras, ClusterDiagonals diagon
 {
     show_warning_if_clustering_on_floats(ras);
 
-    const auto rows = ras.rows();
-    const auto cols = ras.cols();
-
     auto resultMeta = ras.metadata();
     // use -9999 as nodata as it cannot clash with a cluster id
     int32_t nodata = -9999;
@@ -26,56 +24,284 @@ RasterType<int32_t> cluster_id(const RasterType<T>& ras, ClusterDiagonals diagon
     }
 
     RasterType<int32_t> result(resultMeta);
-    RasterType<uint8_t> mark(ras.rows(), ras.cols(), s_markTodo);
-    std::vector<Cell> clusterCells;
-    FiLo<Cell> border(rows, cols);
+    const auto labels = internal::label_clusters(ras, diagonals);
 
+    // the ids are assigned in the order in which the clusters are encountered
+    // a cluster root always precedes the other cells of the cluster
     int32_t clusterId = 0;
-    for (int32_t r = 0; r < ras.rows(); ++r) {
-        for (int32_t c = 0; c < ras.cols(); ++c) {
-            if (ras.is_nodata(r, c)) {
-                result.mark_as_nodata(r, c);
-                continue;
+    for (size_t i = 0; i < ras.size(); ++i) {
+        if (ras.is_nodata(i)) {
+            result.mark_as_nodata(i);
+        } else if (ras[i] == 0) {
+            result[i] = 0;
+        } else if (labels[i] == i) {
+            result[i] = ++clusterId;
+        } else if (labels[i] != internal::s_noCluster) {
+            result[i] = result[labels[i]];
+        }
+    }
+
+    return result;
+}
+
+namespace internal {
+
+/* Cells bucketed in square tiles that cover a rectangular region of the raster
+ * The cells of a tile are stored contiguously, in the order in which they were provided
+ */
+class CellTiles
+{
+public:
+    CellTiles(Cell topLeft, int32_t rows, int32_t cols, int32_t tileSize, const std::vector<Cell>& cells)
+    : _topLeft(topLeft)
+    , _tileSize(tileSize)
+    , _tileRows((rows + tileSize - 1) / tileSize)
+    , _tileCols((cols + tileSize - 1) / tileSize)
+    , _tileOffsets(size_t(_tileRows) * size_t(_tileCols) + 1, 0)
+    , _cells(cells.size())
+    {
+        for (const auto& cell : cells) {
+            ++_tileOffsets[tile_of(cell) + 1];
+        }
+
+        for (size_t tile = 1; tile < _tileOffsets.size(); ++tile) {
+            _tileOffsets[tile] += _tileOffsets[tile - 1];
+        }
+
+        auto insertPosition = _tileOffsets;
+        for (const auto& cell : cells) {
+            _cells[insertPosition[tile_of(cell)]++] = cell;
+        }
+    }
+
+    int32_t tile_rows() const noexcept
+    {
+        return _tileRows;
+    }
+
+    int32_t tile_cols() const noexcept
+    {
+        return _tileCols;
+    }
+
+    size_t tile_count() const noexcept
+    {
+        return _tileOffsets.size() - 1;
+    }
+
+    size_t tile_index(int32_t tileRow, int32_t tileCol) const noexcept
+    {
+        return size_t(tileRow) * size_t(_tileCols) + size_t(tileCol);
+    }
+
+    // The tile row of the raster row, clamped to the covered region
+    int32_t tile_row(int32_t row) const noexcept
+    {
+        return std::clamp((row - _topLeft.r) / _tileSize, 0, _tileRows - 1);
+    }
+
+    // The tile column of the raster column, clamped to the covered region
+    int32_t tile_col(int32_t col) const noexcept
+    {
+        return std::clamp((col - _topLeft.c) / _tileSize, 0, _tileCols - 1);
+    }
+
+    size_t tile_of(Cell cell) const noexcept
+    {
+        return tile_index((cell.r - _topLeft.r) / _tileSize, (cell.c - _topLeft.c) / _tileSize);
+    }
+
+    size_t first_cell(size_t tile) const noexcept
+    {
+        return _tileOffsets[tile];
+    }
+
+    size_t cell_count(size_t tile) const noexcept
+    {
+        return _tileOffsets[tile + 1] - _tileOffsets[tile];
+    }
+
+    Cell& cell(size_t index) noexcept
+    {
+        return _cells[index];
+    }
+
+    const Cell& cell(size_t index) const noexcept
+    {
+        return _cells[index];
+    }
+
+    // Squared distance (in cells) from the cell to the nearest cell of the tile
+    int64_t distance2_to_tile(Cell cell, int32_t tileRow, int32_t tileCol) const noexcept
+    {
+        auto axisDistance = [this](int32_t value, int32_t tileStart) -> int64_t {
+            if (value < tileStart) {
+                return tileStart - value;
             }
 
-            if (ras(r, c) == 0) {
-                result(r, c) = 0;
-            } else if (ras(r, c) > 0 && mark(r, c) == s_markTodo) {
-                ++clusterId;
+            return std::max(0, value - (tileStart + _tileSize - 1));
+        };
 
-                clusterCells.clear();
-                border.clear();
+        const auto dr = axisDistance(cell.r, _topLeft.r + tileRow * _tileSize);
+        const auto dc = axisDistance(cell.c, _topLeft.c + tileCol * _tileSize);
+        return dr * dr + dc * dc;
+    }
 
-                const auto clusterValue = ras(r, c);
+private:
+    Cell _topLeft;
+    int32_t _tileSize;
+    int32_t _tileRows;
+    int32_t _tileCols;
+    std::vector<size_t> _tileOffsets;
+    std::vector<Cell> _cells;
+};
 
-                // add current cell to the cluster
-                insert_cell(Cell(r, c), clusterCells, mark, border);
+inline int64_t cell_distance2(Cell cell1, Cell cell2) noexcept
+{
+    const auto dr = int64_t(cell1.r) - cell2.r;
+    const auto dc = int64_t(cell1.c) - cell2.c;
+    return dr * dr + dc * dc;
+}
 
-                while (!border.empty()) {
-                    auto cell = border.pop_head();
+// The offsets to the following tiles (next on the same row or on the next rows) that can contain cells within the distance
+inline std::vector<Cell> forward_tile_offsets(int32_t tileSize, int64_t maxDistance2)
+{
+    auto minDistance = [tileSize](int32_t offset) -> int64_t {
+        return offset == 0 ? 0 : int64_t(std::abs(offset) - 1) * tileSize + 1;
+    };
 
-                    visit_neighbour_cells(cell, rows, cols, [&](const Cell& neighbour) {
-                        handle_cell(neighbour, clusterValue, clusterCells, mark, border, ras);
-                    });
+    int32_t reach = 0;
+    while (minDistance(reach + 1) * minDistance(reach + 1) <= maxDistance2) {
+        ++reach;
+    }
 
-                    if (diagonals == ClusterDiagonals::Include) {
-                        visit_neighbour_diag_cells(cell, rows, cols, [&](const Cell& neighbour) {
-                            handle_cell(neighbour, clusterValue, clusterCells, mark, border, ras);
-                        });
+    std::vector<Cell> offsets;
+    for (int32_t dr = 0; dr <= reach; ++dr) {
+        for (int32_t dc = -reach; dc <= reach; ++dc) {
+            if ((dr > 0 || dc > 0) && minDistance(dr) * minDistance(dr) + minDistance(dc) * minDistance(dc) <= maxDistance2) {
+                offsets.emplace_back(dr, dc);
+            }
+        }
+    }
+
+    return offsets;
+}
+
+// True if a cell of the first tile is within the distance of a cell of the second tile
+inline bool fuzzy_tiles_connected(const CellTiles& tiles, int32_t tileRow1, int32_t tileCol1, int32_t tileRow2, int32_t tileCol2, int64_t maxDistance2)
+{
+    const auto tile1 = tiles.tile_index(tileRow1, tileCol1);
+    const auto tile2 = tiles.tile_index(tileRow2, tileCol2);
+
+    for (auto i = tiles.first_cell(tile1); i < tiles.first_cell(tile1) + tiles.cell_count(tile1); ++i) {
+        const auto& cell = tiles.cell(i);
+        if (tiles.distance2_to_tile(cell, tileRow2, tileCol2) > maxDistance2) {
+            continue;
+        }
+
+        for (auto j = tiles.first_cell(tile2); j < tiles.first_cell(tile2) + tiles.cell_count(tile2); ++j) {
+            if (cell_distance2(cell, tiles.cell(j)) <= maxDistance2) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/* Union find on the tiles, all the cells within a tile belong to the same cluster as the tile size
+ * is chosen so that the cells of a tile are within the distance of each other.
+ * Blocks of tile rows are linked in parallel, the links that cross the block borders are merged afterwards.
+ * Returns the root tile for every tile that contains cells.
+ */
+inline std::vector<uint32_t> link_fuzzy_cluster_tiles(const CellTiles& tiles, int32_t tileSize, int64_t maxDistance2)
+{
+    if (tiles.tile_count() >= size_t(s_noCluster)) {
+        throw InvalidArgument("Raster is too large for clustering ({}x{} tiles)", tiles.tile_rows(), tiles.tile_cols());
+    }
+
+    const auto offsets = forward_tile_offsets(tileSize, maxDistance2);
+
+    static constexpr int32_t blockTileRows = 16;
+    const int32_t blockCount               = (tiles.tile_rows() + blockTileRows - 1) / blockTileRows;
+
+    std::vector<uint32_t> labels(tiles.tile_count(), s_noCluster);
+    for (size_t tile = 0; tile < tiles.tile_count(); ++tile) {
+        if (tiles.cell_count(tile) > 0) {
+            labels[tile] = uint32_t(tile);
+        }
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> blockBorderLinks;
+
+#pragma omp parallel
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> threadLinks;
+
+#pragma omp for schedule(dynamic)
+        for (int32_t block = 0; block < blockCount; ++block) {
+            const int32_t firstRow = block * blockTileRows;
+            const int32_t lastRow  = std::min(firstRow + blockTileRows, tiles.tile_rows());
+
+            for (int32_t tr = firstRow; tr < lastRow; ++tr) {
+                for (int32_t tc = 0; tc < tiles.tile_cols(); ++tc) {
+                    const auto tile = uint32_t(tiles.tile_index(tr, tc));
+                    if (labels[tile] == s_noCluster) {
+                        continue;
                     }
-                }
 
-                for (const auto& cell : clusterCells) {
-                    mark(cell.r, cell.c)   = s_markDone;
-                    result(cell.r, cell.c) = clusterId;
+                    for (const auto& offset : offsets) {
+                        const auto ntr = tr + offset.r;
+                        const auto ntc = tc + offset.c;
+                        if (ntr >= tiles.tile_rows() || ntc < 0 || ntc >= tiles.tile_cols()) {
+                            continue;
+                        }
+
+                        // the labels of the next block are modified by another thread, the tile contents are not
+                        const auto neighbour = uint32_t(tiles.tile_index(ntr, ntc));
+                        if (tiles.cell_count(neighbour) == 0) {
+                            continue;
+                        }
+
+                        if (ntr < lastRow) {
+                            // only the labels of this block are modified
+                            if (find_cluster_root(labels, tile) != find_cluster_root(labels, neighbour) &&
+                                fuzzy_tiles_connected(tiles, tr, tc, ntr, ntc, maxDistance2)) {
+                                merge_clusters(labels, tile, neighbour);
+                            }
+                        } else if (fuzzy_tiles_connected(tiles, tr, tc, ntr, ntc, maxDistance2)) {
+                            threadLinks.emplace_back(tile, neighbour);
+                        }
+                    }
                 }
             }
         }
+
+#pragma omp critical
+        blockBorderLinks.insert(blockBorderLinks.end(), threadLinks.begin(), threadLinks.end());
     }
 
-    return result;
+    for (const auto& [tile1, tile2] : blockBorderLinks) {
+        merge_clusters(labels, tile1, tile2);
+    }
+
+    // the parent of a tile always precedes the tile, so a single pass points every tile to its root
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (labels[i] != s_noCluster) {
+            labels[i] = labels[labels[i]];
+        }
+    }
+
+    return labels;
+}
+
 }
 
+/* Cells with a value larger than 0 that are within the radius of each other belong to the same cluster
+ * The cells are bucketed in tiles that fit within the radius, so the cells of a tile are connected by definition
+ * and only the cells of nearby tiles need to be compared to link the tiles into clusters.
+ * The cluster ids are assigned in the order in which the clusters are encountered.
+ */
 template <template <typename> typename RasterType, typename T>
 RasterType<int32_t> fuzzy_cluster_id(const RasterType<T>& ras, float radiusInMeter)
 {
@@ -94,61 +320,47 @@ RasterType<int32_t> fuzzy_cluster_id(const RasterType<T>& ras, float radiusInMet
     }
 
     RasterType<int32_t> result(resultMeta);
-    RasterType<uint8_t> mark(ras.rows(), ras.cols(), s_markDone);
 
-    for (std::size_t i = 0; i < ras.size(); ++i) {
-        if (ras.is_nodata(i)) {
-            mark[i] = s_markDone;
-            result.mark_as_nodata(i);
-            continue;
+    std::vector<Cell> cells;
+    for (int32_t r = 0; r < rows; ++r) {
+        for (int32_t c = 0; c < cols; ++c) {
+            const auto index = size_t(r) * cols + c;
+            if (ras.is_nodata(index)) {
+                result.mark_as_nodata(index);
+            } else if (ras[index] > 0) {
+                cells.emplace_back(r, c);
+            } else {
+                result[index] = 0;
+            }
         }
+    }
 
-        if (ras[i] > 0) {
-            mark[i] = s_markTodo;
-        } else {
-            result[i] = 0;
-        }
+    if (cells.empty()) {
+        return result;
     }
 
-    int32_t clusterId = 0;
-    FiLo<Cell> border(rows, cols);
+    // a cell only connects to itself when the radius is smaller than one cell
+    const int64_t maxDistance2 = radiusInCells > 0 ? radius2 : 0;
 
-    for (int32_t r = 0; r < ras.rows(); ++r) {
-        for (int32_t c = 0; c < ras.cols(); ++c) {
-            if (mark(r, c) == s_markTodo) {
-                ++clusterId;
-
-                border.clear();
-                border.push_back(Cell(r, c));
-                mark(r, c) = s_markBorder;
-                while (!border.empty()) {
-                    auto cell              = border.pop_head();
-                    mark(cell.r, cell.c)   = s_markDone;
-                    result(cell.r, cell.c) = clusterId;
-
-                    const int r0 = (cell.r - radiusInCells < 0 ? 0 : cell.r - radiusInCells);
-                    const int c0 = (cell.c - radiusInCells < 0 ? 0 : cell.c - radiusInCells);
-                    const int r1 = (cell.r + radiusInCells > rows - 1 ? rows - 1 : cell.r + radiusInCells);
-                    const int c1 = (cell.c + radiusInCells > cols - 1 ? cols - 1 : cell.c + radiusInCells);
-
-                    for (int32_t rr = r0; rr <= r1; ++rr) {
-                        const auto dr  = rr - cell.r;
-                        const auto dr2 = dr * dr;
-
-                        auto markIndex = rr * cols + c0;
-                        for (int32_t cc = c0; cc <= c1; ++markIndex, ++cc) {
-                            if (mark[markIndex] == s_markTodo) {
-                                const int dc = cc - cell.c;
-                                if (dr2 + dc * dc <= radius2) {
-                                    mark[markIndex] = s_markBorder;
-                                    border.push_back(Cell(rr, cc));
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+    // the largest tile size for which the opposite corners of the tile are within the radius
+    int32_t tileSize = 1;
+    while (2 * int64_t(tileSize) * tileSize <= maxDistance2) {
+        ++tileSize;
+    }
+
+    const internal::CellTiles tiles(Cell(0, 0), rows, cols, tileSize, cells);
+    const auto labels = internal::link_fuzzy_cluster_tiles(tiles, tileSize, maxDistance2);
+
+    // the cells are in row major order, so the clusters are numbered in the order in which they are encountered
+    std::vector<int32_t> clusterIds(tiles.tile_count(), 0);
+    int32_t clusterId = 0;
+    for (const auto& cell : cells) {
+        auto& id = clusterIds[labels[tiles.tile_of(cell)]];
+        if (id == 0) {
+            id = ++clusterId;
         }
+
+        result[cell] = id;
     }
 
     return result;
@@ -159,7 +371,7 @@ void handle_cell_with_obstacles_straight(const Cell cell,
     const RasterType<int32_t>& catMap,
     const int clusterValue,
     const RasterType<uint8_t>& obstacleMap,
-    RasterType<uint8_t>& mark,
+    MarkGrid& mark,
     FiLo<Cell>& border)
 {
     if ((catMap[cell] == clusterValue) && (mark[cell] == s_markTodo)) {
@@ -174,7 +386,7 @@ void handle_cell_with_obstacles_diag(const Cell oldCell, const Cell cell,
     const RasterType<int32_t>& catMap,
     const int clusterValue,
     const RasterType<uint8_t>& obstacleMap,
-    RasterType<uint8_t>& mark,
+    MarkGrid& mark,
     FiLo<Cell>& border)
 {
     if ((catMap[cell] == clusterValue) && (mark[cell] == s_markTodo)) {
@@ -253,7 +465,7 @@ RasterType<int32_t> cluster_id_with_obstacles(
     }
 
     RasterType<int32_t> result(resultMeta, nodata);
-    RasterType<uint8_t> mark(rows, cols, s_markTodo);
+    MarkGrid mark(rows, cols, s_markTodo);
 
     int32_t clusterId = 0;
     FiLo<Cell> border(rows, cols);
@@ -341,46 +553,78 @@ bool is_blocked_path(Cell from, Cell to, const RasterType<uint8_t>& obstacle)
     return false;
 }
 
+namespace internal {
+
+/* Flood fills the clusters of a group of cells that have the same item and background id, in row major order of the cells
+ * A cell is added to the cluster when it is within the radius of a cluster cell and the path to it is not blocked.
+ * The path is not symmetric, so the clusters are flood filled from their first cell like the grouping is defined.
+ * The candidate cells are bucketed in tiles of the radius size, cells that are assigned to a cluster are removed from
+ * their tile, so the flood fill only visits the cells that are not clustered yet instead of the full window.
+ * clusterSeeds receives the index of the first cell of the cluster for every cell of the group.
+ */
 template <template <typename> typename RasterType>
-void compute_fuzzy_cluster_id_with_obstacles_rc(Cell cell,
-    const RasterType<int32_t>& items, const RasterType<int32_t>& backgroundId,
-    const RasterType<uint8_t>& obstacles, int nRows, int nCols,
-    float radius, int clusterId, RasterType<uint8_t>& mark, FiLo<Cell>& border,
-    RasterType<int32_t>& result)
+void fuzzy_cluster_group_with_obstacles(const std::vector<Cell>& cells, const RasterType<uint8_t>& obstacles,
+    int32_t radiusInCells, int64_t radius2, std::vector<int64_t>& clusterSeeds)
 {
-    assert(mark[cell] == s_markTodo);
-    mark[cell] = s_markBorder;
-    assert(border.empty());
-    border.push_back(cell);
-    int r0, c0, r1, c1;
-    while (border.size() > 0) {
-        Cell c = border.pop_head();
-        assert(mark[c] == s_markBorder);
-        mark[c] = s_markDone;
-        assert(result[cell] == 0);
-        result[c] = clusterId;
-        result.mark_as_data(c);
-
-        r0 = c.r - int(radius + 0.5f);
-        c0 = c.c - int(radius + 0.5f);
-        r1 = c.r + int(radius + 0.5f);
-        c1 = c.c + int(radius + 0.5f);
-        r0 = std::max(r0, 0);
-        c0 = std::max(c0, 0);
-        r1 = std::min(r1, nRows - 1);
-        c1 = std::min(c1, nCols - 1);
-
-        for (int rr = r0; rr <= r1; ++rr) {
-            for (int cc = c0; cc <= c1; ++cc) {
-                const int dr = rr - c.r;
-                const int dc = cc - c.c;
-                if (dr * dr + dc * dc <= int(radius * radius)) {
-                    const Cell clcl(rr, cc);
-                    if ((items[clcl] == items[cell]) && (backgroundId[clcl] == backgroundId[cell]) && (mark[clcl] == s_markTodo)) {
-                        if (!is_blocked_path(c, clcl, obstacles)) {
-                            assert(result[clcl] == 0);
-                            mark[clcl] = s_markBorder;
-                            border.push_back(clcl);
+    const auto cols = obstacles.cols();
+
+    int32_t minCol = std::numeric_limits<int32_t>::max();
+    int32_t maxCol = std::numeric_limits<int32_t>::lowest();
+    for (const auto& cell : cells) {
+        minCol = std::min(minCol, cell.c);
+        maxCol = std::max(maxCol, cell.c);
+    }
+
+    const Cell topLeft(cells.front().r, minCol);
+    CellTiles tiles(topLeft, cells.back().r - topLeft.r + 1, maxCol - minCol + 1, std::max(radiusInCells, 1), cells);
+
+    std::vector<size_t> remaining(tiles.tile_count());
+    for (size_t tile = 0; tile < remaining.size(); ++tile) {
+        remaining[tile] = tiles.cell_count(tile);
+    }
+
+    FiLo<Cell> border(obstacles.rows(), cols);
+    for (const auto& seed : cells) {
+        const auto seedIndex = int64_t(seed.r) * cols + seed.c;
+        if (clusterSeeds[seedIndex] >= 0) {
+            continue;
+        }
+
+        clusterSeeds[seedIndex] = seedIndex;
+        border.push_back(seed);
+
+        while (!border.empty()) {
+            const auto cell = border.pop_head();
+            if (radiusInCells <= 0) {
+                continue;
+            }
+
+            for (int32_t tr = tiles.tile_row(cell.r - radiusInCells); tr <= tiles.tile_row(cell.r + radiusInCells); ++tr) {
+                for (int32_t tc = tiles.tile_col(cell.c - radiusInCells); tc <= tiles.tile_col(cell.c + radiusInCells); ++tc) {
+                    const auto tile  = tiles.tile_index(tr, tc);
+                    const auto first = tiles.first_cell(tile);
+                    auto& count      = remaining[tile];
+
+                    for (size_t i = 0; i < count;) {
+                        auto& candidate      = tiles.cell(first + i);
+                        const auto candIndex = int64_t(candidate.r) * cols + candidate.c;
+
+                        bool remove = clusterSeeds[candIndex] >= 0;
+                        if (!remove &&
+                            std::abs(candidate.r - cell.r) <= radiusInCells &&
+                            std::abs(candidate.c - cell.c) <= radiusInCells &&
+                            cell_distance2(cell, candidate) <= radius2 &&
+                            !is_blocked_path(cell, candidate, obstacles)) {
+                            clusterSeeds[candIndex] = seedIndex;
+                            border.push_back(candidate);
+                            remove = true;
+                        }
+
+                        if (remove) {
+                            // the order of the cells within the tile does not affect the clusters
+                            std::swap(candidate, tiles.cell(first + --count));
+                        } else {
+                            ++i;
                         }
                     }
                 }
@@ -389,6 +633,13 @@ void compute_fuzzy_cluster_id_with_obstacles_rc(Cell cell,
     }
 }
 
+}
+
+/* Cells with the same item value and background id (connected area without obstacles) that are within the radius
+ * of each other belong to the same cluster, unless the straight path between them is blocked by an obstacle.
+ * Cells with a different item or background id never interact, so these groups are clustered in parallel.
+ * The cluster ids are assigned in the order in which the clusters are encountered, cells on an obstacle get their own id.
+ */
 template <template <typename> typename RasterType>
 RasterType<int32_t> fuzzy_cluster_id_with_obstacles(const RasterType<int32_t>& items, const RasterType<uint8_t>& obstacles, float radiusInMeter)
 {
@@ -405,27 +656,62 @@ RasterType<int32_t> fuzzy_cluster_id_with_obstacles(const RasterType<int32_t>& i
     }
     RasterType<int32_t> result(resultMeta, nodata);
 
-    RasterType<uint8_t> mark(resultMeta, s_markTodo);
-    FiLo<Cell> border(resultMeta.rows, resultMeta.cols);
+    // sort the candidate cells on their group, the cells of a group remain in row major order
+    std::vector<std::pair<int64_t, int64_t>> groupCells;
+    for (int64_t i = 0; i < int64_t(items.size()); ++i) {
+        if (!items.is_nodata(i) && items[i] > 0 && !obstacles[i]) {
+            const auto groupKey = (int64_t(items[i]) << 32) | int64_t(uint32_t(backgroundId[i]));
+            groupCells.emplace_back(groupKey, i);
+        }
+    }
+
+    std::sort(groupCells.begin(), groupCells.end());
+
+    std::vector<size_t> groupOffsets;
+    for (size_t i = 0; i < groupCells.size(); ++i) {
+        if (i == 0 || groupCells[i].first != groupCells[i - 1].first) {
+            groupOffsets.push_back(i);
+        }
+    }
+    groupOffsets.push_back(groupCells.size());
+
+    const auto radiusInCells = int32_t(radius + 0.5f);
+    const auto radius2       = int64_t(radius * radius);
+
+    std::vector<int64_t> clusterSeeds(items.size(), -1);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t group = 0; group < int64_t(groupOffsets.size()) - 1; ++group) {
+        std::vector<Cell> cells;
+        cells.reserve(groupOffsets[group + 1] - groupOffsets[group]);
+        for (auto i = groupOffsets[group]; i < groupOffsets[group + 1]; ++i) {
+            const auto index = groupCells[i].second;
+            cells.emplace_back(int32_t(index / cols), int32_t(index % cols));
+        }
+
+        internal::fuzzy_cluster_group_with_obstacles(cells, obstacles, radiusInCells, radius2, clusterSeeds);
+    }
+
     int clusterId = 1;
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
             Cell cell(r, c);
+            const auto index = int64_t(r) * cols + c;
             if (items.is_nodata(cell)) {
-                mark[cell] = s_markDone;
                 result.mark_as_nodata(cell);
                 continue;
             }
 
-            if (items[cell] > 0 && (mark[cell] == s_markTodo)) {
+            if (items[cell] > 0) {
                 if (obstacles[cell]) {
-                    mark[cell]   = s_markDone;
-                    result[cell] = clusterId;
-                    result.mark_as_data(cell);
+                    result[cell] = clusterId++;
+                } else if (clusterSeeds[index] == index) {
+                    result[cell] = clusterId++;
                 } else {
-                    compute_fuzzy_cluster_id_with_obstacles_rc(cell, items, backgroundId, obstacles, rows, cols, radius, clusterId, mark, border, result);
+                    // the first cell of the cluster precedes the other cells
+                    result[cell] = result[clusterSeeds[index]];
                 }
-                ++clusterId;
+                result.mark_as_data(cell);
             }
         }
     }
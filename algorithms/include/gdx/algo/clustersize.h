@@ -9,14 +9,29 @@
 
 namespace gdx {
 
+namespace internal {
+
+// Assigns the value of the cluster root cell to all the cells of the cluster
+template <typename RasterType>
+void spread_cluster_root_values(const std::vector<uint32_t>& labels, RasterType& result)
+{
+    const auto size = static_cast<std::ptrdiff_t>(labels.size());
+
+#pragma omp parallel for
+    for (std::ptrdiff_t i = 0; i < size; ++i) {
+        if (labels[i] != s_noCluster && labels[i] != uint32_t(i)) {
+            result[i] = result[labels[i]];
+        }
+    }
+}
+
+}
+
 template <template <typename> typename RasterType, typename T>
 RasterType<int32_t> cluster_size(const RasterType<T>& ras, ClusterDiagonals diagonals)
 {
     show_warning_if_clustering_on_floats(ras);
 
-    const auto rows = ras.rows();
-    const auto cols = ras.cols();
-
     int32_t nodata  = -9999;
     auto resultMeta = ras.metadata();
     if (resultMeta.nodata.has_value()) {
@@ -25,54 +40,18 @@ RasterType<int32_t> cluster_size(const RasterType<T>& ras, ClusterDiagonals diag
     }
 
     RasterType<int32_t> result(resultMeta, 0);
-    RasterType<uint8_t> mark(ras.metadata(), s_markTodo);
-    std::vector<Cell> clusterCells;
-    FiLo<Cell> border(rows, cols);
-    uint32_t clusterCount = 0;
-
-    for (int32_t r = 0; r < rows; ++r) {
-        for (int32_t c = 0; c < cols; ++c) {
-            if (ras.is_nodata(r, c)) {
-                result.mark_as_nodata(r, c);
-                continue;
-            }
-
-            if (ras(r, c) == 0) {
-                result(r, c) = 0;
-            } else if (ras(r, c) > 0 && mark(r, c) == s_markTodo) {
-                ++clusterCount;
-                int32_t sum = 0;
-                clusterCells.clear();
-                border.clear();
-                const auto clusterValue = ras(r, c);
-
-                // add current cell to the cluster
-                insert_cell(Cell(r, c), clusterCells, mark, border);
-
-                while (!border.empty()) {
-                    auto cell            = border.pop_head();
-                    mark(cell.r, cell.c) = s_markDone;
-                    ++sum;
-
-                    // add the four neighbouring cells if they have the same value
-                    visit_neighbour_cells(cell, rows, cols, [&](const Cell& neighbour) {
-                        handle_cell(neighbour, clusterValue, clusterCells, mark, border, ras);
-                    });
-
-                    if (diagonals == ClusterDiagonals::Include) {
-                        visit_neighbour_diag_cells(cell, rows, cols, [&](const Cell& neighbour) {
-                            handle_cell(neighbour, clusterValue, clusterCells, mark, border, ras);
-                        });
-                    }
-                }
-
-                for (auto& cell : clusterCells) {
-                    result(cell.r, cell.c) = sum;
-                    result.mark_as_data(cell);
-                }
-            }
+    const auto labels = internal::label_clusters(ras, diagonals);
+
+    // accumulate the cluster sizes on the cluster root cells
+    for (size_t i = 0; i < ras.size(); ++i) {
+        if (ras.is_nodata(i)) {
+            result.mark_as_nodata(i);
+        } else if (labels[i] != internal::s_noCluster) {
+            ++result[labels[i]];
         }
     }
+
+    internal::spread_cluster_root_values(labels, result);
     return result;
 }
 
@@ -82,9 +61,6 @@ RasterType<TResult> cluster_sum(const RasterType<TCluster>& ras, const RasterTyp
     show_warning_if_clustering_on_floats(ras);
     throw_on_size_mismatch(ras, valueToSum);
 
-    const auto rows = ras.rows();
-    const auto cols = ras.cols();
-
     int32_t nodata  = -9999;
     auto resultMeta = ras.metadata();
     if (resultMeta.nodata.has_value()) {
@@ -93,58 +69,18 @@ RasterType<TResult> cluster_sum(const RasterType<TCluster>& ras, const RasterTyp
     }
 
     RasterType<TResult> result(resultMeta, TResult(0));
-    RasterType<uint8_t> mark(ras.metadata(), s_markTodo);
-    std::vector<Cell> clusterCells;
-    FiLo<Cell> border(rows, cols);
-    uint32_t clusterCount = 0;
-
-    for (int32_t r = 0; r < rows; ++r) {
-        for (int32_t c = 0; c < cols; ++c) {
-            if (ras.is_nodata(r, c)) {
-                result.mark_as_nodata(r, c);
-                continue;
-            }
-
-            if (ras(r, c) == 0) {
-                result(r, c) = 0;
-            } else if (ras(r, c) > 0 && mark(r, c) == s_markTodo) {
-                ++clusterCount;
-
-                clusterCells.clear();
-                border.clear();
-                const auto clusterValue = ras(r, c);
-
-                // add current cell to the cluster
-                insert_cell(Cell(r, c), clusterCells, mark, border);
-
-                while (!border.empty()) {
-                    auto cell            = border.pop_head();
-                    mark(cell.r, cell.c) = s_markDone;
-
-                    // add the four neighbouring cells if they have the same value
-                    visit_neighbour_cells(cell, rows, cols, [&](const Cell& neighbour) {
-                        handle_cell(neighbour, clusterValue, clusterCells, mark, border, ras);
-                    });
-
-                    if (diagonals == ClusterDiagonals::Include) {
-                        visit_neighbour_diag_cells(cell, rows, cols, [&](const Cell& neighbour) {
-                            handle_cell(neighbour, clusterValue, clusterCells, mark, border, ras);
-                        });
-                    }
-                }
-
-                TResult sum = 0;
-                for (auto& cell : clusterCells) {
-                    sum += static_cast<TResult>(valueToSum[cell]);
-                }
-
-                for (auto& cell : clusterCells) {
-                    result(cell.r, cell.c) = sum;
-                    result.mark_as_data(cell);
-                }
-            }
+    const auto labels = internal::label_clusters(ras, diagonals);
+
+    // accumulate the cluster sums on the cluster root cells
+    for (size_t i = 0; i < ras.size(); ++i) {
+        if (ras.is_nodata(i)) {
+            result.mark_as_nodata(i);
+        } else if (labels[i] != internal::s_noCluster) {
+            result[labels[i]] += static_cast<TResult>(valueToSum[i]);
         }
     }
+
+    internal::spread_cluster_root_values(labels, result);
     return result;
 }
 
@@ -4,86 +4,376 @@
 #include "gdx/exception.h"
 #include "gdx/log.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <deque>
 #include <limits>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace gdx {
 
 static constexpr uint8_t s_markTodo(0);
 static constexpr uint8_t s_markBorder(1);
 static constexpr uint8_t s_markDone(2);
 
+/* Flood fill state of every raster cell (s_markTodo, s_markBorder or s_markDone) packed in 2 bits per cell
+ * A quarter of the memory of a uint8_t raster, so a larger part of the state stays in the cache on large rasters
+ * Indexing returns a proxy so the state can be read and assigned like a raster value.
+ * Not safe for concurrent writes: neighbouring cells share a byte.
+ */
+class MarkGrid
+{
+public:
+    class Reference
+    {
+    public:
+        Reference(MarkGrid& grid, size_t index) noexcept
+        : _grid(grid)
+        , _index(index)
+        {
+        }
+
+        operator uint8_t() const noexcept
+        {
+            return _grid.get(_index);
+        }
+
+        Reference& operator=(uint8_t mark) noexcept
+        {
+            _grid.set(_index, mark);
+            return *this;
+        }
+
+        Reference& operator=(const Reference& other) noexcept
+        {
+            return *this = uint8_t(other);
+        }
+
+    private:
+        MarkGrid& _grid;
+        size_t _index;
+    };
+
+    MarkGrid(int32_t rows, int32_t cols, uint8_t mark)
+    : _cols(cols)
+    , _data((static_cast<size_t>(rows) * static_cast<size_t>(cols) + 3) / 4)
+    {
+        fill(mark);
+    }
+
+    void fill(uint8_t mark) noexcept
+    {
+        assert(mark <= 3);
+        std::fill(_data.begin(), _data.end(), uint8_t(mark * 0x55)); // the mark repeated for the 4 cells in a byte
+    }
+
+    uint8_t get(size_t index) const noexcept
+    {
+        return (_data[index / 4] >> shift(index)) & 3;
+    }
+
+    void set(size_t index, uint8_t mark) noexcept
+    {
+        assert(mark <= 3);
+        auto& byte = _data[index / 4];
+        byte       = uint8_t((byte & ~(3 << shift(index))) | (mark << shift(index)));
+    }
+
+    Reference operator[](size_t index) noexcept
+    {
+        return Reference(*this, index);
+    }
+
+    Reference operator[](const Cell& cell) noexcept
+    {
+        return (*this)(cell.r, cell.c);
+    }
+
+    Reference operator()(int32_t r, int32_t c) noexcept
+    {
+        return Reference(*this, size_t(r) * _cols + c);
+    }
+
+    uint8_t operator[](size_t index) const noexcept
+    {
+        return get(index);
+    }
+
+    uint8_t operator[](const Cell& cell) const noexcept
+    {
+        return (*this)(cell.r, cell.c);
+    }
+
+    uint8_t operator()(int32_t r, int32_t c) const noexcept
+    {
+        return get(size_t(r) * _cols + c);
+    }
+
+private:
+    static int shift(size_t index) noexcept
+    {
+        return int(index % 4) * 2;
+    }
+
+    int32_t _cols;
+    std::vector<uint8_t> _data;
+};
+
 enum class ClusterDiagonals
 {
     Include,
     Exclude
 };
 
+/* First in, first out queue of the frontier cells of the flood fill algorithms
+ * The values are stored in fixed size chunks that are allocated when the frontier grows, the memory use follows the
+ * largest frontier instead of the raster size. Emptied chunks are kept in a pool and reused for the following values,
+ * so a queue that is reused for many flood fills only allocates for the first ones.
+ * Cells are stored as 32 bit linear indexes, which halves the memory compared to storing the row and column.
+ */
 template <typename T>
 class FiLo
 {
 public:
     FiLo(int nRows, int nCols)
-    : head(0)
-    , tail(0)
-    , filo((static_cast<size_t>(nRows) * static_cast<size_t>(nCols)) + 1)
     {
+        reserve_space(nRows, nCols);
     }
 
+    // No memory is reserved upfront anymore, the dimensions are needed to store cells as linear indexes
     void reserve_space(int nRows, int nCols)
     {
-        filo.resize((static_cast<size_t>(nRows) * static_cast<size_t>(nCols)) + 1);
+        if constexpr (s_storeCellIndex) {
+            if (static_cast<uint64_t>(nRows) * static_cast<uint64_t>(nCols) > std::numeric_limits<uint32_t>::max()) {
+                throw RuntimeError("Raster too large for the cell queue ({}x{})", nRows, nCols);
+            }
+        }
+
+        _cols = nCols;
     }
 
     void clear()
     {
-        head = tail = 0;
+        while (!_chunks.empty()) {
+            release_front_chunk();
+        }
+
+        _head = _tail = 0;
+        _size = 0;
     }
 
     int size() const noexcept
     {
-        return (tail + filo.size() - head) % int(filo.size());
+        return int(_size);
     }
 
     bool empty() const noexcept
     {
-        return tail == head;
+        return _size == 0;
     }
 
     void push_back(T value)
     {
-        filo[tail] = value;
-        tail       = (tail + 1) % filo.size();
+        if (_chunks.empty() || _tail == s_chunkSize) {
+            acquire_back_chunk();
+        }
+
+        _chunks.back()[_tail++] = encode(value);
+        ++_size;
+    }
 
-        if (tail == head) {
-            throw RuntimeError("FiLo overflow");
+    T pop_head()
+    {
+        assert(!empty());
+        const auto value = decode(_chunks.front()[_head++]);
+        --_size;
+
+        if (_size == 0) {
+            // keep the chunks in the pool, the next value starts at the beginning of a chunk
+            clear();
+        } else if (_head == s_chunkSize) {
+            release_front_chunk();
+            _head = 0;
         }
+
+        return value;
+    }
+
+    // The memory that is allocated for the values, including the pooled chunks
+    size_t allocated_bytes() const noexcept
+    {
+        return (_chunks.size() + _pool.size()) * s_chunkSize * sizeof(stored_type);
+    }
+
+private:
+    static constexpr bool s_storeCellIndex = std::is_same_v<T, Cell>;
+    static constexpr size_t s_chunkSize    = 16 * 1024;
+
+    using stored_type = std::conditional_t<s_storeCellIndex, uint32_t, T>;
+    using chunk_type  = std::unique_ptr<stored_type[]>;
+
+    stored_type encode(const T& value) const noexcept
+    {
+        if constexpr (s_storeCellIndex) {
+            return static_cast<uint32_t>(value.r) * static_cast<uint32_t>(_cols) + static_cast<uint32_t>(value.c);
+        } else {
+            return value;
+        }
+    }
+
+    T decode(stored_type value) const noexcept
+    {
+        if constexpr (s_storeCellIndex) {
+            return Cell(int32_t(value / uint32_t(_cols)), int32_t(value % uint32_t(_cols)));
+        } else {
+            return value;
+        }
+    }
+
+    void acquire_back_chunk()
+    {
+        if (_pool.empty()) {
+            _chunks.push_back(std::make_unique<stored_type[]>(s_chunkSize));
+        } else {
+            _chunks.push_back(std::move(_pool.back()));
+            _pool.pop_back();
+        }
+
+        _tail = 0;
+    }
+
+    void release_front_chunk()
+    {
+        _pool.push_back(std::move(_chunks.front()));
+        _chunks.pop_front();
+    }
+
+    int _cols    = 0;
+    size_t _head = 0, _tail = 0, _size = 0;
+    std::deque<chunk_type> _chunks;
+    std::vector<chunk_type> _pool;
+};
+
+// Monotone priority queue for non negative float priorities (radix heap)
+// The popped priorities are non decreasing, which is what a dijkstra traversal needs:
+// every cell is finalised the first time it is popped so no cells are processed multiple times.
+// Priorities lower than the last popped priority are processed as if they had the last popped priority.
+template <typename T>
+class RadixHeap
+{
+public:
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    void clear()
+    {
+        for (auto& bucket : _buckets) {
+            bucket.clear();
+        }
+
+        _last = 0;
+        _size = 0;
+    }
+
+    void push(float priority, T value)
+    {
+        if (_size == 0) {
+            // a new traversal can start from lower priorities
+            _last = 0;
+        }
+
+        const auto key = to_key(priority);
+        _buckets[bucket_index(key)].emplace_back(key, value);
+        ++_size;
     }
 
     T pop_head()
     {
         assert(!empty());
-        auto ret = filo[head];
-        head     = (head + 1) % filo.size();
-        return ret;
+
+        if (_buckets[0].empty()) {
+            size_t index = 1;
+            while (_buckets[index].empty()) {
+                ++index;
+            }
+
+            // redistribute the first non empty bucket, all the entries end up in lower buckets
+            auto& bucket = _buckets[index];
+            _last        = bucket.front().first;
+            for (auto& entry : bucket) {
+                _last = std::min(_last, entry.first);
+            }
+
+            for (auto& entry : bucket) {
+                _buckets[bucket_index(entry.first)].push_back(entry);
+            }
+            bucket.clear();
+        }
+
+        auto value = _buckets[0].back().second;
+        _buckets[0].pop_back();
+        --_size;
+        return value;
     }
 
 private:
-    int head, tail;
-    std::vector<T> filo;
+    uint32_t to_key(float priority) const noexcept
+    {
+        if (std::signbit(priority)) {
+            return _last;
+        }
+
+        // the bit representation of positive floats has the same ordering as the float values
+        uint32_t key;
+        std::memcpy(&key, &priority, sizeof(key));
+        return std::max(key, _last);
+    }
+
+    size_t bucket_index(uint32_t key) const noexcept
+    {
+        if (key == _last) {
+            return 0;
+        }
+
+        const uint32_t diff = key ^ _last;
+#ifdef _MSC_VER
+        unsigned long highestBit;
+        _BitScanReverse(&highestBit, diff);
+        return size_t(highestBit) + 1;
+#else
+        return size_t(31 - __builtin_clz(diff)) + 1;
+#endif
+    }
+
+    std::array<std::vector<std::pair<uint32_t, T>>, 33> _buckets;
+    uint32_t _last = 0;
+    size_t _size   = 0;
 };
 
-template <template <typename> typename RasterType>
-inline void insert_cell(const Cell& cell, std::vector<Cell>& clusterCells, RasterType<uint8_t>& mark, FiLo<Cell>& border)
+inline void insert_cell(const Cell& cell, std::vector<Cell>& clusterCells, MarkGrid& mark, FiLo<Cell>& border)
 {
     mark(cell.r, cell.c) = s_markBorder;
     border.push_back(cell);
     clusterCells.push_back(cell);
 }
 
-template <template <typename> typename RasterType>
-inline void insert_cell(const Cell& cell, RasterType<uint8_t>& mark, FiLo<Cell>& border)
+inline void insert_cell(const Cell& cell, MarkGrid& mark, FiLo<Cell>& border)
 {
     mark(cell.r, cell.c) = s_markBorder;
     border.push_back(cell);
@@ -92,7 +382,7 @@ inline void insert_cell(const Cell& cell, RasterType<uint8_t>& mark, FiLo<Cell>&
 template <template <typename> typename RasterType, typename T>
 void handle_cell(const Cell cell,
                  const T clusterValue, std::vector<Cell>& clusterCells,
-                 RasterType<uint8_t>& mark,
+                 MarkGrid& mark,
                  FiLo<Cell>& border, const RasterType<T>& raster)
 {
     if (raster.is_nodata(cell)) {
@@ -109,23 +399,20 @@ namespace internal {
 template <template <typename> typename RasterType, typename T>
 void handle_time_cell(float deltaD, const Cell& cell, const Cell& newCell,
                       RasterType<float>& distanceToTarget,
-                      RasterType<uint8_t>& mark,
+                      MarkGrid& mark,
                       const RasterType<T>& travelTime,
-                      FiLo<Cell>& border)
+                      RadixHeap<Cell>& border)
 {
-    if (distanceToTarget.is_nodata(cell) || distanceToTarget.is_nodata(newCell)) {
+    if (mark[newCell] == s_markDone || distanceToTarget.is_nodata(cell) || distanceToTarget.is_nodata(newCell)) {
         return;
     }
 
     const float alternativeDist = static_cast<float>(distanceToTarget[cell] + deltaD * travelTime[newCell]);
     float& d                    = distanceToTarget[newCell];
     if (d > alternativeDist) {
-        d       = alternativeDist;
-        auto& m = mark[newCell];
-        if (m != s_markBorder) {
-            m = s_markBorder;
-            border.push_back(newCell);
-        }
+        d             = alternativeDist;
+        mark[newCell] = s_markBorder;
+        border.push(alternativeDist, newCell);
     }
 }
 
@@ -183,6 +470,127 @@ void visit_neighbour_diag_cells(Cell cell, int32_t rows, int32_t cols, Callable&
     }
 }
 
+namespace internal {
+
+// Label of the cells that are not part of a cluster
+static constexpr uint32_t s_noCluster = std::numeric_limits<uint32_t>::max();
+
+// Union find root lookup with path halving, parents always have a lower index than their children
+inline uint32_t find_cluster_root(std::vector<uint32_t>& labels, uint32_t index)
+{
+    while (labels[index] != index) {
+        labels[index] = labels[labels[index]];
+        index         = labels[index];
+    }
+
+    return index;
+}
+
+// Merges the clusters of both cells, the cell with the lowest index becomes the root
+inline void merge_clusters(std::vector<uint32_t>& labels, uint32_t index1, uint32_t index2)
+{
+    const auto root1 = find_cluster_root(labels, index1);
+    const auto root2 = find_cluster_root(labels, index2);
+    if (root1 < root2) {
+        labels[root2] = root1;
+    } else if (root2 < root1) {
+        labels[root1] = root2;
+    }
+}
+
+// Merges the cell with its neighbours in the previous row and the previous cell on the same row
+template <template <typename> typename RasterType, typename T>
+void merge_with_previous_neighbours(const RasterType<T>& ras, std::vector<uint32_t>& labels, int32_t r, int32_t c, bool includePreviousRow, ClusterDiagonals diagonals)
+{
+    const auto cols  = ras.cols();
+    const auto index = uint32_t(size_t(r) * cols + c);
+    const auto value = ras[index];
+
+    auto mergeIfConnected = [&](int32_t neighbourRow, int32_t neighbourCol) {
+        const auto neighbourIndex = uint32_t(size_t(neighbourRow) * cols + neighbourCol);
+        if (labels[neighbourIndex] != s_noCluster && ras[neighbourIndex] == value) {
+            merge_clusters(labels, index, neighbourIndex);
+        }
+    };
+
+    if (c > 0) {
+        mergeIfConnected(r, c - 1);
+    }
+
+    if (includePreviousRow) {
+        mergeIfConnected(r - 1, c);
+
+        if (diagonals == ClusterDiagonals::Include) {
+            if (c > 0) {
+                mergeIfConnected(r - 1, c - 1);
+            }
+
+            if (c < cols - 1) {
+                mergeIfConnected(r - 1, c + 1);
+            }
+        }
+    }
+}
+
+/* Connected component labelling of the cells with a value larger than 0, neighbouring cells with the same value form a cluster.
+ * Returns the index of the first cell of its cluster (in row major order) for every cell, or s_noCluster for cells that are not clustered.
+ * The raster is labelled in blocks of rows in parallel, afterwards the clusters that cross the block borders are merged.
+ */
+template <template <typename> typename RasterType, typename T>
+std::vector<uint32_t> label_clusters(const RasterType<T>& ras, ClusterDiagonals diagonals)
+{
+    const auto rows = ras.rows();
+    const auto cols = ras.cols();
+
+    if (ras.size() >= size_t(s_noCluster)) {
+        throw InvalidArgument("Raster is too large for clustering ({}x{})", rows, cols);
+    }
+
+    static constexpr int32_t blockRows = 64;
+    const int32_t blockCount           = (rows + blockRows - 1) / blockRows;
+
+    std::vector<uint32_t> labels(ras.size(), s_noCluster);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int32_t block = 0; block < blockCount; ++block) {
+        const int32_t firstRow = block * blockRows;
+        const int32_t lastRow  = std::min(firstRow + blockRows, rows);
+
+        for (int32_t r = firstRow; r < lastRow; ++r) {
+            for (int32_t c = 0; c < cols; ++c) {
+                const auto index = uint32_t(size_t(r) * cols + c);
+                if (ras.is_nodata(index) || !(ras[index] > 0)) {
+                    continue;
+                }
+
+                labels[index] = index;
+                merge_with_previous_neighbours(ras, labels, r, c, r > firstRow, diagonals);
+            }
+        }
+    }
+
+    // merge the clusters on the block borders
+    for (int32_t block = 1; block < blockCount; ++block) {
+        const int32_t r = block * blockRows;
+        for (int32_t c = 0; c < cols; ++c) {
+            if (labels[size_t(r) * cols + c] != s_noCluster) {
+                merge_with_previous_neighbours(ras, labels, r, c, true, diagonals);
+            }
+        }
+    }
+
+    // the parent of a cell always precedes the cell, so a single pass points every cell to its root
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (labels[i] != s_noCluster) {
+            labels[i] = labels[labels[i]];
+        }
+    }
+
+    return labels;
+}
+
+}
+
 template <typename RasterType>
 void show_warning_if_clustering_on_floats(const RasterType&)
 {
@@ -5,13 +5,19 @@
 #include "gdx/log.h"
 
 #include "gdx/algo/clusterutils.h"
+#include "gdx/algo/distancemethod.h"
+#include "gdx/algo/distancetransform.h"
 #include "gdx/algo/nodata.h"
 #include "infra/chrono.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cmath>
+#include <functional>
 #include <limits>
+#include <mutex>
 #include <vector>
 
 namespace gdx {
@@ -36,7 +42,7 @@ template <template <typename> typename RasterType, typename T>
 void handle_cell_closest_target(float deltaD, const Cell& cell, const Cell& newCell,
                                 RasterType<float>& distanceToTarget,
                                 RasterType<T>& closesttarget,
-                                RasterType<uint8_t>& mark,
+                                MarkGrid& mark,
                                 FiLo<Cell>& border)
 {
     if (distanceToTarget[newCell] > distanceToTarget[cell] + deltaD) {
@@ -49,37 +55,40 @@ void handle_cell_closest_target(float deltaD, const Cell& cell, const Cell& newC
     }
 }
 
-template <template <typename> typename RasterType, typename T>
+template <template <typename> typename RasterType, typename T, typename TDistances, typename TMarks>
 void handle_sum_le_time_distance_cell(float deltaD, const Cell& cell, const Cell& newCell,
-                                      RasterType<float>& distanceToTarget,
-                                      RasterType<uint8_t>& mark,
+                                      TDistances& distanceToTarget,
+                                      TMarks& mark,
                                       const RasterType<T>& travelTime,
-                                      FiLo<Cell>& border,
+                                      RadixHeap<Cell>& border,
                                       std::vector<Cell>& cells)
 {
     if (travelTime.is_nodata(newCell)) {
         return;
     }
+
+    uint8_t& m = mark[newCell];
+    if (m == s_markDone) {
+        return;
+    }
+
     const float alternativeDist = static_cast<float>(distanceToTarget[cell] +
                                                      deltaD / 2.0f * (travelTime[cell] + travelTime[newCell]));
     float& d                    = distanceToTarget[newCell];
     if (d > alternativeDist) {
-        d          = alternativeDist;
-        uint8_t& m = mark[newCell];
-        if (m != s_markBorder) {
-            if (m == s_markTodo) {
-                cells.push_back(newCell);
-            }
-            m = s_markBorder;
-            border.push_back(newCell);
+        d = alternativeDist;
+        if (m == s_markTodo) {
+            cells.push_back(newCell);
         }
+        m = s_markBorder;
+        border.push(alternativeDist, newCell);
     }
 }
 
 template <template <typename> typename RasterType, typename T>
 void handle_cell_value_at_closest_target(float deltaD, const Cell& cell, const Cell& newCell,
                                          RasterType<float>& distanceToTarget,
-                                         RasterType<uint8_t>& mark,
+                                         MarkGrid& mark,
                                          RasterType<T>& valueatclosesttarget,
                                          FiLo<Cell>& border)
 {
@@ -98,24 +107,26 @@ void handle_cell_value_at_closest_travel_target(float deltaD, const Cell& cell,
                                                 RasterType<float>& distanceToTarget,
                                                 RasterType<TValue>& valueatclosesttarget,
                                                 const RasterType<TTravel>& travelTime,
-                                                RasterType<uint8_t>& mark,
-                                                FiLo<Cell>& border)
+                                                MarkGrid& mark,
+                                                RadixHeap<Cell>& border)
 {
+    if (mark[newCell] == s_markDone) {
+        return;
+    }
+
     auto alternativeDist = static_cast<float>(distanceToTarget[cell] + deltaD * travelTime[newCell]);
     if (distanceToTarget[newCell] > alternativeDist) {
         distanceToTarget[newCell]     = alternativeDist;
         valueatclosesttarget[newCell] = valueatclosesttarget[cell];
-        if (mark[newCell] != s_markBorder) {
-            mark[newCell] = s_markBorder;
-            border.push_back(newCell);
-        }
+        mark[newCell]                 = s_markBorder;
+        border.push(alternativeDist, newCell);
     }
 }
 
 template <template <typename> typename RasterType>
 void handle_cell(float deltaD, const Cell& cell, const Cell& newCell,
                  RasterType<float>& distanceToTarget,
-                 RasterType<uint8_t>& mark,
+                 MarkGrid& mark,
                  FiLo<Cell>& border)
 {
     if (distanceToTarget[newCell] > distanceToTarget[cell] + deltaD) {
@@ -130,7 +141,7 @@ void handle_cell(float deltaD, const Cell& cell, const Cell& newCell,
 template <template <typename> typename RasterType>
 void handle_diagonal_cell(float deltaD, const Cell& cell, const Cell& newCell,
                           RasterType<float>& distanceToTarget,
-                          RasterType<uint8_t>& mark,
+                          MarkGrid& mark,
                           FiLo<Cell>& border)
 {
     if (distanceToTarget[newCell] > distanceToTarget[cell] + deltaD) {
@@ -146,7 +157,7 @@ template <template <typename> typename RasterType>
 void handle_cell_with_obstacles(float deltaD, const Cell& cell, const Cell& newCell,
                                 const RasterType<uint8_t>& obstacles,
                                 RasterType<float>& distanceToTarget,
-                                RasterType<uint8_t>& mark,
+                                MarkGrid& mark,
                                 FiLo<Cell>& border)
 {
     if (((!obstacles.is_nodata(newCell)) && obstacles[newCell] == 0) && distanceToTarget[newCell] > distanceToTarget[cell] + deltaD) {
@@ -162,7 +173,7 @@ template <template <typename> typename RasterType>
 void handle_cell_with_obstacles_diag(float deltaD, const Cell& cell, const Cell& newCell,
                                      const RasterType<uint8_t>& obstacles,
                                      RasterType<float>& distanceToTarget,
-                                     RasterType<uint8_t>& mark,
+                                     MarkGrid& mark,
                                      FiLo<Cell>& border)
 {
     if (obstacles.is_nodata(newCell) ||
@@ -181,6 +192,52 @@ void handle_cell_with_obstacles_diag(float deltaD, const Cell& cell, const Cell&
         }
     }
 }
+
+// Scratch buffer that only covers a window of the raster around a center cell
+// Accessed using raster coordinates, the cells outside of the window are not available
+template <typename T>
+class WindowBuffer
+{
+public:
+    WindowBuffer(int32_t rasterRows, int32_t rasterCols, int32_t radius, T fillValue)
+    : _rasterRows(rasterRows)
+    , _rasterCols(rasterCols)
+    , _rows(int32_t(std::min<int64_t>(rasterRows, 2 * int64_t(radius) + 1)))
+    , _cols(int32_t(std::min<int64_t>(rasterCols, 2 * int64_t(radius) + 1)))
+    , _radius(radius)
+    , _data(size_t(_rows) * size_t(_cols), fillValue)
+    {
+    }
+
+    // Move the window to be centered around the cell (or as close as possible on the raster edges)
+    void center_on(const Cell& cell)
+    {
+        _topLeft = Cell(std::clamp(cell.r - _radius, 0, _rasterRows - _rows),
+                        std::clamp(cell.c - _radius, 0, _rasterCols - _cols));
+    }
+
+    T& operator[](const Cell& cell)
+    {
+        return (*this)(cell.r, cell.c);
+    }
+
+    T& operator()(int32_t r, int32_t c)
+    {
+        assert(r >= _topLeft.r && r - _topLeft.r < _rows);
+        assert(c >= _topLeft.c && c - _topLeft.c < _cols);
+        return _data[size_t(r - _topLeft.r) * size_t(_cols) + size_t(c - _topLeft.c)];
+    }
+
+private:
+    int32_t _rasterRows;
+    int32_t _rasterCols;
+    int32_t _rows;
+    int32_t _cols;
+    int32_t _radius;
+    Cell _topLeft;
+    std::vector<T> _data;
+};
+
 }
 
 template <template <typename> typename RasterType>
@@ -192,7 +249,7 @@ RasterType<float> distances_up_to(const RasterType<uint8_t>& target, const float
     auto meta   = target.metadata();
     meta.nodata = RasterType<float>::NaN;
     RasterType<float> distanceToTarget(std::move(meta), unreachable);
-    RasterType<uint8_t> mark(target.rows(), target.cols(), s_markTodo);
+    MarkGrid mark(target.rows(), target.cols(), s_markTodo);
 
     FiLo<Cell> border(rows, cols);
 
@@ -228,10 +285,30 @@ RasterType<float> distances_up_to(const RasterType<uint8_t>& target, const float
 }
 
 template <template <typename> typename RasterType>
-RasterType<float> distance(const RasterType<uint8_t>& target)
+RasterType<float> distance(const RasterType<uint8_t>& target, DistanceMethod method = DistanceMethod::Chamfer)
 {
     const float unreachable = std::numeric_limits<float>::infinity();
-    return distances_up_to(target, unreachable);
+    if (method == DistanceMethod::Chamfer) {
+        return distances_up_to(target, unreachable);
+    }
+
+    auto meta   = target.metadata();
+    meta.nodata = RasterType<float>::NaN;
+    RasterType<float> distanceToTarget(std::move(meta), unreachable);
+
+    std::vector<int64_t> nearestTarget;
+    const auto distance2 = internal::euclidean_distance_transform(target, nearestTarget);
+    const auto cellSize  = target.metadata().cellSize.x;
+
+    for (size_t i = 0; i < target.size(); ++i) {
+        if (target.is_nodata(i)) {
+            distanceToTarget.mark_as_nodata(i);
+        } else if (nearestTarget[i] != internal::s_noNearestTarget) {
+            distanceToTarget[i] = static_cast<float>(std::sqrt(distance2[i]) * cellSize);
+        }
+    }
+
+    return distanceToTarget;
 }
 
 template <template <typename> typename RasterType, typename TTarget, typename TObstacles>
@@ -244,7 +321,7 @@ RasterType<float> distance(const RasterType<TTarget>& target, const RasterType<T
     auto meta   = target.metadata();
     meta.nodata = RasterType<float>::NaN;
     RasterType<float> distanceToTarget(meta, unreachable);
-    RasterType<uint8_t> mark(target.rows(), target.cols(), s_markTodo);
+    MarkGrid mark(target.rows(), target.cols(), s_markTodo);
 
     RasterType<uint8_t> byteTarget(meta.rows, meta.cols, 0);
     RasterType<uint8_t> byteObstacles(meta.rows, meta.cols, 0);
@@ -318,9 +395,9 @@ RasterType<float> travel_distances_up_to(const RasterType<uint8_t>& target, cons
     auto meta   = target.metadata();
     meta.nodata = RasterType<float>::NaN;
     RasterType<float> distanceToTarget(std::move(meta), unreachable);
-    RasterType<uint8_t> mark(target.metadata(), s_markTodo);
+    MarkGrid mark(target.rows(), target.cols(), s_markTodo);
 
-    FiLo<Cell> border(rows, cols);
+    RadixHeap<Cell> border;
 
     for (int32_t r = 0; r < rows; ++r) {
         for (int32_t c = 0; c < cols; ++c) {
@@ -329,7 +406,7 @@ RasterType<float> travel_distances_up_to(const RasterType<uint8_t>& target, cons
             } else if (target(r, c) != 0) {
                 distanceToTarget(r, c) = 0;
                 mark(r, c)             = s_markBorder;
-                border.push_back(Cell(r, c));
+                border.push(0.f, Cell(r, c));
             }
         }
     }
@@ -337,7 +414,10 @@ RasterType<float> travel_distances_up_to(const RasterType<uint8_t>& target, cons
     const float sqrt2 = std::sqrt(2.f);
     while (!border.empty()) {
         auto cell = border.pop_head();
-        assert(mark[cell] == s_markBorder);
+        if (mark[cell] == s_markDone) {
+            // outdated queue entry, the cell was already reached via a shorter path
+            continue;
+        }
         mark[cell] = s_markDone;
 
         visit_neighbour_cells(cell, rows, cols, [&](const Cell& neighbour) {
@@ -360,7 +440,7 @@ RasterType<float> travel_distance(const RasterType<uint8_t>& target, const Raste
 }
 
 template <template <typename> typename RasterType, typename T>
-RasterType<T> closest_target(const RasterType<T>& target)
+RasterType<T> closest_target(const RasterType<T>& target, DistanceMethod method = DistanceMethod::Chamfer)
 {
     const auto rows         = target.rows();
     const auto cols         = target.cols();
@@ -368,9 +448,23 @@ RasterType<T> closest_target(const RasterType<T>& target)
 
     auto meta = target.metadata();
     meta.nodata.reset();
+
+    if (method == DistanceMethod::Euclidean) {
+        RasterType<T> closestTarget(meta, 0);
+
+        const auto nearestTarget = internal::nearest_target_transform(target);
+        for (size_t i = 0; i < target.size(); ++i) {
+            if (nearestTarget[i] != internal::s_noNearestTarget) {
+                closestTarget[i] = target[nearestTarget[i]];
+            }
+        }
+
+        return closestTarget;
+    }
+
     RasterType<float> distanceToTarget(meta, unreachable);
     RasterType<T> closestTarget(meta, 0);
-    RasterType<uint8_t> mark(meta, s_markTodo);
+    MarkGrid mark(meta.rows, meta.cols, s_markTodo);
 
     FiLo<Cell> border(rows, cols);
 
@@ -406,12 +500,29 @@ RasterType<T> closest_target(const RasterType<T>& target)
 }
 
 template <template <typename> typename RasterType, typename TValue, typename TTarget>
-RasterType<TValue> value_at_closest_target(const RasterType<TTarget>& target, const RasterType<TValue>& value)
+RasterType<TValue> value_at_closest_target(const RasterType<TTarget>& target, const RasterType<TValue>& value, DistanceMethod method = DistanceMethod::Chamfer)
 {
     if (target.size() != value.size()) {
         throw InvalidArgument("Target raster dimensions should match value raster dimensions");
     }
 
+    if (method == DistanceMethod::Euclidean) {
+        RasterType<TValue> valueAtClosestTarget(value.metadata(), 0);
+
+        const auto nearestTarget = internal::nearest_target_transform(target);
+        for (size_t i = 0; i < target.size(); ++i) {
+            if (const auto nearest = nearestTarget[i]; nearest != internal::s_noNearestTarget) {
+                if (value.is_nodata(nearest)) {
+                    valueAtClosestTarget.mark_as_nodata(i);
+                } else {
+                    valueAtClosestTarget[i] = value[nearest];
+                }
+            }
+        }
+
+        return valueAtClosestTarget;
+    }
+
     const auto rows         = target.rows();
     const auto cols         = target.cols();
     const float unreachable = static_cast<float>(rows * cols + 1);
@@ -419,7 +530,7 @@ RasterType<TValue> value_at_closest_target(const RasterType<TTarget>& target, co
     RasterType<TValue> valueAtClosestTarget(value.metadata(), 0);
     RasterType<float> distanceToTarget(value.metadata(), unreachable);
 
-    RasterType<uint8_t> mark(target.metadata(), s_markTodo);
+    MarkGrid mark(target.rows(), target.cols(), s_markTodo);
     FiLo<Cell> border(rows, cols);
 
     for (int r = 0; r < rows; ++r) {
@@ -475,8 +586,8 @@ RasterType<TValue> value_at_closest_travel_target(const RasterType<TTarget>& tar
     RasterType<TValue> valueAtClosestTarget(value.metadata(), 0);
     RasterType<float> distanceToTarget(value.metadata(), unreachable);
 
-    RasterType<uint8_t> mark(target.metadata(), s_markTodo);
-    FiLo<Cell> border(rows, cols);
+    MarkGrid mark(target.rows(), target.cols(), s_markTodo);
+    RadixHeap<Cell> border;
 
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
@@ -487,7 +598,7 @@ RasterType<TValue> value_at_closest_travel_target(const RasterType<TTarget>& tar
                 distanceToTarget(r, c)     = 0;
                 valueAtClosestTarget(r, c) = value(r, c);
                 mark(r, c)                 = s_markBorder;
-                border.push_back(Cell(r, c));
+                border.push(0.f, Cell(r, c));
             }
         }
     }
@@ -495,7 +606,9 @@ RasterType<TValue> value_at_closest_travel_target(const RasterType<TTarget>& tar
     const float sqrt2 = std::sqrt(2.f);
     while (!border.empty()) {
         auto cell = border.pop_head();
-        assert(mark[cell] == s_markBorder);
+        if (mark[cell] == s_markDone) {
+            continue;
+        }
         mark[cell] = s_markDone;
 
         visit_neighbour_cells(cell, rows, cols, [&](const Cell& neighbour) {
@@ -524,8 +637,8 @@ RasterType<TValue> value_at_closest_less_then_travel_target(const RasterType<TTa
     RasterType<TValue> valueAtClosestTarget(value.metadata(), 0);
     RasterType<float> distanceToTarget(value.metadata(), unreachable);
 
-    RasterType<uint8_t> mark(target.metadata(), s_markTodo);
-    FiLo<Cell> border(rows, cols);
+    MarkGrid mark(target.rows(), target.cols(), s_markTodo);
+    RadixHeap<Cell> border;
 
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
@@ -536,7 +649,7 @@ RasterType<TValue> value_at_closest_less_then_travel_target(const RasterType<TTa
                 distanceToTarget(r, c)     = 0;
                 valueAtClosestTarget(r, c) = value(r, c);
                 mark(r, c)                 = s_markBorder;
-                border.push_back(Cell(r, c));
+                border.push(0.f, Cell(r, c));
             }
         }
     }
@@ -544,7 +657,9 @@ RasterType<TValue> value_at_closest_less_then_travel_target(const RasterType<TTa
     const float sqrt2 = std::sqrt(2.f);
     while (!border.empty()) {
         auto cell = border.pop_head();
-        assert(mark[cell] == s_markBorder);
+        if (mark[cell] == s_markDone) {
+            continue;
+        }
         mark[cell] = s_markDone;
 
         visit_neighbour_cells(cell, rows, cols, [&](const Cell& neighbour) {
@@ -560,7 +675,8 @@ RasterType<TValue> value_at_closest_less_then_travel_target(const RasterType<TTa
 }
 
 // computes the sum of the valueToSum that is within the distance via lowest travelTime
-template <template <typename> typename RasterType, typename TTravel, typename TValue>
+// the distance and mark buffers can be rasters or window buffers that cover the cells reachable from the target cell
+template <template <typename> typename RasterType, typename TTravel, typename TValue, typename TDistances, typename TMarks>
 TValue compute_sum_le_time_distance(Cell targetCell,
                                     const RasterType<TTravel>& travelTime,
                                     const float maxTravelTime,
@@ -568,9 +684,9 @@ TValue compute_sum_le_time_distance(Cell targetCell,
                                     const RasterType<TValue>& valueToSum,
                                     bool inclAdjacent,
                                     // temporary variables internal to compute_sum_le_time_distance.  Pass them again and again instead of having to recreate them again and again.
-                                    RasterType<float>& distanceToTarget, // expected to be all unreachable.  This function restores any changes upon return.
-                                    RasterType<uint8_t>& mark,           // expected to be all s_markTodo.  This function restores any changes upon return.
-                                    FiLo<Cell>& border,                  // expected to be empty.  Restored to empty upon return.
+                                    TDistances& distanceToTarget,        // expected to be all unreachable.  This function restores any changes upon return.
+                                    TMarks& mark,                        // expected to be all s_markTodo.  This function restores any changes upon return.
+                                    RadixHeap<Cell>& border,             // expected to be empty.  Restored to empty upon return.
                                     std::vector<Cell>& cells,            // idem
                                     std::vector<Cell>& adjacentCells     // idem
 )
@@ -583,13 +699,13 @@ TValue compute_sum_le_time_distance(Cell targetCell,
 
     TValue sum = 0;
 
-    const auto rows = mark.rows();
-    const auto cols = mark.cols();
+    const auto rows = travelTime.rows();
+    const auto cols = travelTime.cols();
 
     Cell cell              = targetCell;
     distanceToTarget[cell] = 0;
     if (!travelTime.is_nodata(cell)) {
-        border.push_back(cell);
+        border.push(0.f, cell);
         mark[cell] = s_markBorder;
     } else {
         mark[cell] = s_markDone;
@@ -599,7 +715,9 @@ TValue compute_sum_le_time_distance(Cell targetCell,
     const float sqrt2 = std::sqrt(2.f);
     while (!border.empty()) {
         auto curCell = border.pop_head();
-        assert(mark[curCell] == s_markBorder);
+        if (mark[curCell] == s_markDone) {
+            continue;
+        }
         mark[curCell] = s_markDone;
 
         visit_neighbour_cells(curCell, rows, cols, [&](const Cell& neighbour) {
@@ -657,12 +775,20 @@ TValue compute_sum_le_time_distance(Cell targetCell,
     return sum;
 }
 
+// Progress callback for the long running travel distance algorithms
+// Receives the progress [0.0-1.0], return false to cancel the operation
+using TravelDistanceProgressCallback = std::function<bool(float)>;
+
+// The sums are calculated in parallel, every thread uses scratch buffers that only cover the window
+// around the target cell that can be reached within the maximum resistance
+// When the progress callback requests cancellation a RuntimeError is thrown
 template <typename TResult, template <typename> typename RasterType, typename TMask, typename TResistence, typename TValue>
 RasterType<TResult> sum_within_travel_distance(const RasterType<TMask>& mask,
                                                const RasterType<TResistence>& resistenceMap,
                                                const RasterType<TValue>& valueMap,
                                                float maxResistance,
-                                               bool includeAdjacent)
+                                               bool includeAdjacent,
+                                               const TravelDistanceProgressCallback& progressCb = nullptr)
 {
     if (mask.size() != resistenceMap.size() || mask.size() != valueMap.size()) {
         throw InvalidArgument("Mask, resistence and value map dimensions should be the same");
@@ -670,9 +796,15 @@ RasterType<TResult> sum_within_travel_distance(const RasterType<TMask>& mask,
     if (maxResistance <= 0) {
         throw InvalidArgument("maxResistance should be postive");
     }
+
+    auto minResistance = std::numeric_limits<float>::max();
     for (int i = 0; i < int(resistenceMap.size()); ++i) {
-        if (!resistenceMap.is_nodata(i) && resistenceMap[i] < 0) {
-            throw InvalidArgument("resistance may not be negative");
+        if (!resistenceMap.is_nodata(i)) {
+            if (resistenceMap[i] < 0) {
+                throw InvalidArgument("resistance may not be negative");
+            }
+
+            minResistance = std::min(minResistance, static_cast<float>(resistenceMap[i]));
         }
     }
 
@@ -688,42 +820,77 @@ RasterType<TResult> sum_within_travel_distance(const RasterType<TMask>& mask,
 
     const float unreachable = std::nextafter(maxResistance, std::numeric_limits<float>::max());
 
-    // temporary variables internal to compute_sum_le_time_distance.  Pass them again and again instead of having to recreate them again and again.
-    RasterType<float> distanceToTarget(mask.metadata(), unreachable);
-    RasterType<uint8_t> mark(mask.metadata(), s_markTodo);
-    FiLo<Cell> border(rows, cols);
-    std::vector<Cell> cells;
-    std::vector<Cell> adjacentCells;
+    // every step to a neighbouring cell costs at least minResistance, which limits the reachable window
+    // one extra cell for the neighbour checks and one as margin for rounding errors
+    int32_t windowRadius = std::max(rows, cols);
+    if (minResistance > 0 && maxResistance / minResistance < float(windowRadius)) {
+        windowRadius = std::min(windowRadius, int32_t(std::ceil(maxResistance / minResistance)) + 2);
+    }
 
     using namespace std::chrono_literals;
     auto t00     = std::chrono::steady_clock::now();
     auto lastMsg = t00;
 
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            if (!mask.is_nodata(r, c) && mask(r, c) != 0) {
-                result(r, c) = static_cast<TResult>(compute_sum_le_time_distance(Cell(r, c), resistenceMap, maxResistance,
-                                                                                 unreachable, valueMap, includeAdjacent, distanceToTarget, mark, border, cells, adjacentCells));
+    std::mutex progressMutex;
+    std::atomic<bool> cancelled = false;
+    int32_t processedRows       = 0;
+
+#pragma omp parallel
+    {
+        // temporary variables internal to compute_sum_le_time_distance.  Pass them again and again instead of having to recreate them again and again.
+        internal::WindowBuffer<float> distanceToTarget(rows, cols, windowRadius, unreachable);
+        internal::WindowBuffer<uint8_t> mark(rows, cols, windowRadius, s_markTodo);
+        RadixHeap<Cell> border;
+        std::vector<Cell> cells;
+        std::vector<Cell> adjacentCells;
+
+#pragma omp for schedule(dynamic)
+        for (int r = 0; r < rows; ++r) {
+            if (cancelled) {
+                continue;
+            }
+
+            for (int c = 0; c < cols; ++c) {
+                if (!mask.is_nodata(r, c) && mask(r, c) != 0) {
+                    const Cell cell(r, c);
+                    distanceToTarget.center_on(cell);
+                    mark.center_on(cell);
+                    result[cell] = static_cast<TResult>(compute_sum_le_time_distance(cell, resistenceMap, maxResistance,
+                                                                                    unreachable, valueMap, includeAdjacent, distanceToTarget, mark, border, cells, adjacentCells));
+                }
+            }
+
+            std::scoped_lock lock(progressMutex);
+            ++processedRows;
+            if (progressCb) {
+                if (!progressCb(float(processedRows) / rows)) {
+                    cancelled = true;
+                }
+                continue;
             }
-        }
 
-        auto now = std::chrono::steady_clock::now();
-        if ((now - lastMsg) > 3s) {
-            auto elapsed = now - t00;
-            auto total   = elapsed * static_cast<double>(rows) / (r + 1);
-
-            lastMsg = now;
-            Log::warn("sum_within_travel_distance processed {:.2f}%, elapsed {:02}:{:02}:{:02}, expected total runtime {:02}:{:02}:{:02}",
-                      100.0 * (r + 1) / rows,
-                      std::chrono::duration_cast<std::chrono::hours>(elapsed).count(),
-                      std::chrono::duration_cast<std::chrono::minutes>(elapsed).count() % 60,
-                      std::chrono::duration_cast<std::chrono::seconds>(elapsed).count() % 60,
-                      std::chrono::duration_cast<std::chrono::hours>(total).count(),
-                      std::chrono::duration_cast<std::chrono::minutes>(total).count() % 60,
-                      std::chrono::duration_cast<std::chrono::seconds>(total).count() % 60);
+            auto now = std::chrono::steady_clock::now();
+            if ((now - lastMsg) > 3s) {
+                auto elapsed = now - t00;
+                auto total   = elapsed * static_cast<double>(rows) / processedRows;
+
+                lastMsg = now;
+                Log::warn("sum_within_travel_distance processed {:.2f}%, elapsed {:02}:{:02}:{:02}, expected total runtime {:02}:{:02}:{:02}",
+                          100.0 * processedRows / rows,
+                          std::chrono::duration_cast<std::chrono::hours>(elapsed).count(),
+                          std::chrono::duration_cast<std::chrono::minutes>(elapsed).count() % 60,
+                          std::chrono::duration_cast<std::chrono::seconds>(elapsed).count() % 60,
+                          std::chrono::duration_cast<std::chrono::hours>(total).count(),
+                          std::chrono::duration_cast<std::chrono::minutes>(total).count() % 60,
+                          std::chrono::duration_cast<std::chrono::seconds>(total).count() % 60);
+            }
         }
     }
 
+    if (cancelled) {
+        throw RuntimeError("sum_within_travel_distance was cancelled");
+    }
+
     return result;
 }
 
@@ -762,9 +929,8 @@ RasterType<TResult> sum_targets_within_travel_distance(const RasterType<TTarget>
 
     resultMeta.nodata.reset();
     RasterType<float> distanceToTarget(resultMeta, unreachable);
-    RasterType<uint8_t> mark(resultMeta, s_markTodo);
-    RasterType<uint8_t> added(resultMeta, 0);
-    FiLo<Cell> border(rows, cols);
+    MarkGrid mark(resultMeta.rows, resultMeta.cols, s_markTodo);
+    RadixHeap<Cell> border;
 
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
@@ -774,13 +940,12 @@ RasterType<TResult> sum_targets_within_travel_distance(const RasterType<TTarget>
 
             distanceToTarget.fill(unreachable);
             mark.fill(s_markTodo);
-            added.fill(0);
             assert(border.empty());
 
             Cell cell(r, c);
             distanceToTarget[cell] = 0;
             if (!resistanceMap.is_nodata(cell)) {
-                border.push_back(cell);
+                border.push(0.f, cell);
                 mark[cell] = s_markBorder;
             } else {
                 mark[cell] = s_markDone;
@@ -788,14 +953,14 @@ RasterType<TResult> sum_targets_within_travel_distance(const RasterType<TTarget>
 
             while (!border.empty()) {
                 auto curCell = border.pop_head();
-                assert(mark[curCell] == s_markBorder);
+                if (mark[curCell] == s_markDone) {
+                    continue;
+                }
+
+                // every cell is finalised only once, so it is only counted once
                 mark[curCell] = s_markDone;
                 if (distanceToTarget[curCell] <= maxResistance) {
-                    // we can get here via different routes within the maxTravelTime.  But count only once.
-                    if (added[curCell] == 0) {
-                        result[curCell] += static_cast<TResult>(targets[cell]);
-                        added[curCell] = 1;
-                    }
+                    result[curCell] += static_cast<TResult>(targets[cell]);
                 }
 
                 visit_neighbour_cells(curCell, rows, cols, [&](const Cell& neighbour) {
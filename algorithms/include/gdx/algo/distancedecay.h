@@ -34,11 +34,11 @@ RasterType<float> node_value_distance_decay(const RasterType<TTarget>& target, c
     constexpr auto nan = std::numeric_limits<float>::quiet_NaN();
     RasterType<float> result(copy_metadata_replace_nodata(target.metadata(), nan), 0);
 
-    FiLo<Cell> border(rows, cols);
+    RadixHeap<Cell> border;
     const float sqrt2       = std::sqrt(2.f);
     const float unreachable = static_cast<float>(maxTravelTime) + 1.f;
     RasterType<float> distanceToTarget(copy_metadata_replace_nodata(result.metadata(), {}));
-    RasterType<uint8_t> mark(copy_metadata_replace_nodata(result.metadata(), {}));
+    MarkGrid mark(rows, cols, s_markTodo);
 
     for (int32_t r = 0; r < rows; ++r) {
         for (int32_t c = 0; c < cols; ++c) {
@@ -52,13 +52,15 @@ RasterType<float> node_value_distance_decay(const RasterType<TTarget>& target, c
             assert(border.empty());
 
             Cell cell(r, c);
-            border.push_back(cell);
+            border.push(0.f, cell);
             distanceToTarget[cell] = 0;
             mark[cell]             = s_markBorder;
 
             while (!border.empty()) {
                 cell = border.pop_head();
-                assert(mark[cell] == s_markBorder);
+                if (mark[cell] == s_markDone) {
+                    continue;
+                }
                 mark[cell] = s_markDone;
                 if (distanceToTarget[cell] <= maxTravelTime) {
                     const float d = distanceToTarget[cell];
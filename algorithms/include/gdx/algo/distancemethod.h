@@ -0,0 +1,11 @@
+#pragma once
+
+namespace gdx {
+
+enum class DistanceMethod
+{
+    Chamfer,   // Horizontal, vertical and diagonal steps around the nodata cells of the target
+    Euclidean, // Exact euclidean distance, nodata cells of the target do not block the path
+};
+
+}
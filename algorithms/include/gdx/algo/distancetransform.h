@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace gdx::internal {
+
+// Nearest target index of the cells when there are no targets
+static constexpr int64_t s_noNearestTarget = -1;
+
+/* Exact euclidean distance transform (Felzenszwalb and Huttenlocher)
+ * The transform is separable: a pass over the columns computes the nearest target row within the column of every cell,
+ * a pass over the rows computes the lower envelope of the parabolas of those column distances.
+ * Both passes are processed in parallel, the columns in blocks so the memory is accessed row by row.
+ *
+ * targetPriority(index) returns a negative value for cells that are not a target, for targets it returns the priority:
+ * when targets are at the same distance the target with the lowest priority is the nearest target.
+ * The index of the nearest target is stored in nearestTarget, the squared distance in cells is stored in distance2
+ * when it is not null (callers that only need the nearest target do not pay for the distances).
+ */
+template <typename TargetPriority>
+void euclidean_distance_transform(int32_t rows, int32_t cols, TargetPriority&& targetPriority, std::vector<int64_t>& nearestTarget, std::vector<double>* distance2)
+{
+    const auto size = size_t(rows) * size_t(cols);
+
+    // nearest target row in the column, -1 if the column has no target
+    std::vector<int32_t> nearestRow(size, -1);
+
+    const int32_t columnBlockSize  = 256;
+    const int32_t columnBlockCount = (cols + columnBlockSize - 1) / columnBlockSize;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int32_t block = 0; block < columnBlockCount; ++block) {
+        const int32_t c0 = block * columnBlockSize;
+        const int32_t c1 = std::min(cols, c0 + columnBlockSize);
+
+        std::vector<int32_t> targetRow(c1 - c0, -1);
+        for (int32_t r = 0; r < rows; ++r) {
+            for (int32_t c = c0; c < c1; ++c) {
+                const auto index = size_t(r) * cols + c;
+                if (targetPriority(index) >= 0) {
+                    targetRow[c - c0] = r;
+                }
+                nearestRow[index] = targetRow[c - c0];
+            }
+        }
+
+        std::fill(targetRow.begin(), targetRow.end(), -1);
+        for (int32_t r = rows - 1; r >= 0; --r) {
+            for (int32_t c = c0; c < c1; ++c) {
+                const auto index = size_t(r) * cols + c;
+                if (targetPriority(index) >= 0) {
+                    targetRow[c - c0] = r;
+                }
+
+                const auto below = targetRow[c - c0];
+                const auto above = nearestRow[index];
+                if (below < 0 || below == above) {
+                    continue;
+                }
+
+                if (above < 0 || below - r < r - above ||
+                    (below - r == r - above && targetPriority(size_t(below) * cols + c) < targetPriority(size_t(above) * cols + c))) {
+                    nearestRow[index] = below;
+                }
+            }
+        }
+    }
+
+    const double inf = std::numeric_limits<double>::infinity();
+    nearestTarget.assign(size, s_noNearestTarget);
+    if (distance2) {
+        distance2->assign(size, inf);
+    }
+
+#pragma omp parallel
+    {
+        std::vector<double> columnDistance2(cols);
+        std::vector<int64_t> columnTarget(cols);
+        std::vector<int32_t> vertices(cols);      // the columns of the parabolas in the lower envelope
+        std::vector<double> boundaries(cols + 1); // the envelope of parabola k covers [boundaries[k], boundaries[k + 1]]
+
+#pragma omp for schedule(dynamic)
+        for (int32_t r = 0; r < rows; ++r) {
+            const size_t rowOffset = size_t(r) * cols;
+
+            int32_t k = -1;
+            for (int32_t q = 0; q < cols; ++q) {
+                const auto row = nearestRow[rowOffset + q];
+                if (row < 0) {
+                    continue;
+                }
+
+                columnDistance2[q] = double(row - r) * double(row - r);
+                columnTarget[q]    = int64_t(row) * cols + q;
+
+                // parabolas that are only minimal in a single point are kept, other targets can be at the same distance there
+                double boundary = -inf;
+                while (k >= 0) {
+                    const auto v = vertices[k];
+                    boundary     = ((columnDistance2[q] + double(q) * q) - (columnDistance2[v] + double(v) * v)) / (2.0 * (q - v));
+                    if (boundary >= boundaries[k]) {
+                        break;
+                    }
+                    --k;
+                }
+
+                ++k;
+                vertices[k]       = q;
+                boundaries[k]     = k == 0 ? -inf : boundary;
+                boundaries[k + 1] = inf;
+            }
+
+            if (k < 0) {
+                // no targets in the raster
+                continue;
+            }
+
+            const auto envelopeSize = k + 1;
+
+            k = 0;
+            for (int32_t q = 0; q < cols; ++q) {
+                while (boundaries[k + 1] < q) {
+                    ++k;
+                }
+
+                // the following parabolas that start at this column are at the same distance
+                auto nearest = k;
+                for (int32_t i = k + 1; i < envelopeSize && boundaries[i] <= q; ++i) {
+                    if (targetPriority(size_t(columnTarget[vertices[i]])) < targetPriority(size_t(columnTarget[vertices[nearest]]))) {
+                        nearest = i;
+                    }
+                }
+
+                const auto v                 = vertices[nearest];
+                nearestTarget[rowOffset + q] = columnTarget[v];
+                if (distance2) {
+                    (*distance2)[rowOffset + q] = double(q - v) * double(q - v) + columnDistance2[v];
+                }
+            }
+        }
+    }
+}
+
+// Returns the squared distance in cells, the index of the nearest target is stored in nearestTarget
+template <typename TargetPriority>
+std::vector<double> euclidean_distance_transform(int32_t rows, int32_t cols, TargetPriority&& targetPriority, std::vector<int64_t>& nearestTarget)
+{
+    std::vector<double> distance2;
+    euclidean_distance_transform(rows, cols, std::forward<TargetPriority>(targetPriority), nearestTarget, &distance2);
+    return distance2;
+}
+
+// The cells with a non zero value are the targets, nodata cells are not a target
+template <template <typename> typename RasterType, typename T>
+auto raster_target_priority(const RasterType<T>& target)
+{
+    return [&target](size_t index) {
+        return (!target.is_nodata(index) && target[index] != 0) ? int64_t(index) : int64_t(-1);
+    };
+}
+
+// Euclidean distance transform to the cells with a non zero value, nodata cells are not a target
+template <template <typename> typename RasterType, typename T>
+std::vector<double> euclidean_distance_transform(const RasterType<T>& target, std::vector<int64_t>& nearestTarget)
+{
+    return euclidean_distance_transform(target.rows(), target.cols(), raster_target_priority(target), nearestTarget);
+}
+
+// The index of the nearest cell with a non zero value, without computing the distances
+template <template <typename> typename RasterType, typename T>
+std::vector<int64_t> nearest_target_transform(const RasterType<T>& target)
+{
+    std::vector<int64_t> nearestTarget;
+    euclidean_distance_transform(target.rows(), target.cols(), raster_target_priority(target), nearestTarget, nullptr);
+    return nearestTarget;
+}
+
+}
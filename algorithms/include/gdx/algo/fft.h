@@ -0,0 +1,126 @@
+#pragma once
+
+#include "gdx/exception.h"
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+namespace gdx::detail {
+
+/* Two dimensional radix-2 fast fourier transform of a square block of size x size values
+ * The twiddle factors and the bit reversal permutation are computed once so the instance can be reused for many blocks
+ * The transform methods are const, so one instance can be shared between threads that operate on their own buffers
+ */
+class Fft2D
+{
+public:
+    explicit Fft2D(int32_t size)
+    : _size(size)
+    , _bitReversed(size)
+    , _twiddles(size / 2)
+    {
+        if (size <= 0 || (size & (size - 1)) != 0) {
+            throw InvalidArgument("Fft size should be a power of two ({})", size);
+        }
+
+        int32_t bits = 0;
+        while ((1 << bits) < size) {
+            ++bits;
+        }
+
+        for (int32_t i = 0; i < size; ++i) {
+            int32_t reversed = 0;
+            for (int32_t b = 0; b < bits; ++b) {
+                if (i & (1 << b)) {
+                    reversed |= 1 << (bits - 1 - b);
+                }
+            }
+            _bitReversed[i] = reversed;
+        }
+
+        const double pi = std::acos(-1.0);
+        for (int32_t i = 0; i < size / 2; ++i) {
+            _twiddles[i] = std::polar(1.0, -2.0 * pi * i / size);
+        }
+    }
+
+    int32_t size() const noexcept
+    {
+        return _size;
+    }
+
+    // Forward transform of the row major size x size block
+    void forward(std::vector<std::complex<double>>& data) const
+    {
+        transform_2d(data, false);
+    }
+
+    // Inverse transform of the row major size x size block, the result is scaled by 1 / (size * size)
+    void inverse(std::vector<std::complex<double>>& data) const
+    {
+        transform_2d(data, true);
+
+        const double scale = 1.0 / (double(_size) * double(_size));
+        for (auto& value : data) {
+            value *= scale;
+        }
+    }
+
+private:
+    void transform_2d(std::vector<std::complex<double>>& data, bool inverse) const
+    {
+        std::vector<std::complex<double>> column(_size);
+
+        for (int32_t r = 0; r < _size; ++r) {
+            transform_1d(&data[size_t(r) * _size], inverse);
+        }
+
+        for (int32_t c = 0; c < _size; ++c) {
+            for (int32_t r = 0; r < _size; ++r) {
+                column[r] = data[size_t(r) * _size + c];
+            }
+
+            transform_1d(column.data(), inverse);
+
+            for (int32_t r = 0; r < _size; ++r) {
+                data[size_t(r) * _size + c] = column[r];
+            }
+        }
+    }
+
+    void transform_1d(std::complex<double>* data, bool inverse) const
+    {
+        for (int32_t i = 0; i < _size; ++i) {
+            if (i < _bitReversed[i]) {
+                std::swap(data[i], data[_bitReversed[i]]);
+            }
+        }
+
+        for (int32_t length = 2; length <= _size; length *= 2) {
+            const int32_t half        = length / 2;
+            const int32_t twiddleStep = _size / length;
+            for (int32_t start = 0; start < _size; start += length) {
+                for (int32_t k = 0; k < half; ++k) {
+                    auto twiddle = _twiddles[k * twiddleStep];
+                    if (inverse) {
+                        twiddle = std::conj(twiddle);
+                    }
+
+                    const auto even = data[start + k];
+                    const auto odd  = data[start + k + half] * twiddle;
+
+                    data[start + k]        = even + odd;
+                    data[start + k + half] = even - odd;
+                }
+            }
+        }
+    }
+
+    int32_t _size;
+    std::vector<int32_t> _bitReversed;
+    std::vector<std::complex<double>> _twiddles;
+};
+
+}
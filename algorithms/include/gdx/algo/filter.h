@@ -1,10 +1,17 @@
 #pragma once
 
 #include "gdx/algo/algorithm.h"
+#include "gdx/algo/fft.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstdint>
 #include <functional>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 namespace gdx {
 
@@ -16,122 +23,322 @@ enum class FilterMode
     Exponential2
 };
 
-template <typename RasterType>
-static void increment_or_assign(RasterType& ras, int row, int col, double value)
+namespace detail {
+
+// From this radius on the non constant filter kernels are applied using fft convolution instead of the direct weighted sum
+static constexpr int s_fftFilterRadius = 6;
+
+inline double filter_weight(FilterMode mode, int radiusInCells, double dSqr)
+{
+    switch (mode) {
+    case FilterMode::Exponential2:
+        return dSqr > 0 ? 1.0 / dSqr : 1.0;
+    case FilterMode::Exponential:
+        return dSqr > 0 ? 1.0 / std::sqrt(dSqr) : 1.0;
+    case FilterMode::Linear:
+        return 1.0 - std::sqrt(dSqr) / (radiusInCells + 1);
+    case FilterMode::Constant:
+        break;
+    }
+
+    return 1.0;
+}
+
+// The weights of the circular filter kernel, computed once per radius and mode
+struct FilterKernel
+{
+    FilterKernel(FilterMode kernelMode, int radiusInCells)
+    : mode(kernelMode)
+    , radius(std::max(radiusInCells, 0))
+    , size(2 * radius + 1)
+    , halfWidths(size, 0)
+    , weights(size_t(size) * size, 0.0)
+    , rowPrefixSums(size_t(size) * (size + 1), 0.0)
+    {
+        const int radiusSqr = radius * radius;
+        for (int dr = -radius; dr <= radius; ++dr) {
+            int& halfWidth = halfWidths[dr + radius];
+            while (dr * dr + (halfWidth + 1) * (halfWidth + 1) <= radiusSqr) {
+                ++halfWidth;
+            }
+
+            for (int dc = -halfWidth; dc <= halfWidth; ++dc) {
+                weights[size_t(dr + radius) * size + dc + radius] = filter_weight(mode, radius, double(dr * dr + dc * dc));
+            }
+
+            double* prefix = &rowPrefixSums[size_t(dr + radius) * (size + 1)];
+            for (int i = 0; i < size; ++i) {
+                prefix[i + 1] = prefix[i] + weights[size_t(dr + radius) * size + i];
+            }
+
+            weightSum += prefix[size];
+        }
+    }
+
+    // Pointer to the weight of the kernel center column on the kernel row of dr, valid for dc in [-halfWidth, halfWidth]
+    const double* row_center(int dr) const noexcept
+    {
+        return &weights[size_t(dr + radius) * size + radius];
+    }
+
+    // Sum of the kernel weights that fall within the raster when the kernel is centered on the cell
+    // Only the cells within the radius of the raster border have a clipped kernel
+    double clipped_weight_sum(int32_t r, int32_t c, int32_t rows, int32_t cols) const noexcept
+    {
+        if (r >= radius && c >= radius && r + radius < rows && c + radius < cols) {
+            return weightSum;
+        }
+
+        double sum = 0.0;
+        for (int dr = std::max(-radius, -r); dr <= std::min(radius, rows - 1 - r); ++dr) {
+            const int halfWidth = halfWidths[dr + radius];
+            const int dc0       = std::max(-halfWidth, -c);
+            const int dc1       = std::min(halfWidth, cols - 1 - c);
+            if (dc0 <= dc1) {
+                const double* prefix = &rowPrefixSums[size_t(dr + radius) * (size + 1)];
+                sum += prefix[dc1 + radius + 1] - prefix[dc0 + radius];
+            }
+        }
+
+        return sum;
+    }
+
+    FilterMode mode;
+    int radius;
+    int size;
+    std::vector<int> halfWidths; // per kernel row: the columns [-halfWidth, halfWidth] are within the radius
+    std::vector<double> weights;       // size x size, 0 outside of the radius
+    std::vector<double> rowPrefixSums; // size x (size + 1), prefix sums of the weights per kernel row
+    double weightSum = 0.0;
+};
+
+// Weighted sum of the values within the kernel for every cell, cost per cell is proportional to the kernel area
+inline std::vector<double> filter_direct(const std::vector<double>& values, int32_t rows, int32_t cols, const FilterKernel& kernel)
+{
+    std::vector<double> result(values.size(), 0.0);
+    const int radius = kernel.radius;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int32_t r = 0; r < rows; ++r) {
+        for (int32_t c = 0; c < cols; ++c) {
+            double sum = 0.0;
+            for (int dr = std::max(-radius, -r); dr <= std::min(radius, rows - 1 - r); ++dr) {
+                const int halfWidth = kernel.halfWidths[dr + radius];
+                const int dc0       = std::max(-halfWidth, -c);
+                const int dc1       = std::min(halfWidth, cols - 1 - c);
+
+                const double* weights = kernel.row_center(dr);
+                const double* rowData = &values[size_t(r + dr) * cols + c];
+                for (int dc = dc0; dc <= dc1; ++dc) {
+                    sum += weights[dc] * rowData[dc];
+                }
+            }
+
+            result[size_t(r) * cols + c] = sum;
+        }
+    }
+
+    return result;
+}
+
+// Sum of the values within the radius for every cell (constant kernel)
+// Uses the row prefix sums so the cost per cell is proportional to the radius instead of the kernel area
+// The sums are computed as TSum, so cell counts do not need double buffers
+template <typename TSum = double, typename T>
+std::vector<TSum> filter_constant(const std::vector<T>& values, int32_t rows, int32_t cols, const FilterKernel& kernel)
+{
+    const size_t prefixCols = size_t(cols) + 1;
+    std::vector<TSum> prefixSums(size_t(rows) * prefixCols, TSum(0));
+
+#pragma omp parallel for
+    for (int32_t r = 0; r < rows; ++r) {
+        TSum* prefix = &prefixSums[size_t(r) * prefixCols];
+        for (int32_t c = 0; c < cols; ++c) {
+            prefix[c + 1] = prefix[c] + TSum(values[size_t(r) * cols + c]);
+        }
+    }
+
+    std::vector<TSum> result(values.size(), TSum(0));
+    const int radius = kernel.radius;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int32_t r = 0; r < rows; ++r) {
+        for (int32_t c = 0; c < cols; ++c) {
+            TSum sum = 0;
+            for (int dr = std::max(-radius, -r); dr <= std::min(radius, rows - 1 - r); ++dr) {
+                const int halfWidth = kernel.halfWidths[dr + radius];
+                const TSum* prefix  = &prefixSums[size_t(r + dr) * prefixCols];
+                sum += prefix[std::min(c + halfWidth, cols - 1) + 1] - prefix[std::max(c - halfWidth, 0)];
+            }
+
+            result[size_t(r) * cols + c] = sum;
+        }
+    }
+
+    return result;
+}
+
+// Weighted sum of the values within the kernel for every cell using tiled fft convolution (overlap-save)
+// The cost per cell is proportional to log(radius) instead of the kernel area
+inline std::vector<double> filter_fft(const std::vector<double>& values, int32_t rows, int32_t cols, const FilterKernel& kernel)
 {
-    using TOutput = typename RasterType::value_type;
+    const int radius = kernel.radius;
 
-    if (ras.is_nodata(row, col)) {
-        ras.mark_as_data(row, col);
-        ras(row, col) = static_cast<TOutput>(value);
-    } else {
-        ras(row, col) += static_cast<TOutput>(value);
+    int32_t fftSize = 64;
+    while (fftSize < 2 * kernel.size) {
+        fftSize *= 2;
     }
+
+    // every fft block produces a tile of output cells, the remaining block cells are the kernel overlap
+    const int32_t tileSize = fftSize - 2 * radius;
+    const Fft2D fft(fftSize);
+
+    // the kernel is symmetric, so it can be stored circularly around the block origin
+    std::vector<std::complex<double>> kernelSpectrum(size_t(fftSize) * fftSize);
+    for (int dr = -radius; dr <= radius; ++dr) {
+        const int halfWidth = kernel.halfWidths[dr + radius];
+        for (int dc = -halfWidth; dc <= halfWidth; ++dc) {
+            kernelSpectrum[size_t((dr + fftSize) % fftSize) * fftSize + (dc + fftSize) % fftSize] = kernel.row_center(dr)[dc];
+        }
+    }
+    fft.forward(kernelSpectrum);
+
+    const int32_t tileRows  = (rows + tileSize - 1) / tileSize;
+    const int32_t tileCols  = (cols + tileSize - 1) / tileSize;
+    const int32_t tileCount = tileRows * tileCols;
+
+    std::vector<double> result(values.size(), 0.0);
+
+#pragma omp parallel
+    {
+        std::vector<std::complex<double>> block(size_t(fftSize) * fftSize);
+
+#pragma omp for schedule(dynamic)
+        for (int32_t tile = 0; tile < tileCount; ++tile) {
+            // the block contains the tile and the cells within the radius around it
+            const int32_t blockRow = (tile / tileCols) * tileSize - radius;
+            const int32_t blockCol = (tile % tileCols) * tileSize - radius;
+
+            bool hasValues = false;
+            std::fill(block.begin(), block.end(), std::complex<double>());
+            for (int32_t br = std::max(0, -blockRow); br < std::min(fftSize, rows - blockRow); ++br) {
+                for (int32_t bc = std::max(0, -blockCol); bc < std::min(fftSize, cols - blockCol); ++bc) {
+                    const double value = values[size_t(blockRow + br) * cols + blockCol + bc];
+                    if (value != 0.0) {
+                        block[size_t(br) * fftSize + bc] = value;
+                        hasValues                        = true;
+                    }
+                }
+            }
+
+            if (!hasValues) {
+                continue;
+            }
+
+            fft.forward(block);
+            for (size_t i = 0; i < block.size(); ++i) {
+                block[i] *= kernelSpectrum[i];
+            }
+            fft.inverse(block);
+
+            for (int32_t tr = 0; tr < tileSize && blockRow + radius + tr < rows; ++tr) {
+                for (int32_t tc = 0; tc < tileSize && blockCol + radius + tc < cols; ++tc) {
+                    result[size_t(blockRow + radius + tr) * cols + blockCol + radius + tc] = block[size_t(tr + radius) * fftSize + tc + radius].real();
+                }
+            }
+        }
+    }
+
+    return result;
 }
 
+// Applies the kernel using the cheapest implementation for the kernel mode and radius
+inline std::vector<double> apply_filter_kernel(const std::vector<double>& values, int32_t rows, int32_t cols, const FilterKernel& kernel)
+{
+    if (kernel.mode == FilterMode::Constant) {
+        return filter_constant(values, rows, cols, kernel);
+    } else if (kernel.radius >= s_fftFilterRadius) {
+        return filter_fft(values, rows, cols, kernel);
+    }
+
+    return filter_direct(values, rows, cols, kernel);
+}
+
+}
+
+/* Every input cell spreads its value over the cells within the radius, weighted by the filter mode
+ * When normalize is true the spread values of each input cell are divided by the sum of the weights within the raster
+ * so the sum of the raster is preserved.
+ * Cells without input data within the radius are nodata.
+ * The spread values are summed as double, integral outputs truncate the total of the cell (not every spread value).
+ * The kernel is symmetric, so the spreading is computed as a gather over the kernel. The implementation is selected
+ * based on the mode and radius: row prefix sums for the constant kernel, fft convolution for large radii
+ * and a direct weighted sum otherwise.
+ */
 template <typename OutputRasterType, typename InputRasterType>
 OutputRasterType filter(const InputRasterType& input, FilterMode mode, int radiusInCells, bool normalize)
 {
     OutputRasterType result(input.metadata());
     using TResult = typename OutputRasterType::value_type;
-    if (result.metadata().nodata.has_value()) {
-        result.fill_with_nodata();
-    }
 
-    const auto numRows      = input.rows();
-    const auto numCols      = input.cols();
-    const double radius_sqr = radiusInCells * radiusInCells;
+    const auto rows = input.rows();
+    const auto cols = input.cols();
+    const auto size = size_t(rows) * size_t(cols);
 
-    for (int i = 0; i < numRows; ++i) {
-        for (int j = 0; j < numCols; ++j) {
-            if (input.is_nodata(i, j)) {
-                continue;
+    const detail::FilterKernel kernel(mode, radiusInCells);
+    const bool hasNodata = result.metadata().nodata.has_value();
+
+    // the data cells are only needed to find the output cells without input data within the radius
+    std::vector<double> values(size, 0.0);
+    std::vector<uint8_t> dataCells(hasNodata ? size : 0, 0);
+    for (int32_t r = 0; r < rows; ++r) {
+        for (int32_t c = 0; c < cols; ++c) {
+            if (!input.is_nodata(r, c)) {
+                values[size_t(r) * cols + c] = static_cast<double>(input(r, c));
+                if (hasNodata) {
+                    dataCells[size_t(r) * cols + c] = 1;
+                }
+            }
+        }
+    }
+
+    if (normalize) {
+        // the kernel weight sums are clipped to the raster bounds, independent of the nodata cells
+#pragma omp parallel for
+        for (int32_t r = 0; r < rows; ++r) {
+            for (int32_t c = 0; c < cols; ++c) {
+                values[size_t(r) * cols + c] /= kernel.clipped_weight_sum(r, c, rows, cols);
             }
+        }
+    }
 
-            auto value = input(i, j);
-
-            int row = i;
-            int col = j;
-            int r0  = std::max(0, row - radiusInCells);
-            int r1  = std::min(row + radiusInCells, numRows - 1);
-            int c0  = std::max(0, col - radiusInCells);
-            int c1  = std::min(col + radiusInCells, numCols - 1);
-
-            double sum_area = 0;
-            for (int r = r0; r <= r1; ++r) {
-                const int dr     = (r - row);
-                const int dr_sqr = dr * dr;
-                for (int c = c0; c <= c1; ++c) {
-                    const int dc     = (c - col);
-                    const int dc_sqr = dc * dc;
-
-                    double factor = 0.0;
-
-                    const double d_sqr = dr_sqr + dc_sqr;
-                    if (d_sqr <= radius_sqr) {
-                        if (mode == FilterMode::Exponential2) {
-                            if (d_sqr > 0) {
-                                factor = (1.0 / d_sqr);
-                            } else {
-                                factor = 1.0;
-                            }
-                        } else if (mode == FilterMode::Exponential) {
-                            if (d_sqr > 0) {
-                                factor = (1.0 / std::sqrt(d_sqr));
-                            } else {
-                                factor = 1.0;
-                            }
-                        } else if (mode == FilterMode::Linear) {
-                            factor = 1.0 - std::sqrt(d_sqr) / (radiusInCells + 1);
-                        } else {
-                            assert(mode == FilterMode::Constant);
-                            factor = 1.0;
-                        }
-                    }
+    const auto sums = detail::apply_filter_kernel(values, rows, cols, kernel);
+    values          = std::vector<double>();
 
-                    if (factor > 0) {
-                        if (normalize) {
-                            sum_area += factor;
-                        } else {
-                            increment_or_assign(result, r, c, value * factor);
-                        }
-                    }
-                }
+    std::vector<int32_t> dataCounts;
+    if (hasNodata) {
+        dataCounts = detail::filter_constant<int32_t>(dataCells, rows, cols, kernel);
+        dataCells  = std::vector<uint8_t>();
+        result.fill_with_nodata();
+    }
+
+    for (int32_t r = 0; r < rows; ++r) {
+        for (int32_t c = 0; c < cols; ++c) {
+            const auto index = size_t(r) * cols + c;
+            if (hasNodata && dataCounts[index] == 0) {
+                continue;
             }
 
-            if (normalize) {
-                for (int r = r0; r <= r1; ++r) {
-                    const int dr     = (r - row);
-                    const int dr_sqr = dr * dr;
-                    for (int c = c0; c <= c1; ++c) {
-                        const int dc     = (c - col);
-                        const int dc_sqr = dc * dc;
-
-                        const int d_sqr = dr_sqr + dc_sqr;
-                        if (d_sqr <= radius_sqr) {
-                            if (mode == FilterMode::Exponential2) {
-                                if (d_sqr > 0) {
-                                    increment_or_assign(result, r, c, (value * (1.0 / d_sqr)) / sum_area);
-                                } else {
-                                    increment_or_assign(result, r, c, value / sum_area);
-                                }
-                            } else if (mode == FilterMode::Exponential) {
-                                if (d_sqr > 0) {
-                                    increment_or_assign(result, r, c, (value * (1.0 / std::sqrt(static_cast<double>(d_sqr)))) / sum_area);
-                                } else {
-                                    result(r, c) += static_cast<TResult>((value * (1.0)) / sum_area);
-                                    increment_or_assign(result, r, c, value / sum_area);
-                                }
-                            } else if (mode == FilterMode::Linear) {
-                                increment_or_assign(result, r, c, (value * (1.0 - std::sqrt(static_cast<double>(d_sqr)) / (radiusInCells + 1))) / sum_area);
-                            } else {
-                                assert(mode == FilterMode::Constant);
-                                increment_or_assign(result, r, c, value / sum_area);
-                            }
-                        }
-                    }
+            double sum = sums[index];
+            if constexpr (std::is_integral_v<TResult>) {
+                // the fft convolution has a tiny rounding error, which should not truncate an integral sum to the integer below
+                if (const double rounded = std::round(sum); std::abs(sum - rounded) < 1e-9 * std::max(1.0, std::abs(sum))) {
+                    sum = rounded;
                 }
             }
+
+            result.mark_as_data(r, c);
+            result(r, c) = static_cast<TResult>(sum);
         }
     }
 
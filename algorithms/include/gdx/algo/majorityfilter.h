@@ -2,10 +2,13 @@
 
 #include "gdx/algo/suminbuffer.h"
 
+#include <algorithm>
 #include <functional>
 #include <map>
 #include <set>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace gdx {
 
@@ -54,6 +57,138 @@ std::optional<T> compute_majority(const Cell cell, const RasterType<T>& oldValue
     return result;
 }
 
+namespace internal {
+
+// Integral rasters with a value range up to this size use the value offset as category index
+static constexpr int64_t s_majorityFlatCategoryRange = 1 << 16;
+
+// Maps the raster values to category indexes, the order of the category indexes matches the order of the values
+template <template <typename> typename RasterType, typename T>
+std::vector<T> index_majority_categories(const RasterType<T>& ras, std::vector<int32_t>& cellCategories)
+{
+    cellCategories.assign(ras.size(), -1);
+
+    std::vector<T> categories;
+    if constexpr (std::is_integral_v<T>) {
+        std::optional<T> minValue, maxValue;
+        for (size_t i = 0; i < ras.size(); ++i) {
+            if (!ras.is_nodata(i)) {
+                minValue = minValue.has_value() ? std::min(*minValue, ras[i]) : ras[i];
+                maxValue = maxValue.has_value() ? std::max(*maxValue, ras[i]) : ras[i];
+            }
+        }
+
+        if (!minValue.has_value()) {
+            return categories;
+        }
+
+        if (double(*maxValue) - double(*minValue) < double(s_majorityFlatCategoryRange)) {
+            const int64_t range = int64_t(*maxValue) - int64_t(*minValue) + 1;
+            // small category domain: flat lookup on the value offset
+            categories.resize(size_t(range));
+            for (int64_t i = 0; i < range; ++i) {
+                categories[size_t(i)] = static_cast<T>(int64_t(*minValue) + i);
+            }
+
+            for (size_t i = 0; i < ras.size(); ++i) {
+                if (!ras.is_nodata(i)) {
+                    cellCategories[i] = static_cast<int32_t>(int64_t(ras[i]) - int64_t(*minValue));
+                }
+            }
+
+            return categories;
+        }
+    }
+
+    for (size_t i = 0; i < ras.size(); ++i) {
+        if (!ras.is_nodata(i)) {
+            categories.push_back(ras[i]);
+        }
+    }
+
+    std::sort(categories.begin(), categories.end());
+    categories.erase(std::unique(categories.begin(), categories.end()), categories.end());
+
+    for (size_t i = 0; i < ras.size(); ++i) {
+        if (!ras.is_nodata(i)) {
+            cellCategories[i] = static_cast<int32_t>(std::lower_bound(categories.begin(), categories.end(), ras[i]) - categories.begin());
+        }
+    }
+
+    return categories;
+}
+
+// Category counts of the cells in the moving window
+// Keeps track of the categories that are present so finding the majority does not need to visit all the categories
+class MajorityHistogram
+{
+public:
+    explicit MajorityHistogram(size_t categoryCount)
+    : _counts(categoryCount, 0)
+    , _activePosition(categoryCount, 0)
+    {
+    }
+
+    void add(int32_t category)
+    {
+        if (_counts[category]++ == 0) {
+            _activePosition[category] = int32_t(_active.size());
+            _active.push_back(category);
+        }
+    }
+
+    void remove(int32_t category)
+    {
+        assert(_counts[category] > 0);
+        if (--_counts[category] == 0) {
+            const auto last                    = _active.back();
+            _active[_activePosition[category]] = last;
+            _activePosition[last]              = _activePosition[category];
+            _active.pop_back();
+        }
+    }
+
+    void clear()
+    {
+        for (auto category : _active) {
+            _counts[category] = 0;
+        }
+        _active.clear();
+    }
+
+    // Same rules as compute_majority: the present category wins in case of equal counts, otherwise the lowest category
+    // returns -1 if the window only contains nodata
+    int32_t majority(int32_t presentCategory) const
+    {
+        int32_t result   = -1;
+        int32_t maxCount = 0;
+        for (auto category : _active) {
+            const auto count = _counts[category];
+            if (count > maxCount || (count == maxCount && category < result)) {
+                maxCount = count;
+                result   = category;
+            }
+        }
+
+        if (presentCategory >= 0 && _counts[presentCategory] == maxCount) {
+            result = presentCategory;
+        }
+
+        return result;
+    }
+
+private:
+    std::vector<int32_t> _counts;
+    std::vector<int32_t> _activePosition;
+    std::vector<int32_t> _active;
+};
+
+}
+
+/* Every cell gets the value that occurs the most within the radius
+ * The window slides along the rows, when moving one cell only the cells on the left and right border
+ * of the circle are removed and added, the rows are processed in parallel.
+ */
 template <template <typename> typename RasterType, typename T>
 RasterType<T> majority_filter(const RasterType<T>& ras, float radiusInMeter)
 {
@@ -69,12 +204,75 @@ RasterType<T> majority_filter(const RasterType<T>& ras, float radiusInMeter)
     const auto radiusInCells2 = static_cast<int32_t>(radiusInCellsFloat * radiusInCellsFloat);
     RasterType<T> result(resultMeta);
 
-    std::map<T, int32_t> count;
+    if (radiusInCells < 0) {
+        throw InvalidArgument("Majority filter radius should not be negative");
+    }
+
+    // the columns within the radius on every row of the circle are [-halfWidth, halfWidth]
+    std::vector<int32_t> halfWidths(2 * radiusInCells + 1, 0);
+    for (int32_t dr = -radiusInCells; dr <= radiusInCells; ++dr) {
+        auto& halfWidth = halfWidths[dr + radiusInCells];
+        while (halfWidth < radiusInCells && dr * dr + (halfWidth + 1) * (halfWidth + 1) <= radiusInCells2) {
+            ++halfWidth;
+        }
+    }
+
+    std::vector<int32_t> cellCategories;
+    const auto categories = internal::index_majority_categories(ras, cellCategories);
+
+    std::vector<int32_t> majorities(ras.size(), -1);
+
+#pragma omp parallel
+    {
+        internal::MajorityHistogram histogram(categories.size());
+
+#pragma omp for schedule(dynamic)
+        for (int32_t r = 0; r < rows; ++r) {
+            const int32_t dr0 = std::max(-radiusInCells, -r);
+            const int32_t dr1 = std::min(radiusInCells, rows - 1 - r);
+
+            auto visitCell = [&](int32_t rr, int32_t cc, bool add) {
+                if (cc < 0 || cc >= cols) {
+                    return;
+                }
+
+                if (const auto category = cellCategories[size_t(rr) * cols + cc]; category >= 0) {
+                    if (add) {
+                        histogram.add(category);
+                    } else {
+                        histogram.remove(category);
+                    }
+                }
+            };
+
+            histogram.clear();
+            for (int32_t dr = dr0; dr <= dr1; ++dr) {
+                const auto halfWidth = halfWidths[dr + radiusInCells];
+                for (int32_t dc = -halfWidth; dc <= halfWidth; ++dc) {
+                    visitCell(r + dr, dc, true);
+                }
+            }
+
+            for (int32_t c = 0; c < cols; ++c) {
+                if (c > 0) {
+                    // slide the window one cell to the right
+                    for (int32_t dr = dr0; dr <= dr1; ++dr) {
+                        const auto halfWidth = halfWidths[dr + radiusInCells];
+                        visitCell(r + dr, c - halfWidth - 1, false);
+                        visitCell(r + dr, c + halfWidth, true);
+                    }
+                }
+
+                const auto index  = size_t(r) * cols + c;
+                majorities[index] = histogram.majority(cellCategories[index]);
+            }
+        }
+    }
+
     for (int32_t r = 0; r < rows; ++r) {
         for (int32_t c = 0; c < cols; ++c) {
-            auto majority = compute_majority(Cell(r, c), ras, radiusInCells, radiusInCells2, resultMeta, count);
-            if (majority.has_value()) {
-                result(r, c) = majority.value();
+            if (const auto majority = majorities[size_t(r) * cols + c]; majority >= 0) {
+                result(r, c) = categories[majority];
             } else {
                 result.mark_as_nodata(r, c);
             }
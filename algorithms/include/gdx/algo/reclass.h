@@ -5,7 +5,14 @@
 #include "infra/filesystem.h"
 #include "infra/string.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
 #include <variant>
+#include <vector>
 
 namespace gdx {
 
@@ -69,63 +76,288 @@ void throw_on_mapping_issue(const MappingData<float>& mapping, std::optional<dou
     }
 }
 
-template <typename T, int ElementCount>
-std::optional<T> reclass_value(const std::array<std::optional<T>, ElementCount>& values, const MappingData<T>& mapping, bool& warningGiven)
+// Key value in the mapping tables that matches nodata raster values
+static constexpr int32_t s_reclassNodataKey = -9999;
+
+// Maximum number of entries of the dense reclass lookup table, larger key domains use the hash table
+static constexpr int64_t s_reclassDenseLookupSize = 1 << 20;
+
+// Number of cells that are looked up as one parallel chunk
+static constexpr std::size_t s_reclassChunkSize = 1 << 16;
+
+/* Index of the mapping table rows on their key values, built once per reclass invocation
+ * Integral keys with a small value domain use a dense lookup table on the key offsets,
+ * other keys are stored in an open addressing hash table on the packed key values.
+ * A nodata raster value matches the mapping key -9999, if several rows have the same keys the first row is used.
+ */
+template <typename T, int KeyCount>
+class ReclassIndex
 {
-    auto iter = std::find_if(mapping.begin(), mapping.end(), [&](const std::vector<T>& mappingValues) {
-        for (std::size_t i = 0; i < values.size(); ++i) {
-            if (values[i].has_value()) {
-                if (values[i] != static_cast<T>(mappingValues[i])) {
-                    return false;
+public:
+    using Key = std::array<T, KeyCount>;
+
+    explicit ReclassIndex(const MappingData<T>& mapping)
+    {
+        for (auto& mappingValues : mapping) {
+            if (mappingValues.size() <= std::size_t(KeyCount)) {
+                throw InvalidArgument("Reclass mapping rows should contain {} values", KeyCount + 1);
+            }
+        }
+
+        if constexpr (std::is_integral_v<T>) {
+            if (build_dense_lookup(mapping)) {
+                return;
+            }
+        }
+
+        build_hash_table(mapping);
+    }
+
+    static Key make_key(const std::array<std::optional<T>, KeyCount>& values) noexcept
+    {
+        Key key;
+        for (int i = 0; i < KeyCount; ++i) {
+            key[i] = values[i].value_or(static_cast<T>(s_reclassNodataKey));
+        }
+
+        return key;
+    }
+
+    // Index of the first mapping row with the given keys, -1 if the mapping has no such row
+    int32_t find(const Key& key) const noexcept
+    {
+        if (!_denseRows.empty()) {
+            std::size_t offset = 0;
+            for (int i = 0; i < KeyCount; ++i) {
+                int64_t keyOffset = _keyRange[i];
+                if (key[i] != static_cast<T>(s_reclassNodataKey)) {
+                    keyOffset = int64_t(key[i]) - int64_t(_minKey[i]);
+                    if (keyOffset < 0 || keyOffset >= _keyRange[i]) {
+                        return -1;
+                    }
                 }
-            } else if (mappingValues[i] != -9999) { // mapping table key equals NODATA
+
+                offset = offset * std::size_t(_keyRange[i] + 1) + std::size_t(keyOffset);
+            }
+
+            return _denseRows[offset];
+        }
+
+        for (auto slot = hash(key) & _hashMask;; slot = (slot + 1) & _hashMask) {
+            if (_hashRows[slot] < 0 || _hashKeys[slot] == key) {
+                return _hashRows[slot];
+            }
+        }
+    }
+
+private:
+    // Every key column gets the range of its mapping keys and one extra entry for the nodata key
+    bool build_dense_lookup(const MappingData<T>& mapping)
+    {
+        _minKey.fill(std::numeric_limits<T>::max());
+        std::array<T, KeyCount> maxKey;
+        maxKey.fill(std::numeric_limits<T>::lowest());
+
+        for (auto& mappingValues : mapping) {
+            for (int i = 0; i < KeyCount; ++i) {
+                if (mappingValues[i] != static_cast<T>(s_reclassNodataKey)) {
+                    _minKey[i] = std::min(_minKey[i], mappingValues[i]);
+                    maxKey[i]  = std::max(maxKey[i], mappingValues[i]);
+                }
+            }
+        }
+
+        int64_t lookupSize = 1;
+        for (int i = 0; i < KeyCount; ++i) {
+            _keyRange[i] = _minKey[i] <= maxKey[i] ? int64_t(maxKey[i]) - int64_t(_minKey[i]) + 1 : 0;
+            lookupSize *= _keyRange[i] + 1;
+            if (lookupSize > s_reclassDenseLookupSize) {
                 return false;
             }
         }
 
+        _denseRows.assign(std::size_t(lookupSize), -1);
+        for (std::size_t row = 0; row < mapping.size(); ++row) {
+            Key key;
+            std::copy_n(mapping[row].begin(), KeyCount, key.begin());
+
+            std::size_t offset = 0;
+            for (int i = 0; i < KeyCount; ++i) {
+                const auto keyOffset = key[i] == static_cast<T>(s_reclassNodataKey) ? _keyRange[i] : int64_t(key[i]) - int64_t(_minKey[i]);
+                offset               = offset * std::size_t(_keyRange[i] + 1) + std::size_t(keyOffset);
+            }
+
+            if (_denseRows[offset] < 0) {
+                _denseRows[offset] = int32_t(row);
+            }
+        }
+
         return true;
-    });
+    }
 
-    if (iter == mapping.end()) {
-        if (!warningGiven) {
-            Log::warn("No mapping available for raster values: {}", values_to_string<T, ElementCount>(values));
-            warningGiven = true;
+    void build_hash_table(const MappingData<T>& mapping)
+    {
+        std::size_t capacity = 16;
+        while (capacity < mapping.size() * 2) {
+            capacity *= 2;
         }
 
-        return std::optional<T>();
+        _hashMask = capacity - 1;
+        _hashKeys.resize(capacity);
+        _hashRows.assign(capacity, -1);
+
+        for (std::size_t row = 0; row < mapping.size(); ++row) {
+            Key key;
+            std::copy_n(mapping[row].begin(), KeyCount, key.begin());
+            if (std::any_of(key.begin(), key.end(), [](T value) { return value != value; })) {
+                // nan keys never match a raster value
+                continue;
+            }
+
+            auto slot = hash(key) & _hashMask;
+            while (_hashRows[slot] >= 0 && _hashKeys[slot] != key) {
+                slot = (slot + 1) & _hashMask;
+            }
+
+            if (_hashRows[slot] < 0) {
+                _hashKeys[slot] = key;
+                _hashRows[slot] = int32_t(row);
+            }
+        }
     }
 
-    auto result = iter->at(values.size());
-    if (result == -9999) { // mapping table key lookup result is NODATA
-        return std::optional<T>();
+    static std::size_t hash(const Key& key) noexcept
+    {
+        uint64_t hash = 0;
+        for (auto value : key) {
+            // adding 0 turns -0.0 into 0.0, they compare equal so they need the same hash
+            const auto normalized = value + T(0);
+
+            uint64_t bits = 0;
+            std::memcpy(&bits, &normalized, sizeof(T));
+            hash = (hash ^ bits) * 0x9E3779B97F4A7C15ull;
+        }
+
+        return std::size_t(hash ^ (hash >> 32));
     }
 
-    return static_cast<T>(result);
-}
-}
+    std::array<T, KeyCount> _minKey = {};
+    std::array<int64_t, KeyCount> _keyRange = {};
+    std::vector<int32_t> _denseRows;
 
-template <typename ResultType, template <typename> typename RasterType, typename MappingType, typename T>
-auto reclass_to(const MappingData<MappingType>& mapping, const RasterType<T>& ras)
+    std::vector<Key> _hashKeys;
+    std::vector<int32_t> _hashRows;
+    std::size_t _hashMask = 0;
+};
+
+/* Looks up the mapping row of every cell in parallel chunks, the results are stored in the result raster afterwards
+ * valuesAt(i) returns the key values of cell i, cells without mapping row or with a -9999 mapping result become nodata
+ */
+template <int KeyCount, typename MappingType, typename ResultRaster, typename ValuesAt>
+void reclass_cells(const MappingData<MappingType>& mapping, ResultRaster& result, typename ResultRaster::value_type nodata, ValuesAt&& valuesAt)
 {
-    RasterType<ResultType> result(ras.metadata());
-    ResultType nodata = static_cast<ResultType>(result.has_nan() ? RasterType<ResultType>::NaN : -9999.0);
-    result.set_nodata(nodata);
+    const ReclassIndex<MappingType, KeyCount> index(mapping);
+
+    const auto size       = result.size();
+    const auto chunkCount = (size + s_reclassChunkSize - 1) / s_reclassChunkSize;
+    std::vector<int32_t> rows(size);
+
+#pragma omp parallel for schedule(static)
+    for (int64_t chunk = 0; chunk < int64_t(chunkCount); ++chunk) {
+        const auto end = std::min(size, std::size_t(chunk + 1) * s_reclassChunkSize);
+        for (auto i = std::size_t(chunk) * s_reclassChunkSize; i < end; ++i) {
+            rows[i] = index.find(ReclassIndex<MappingType, KeyCount>::make_key(valuesAt(i)));
+        }
+    }
 
-    const auto size   = ras.size();
     bool warningGiven = false;
 
     for (std::size_t i = 0; i < size; ++i) {
-        std::array<std::optional<MappingType>, 1> values = {{ras.template optional_value_as<MappingType>(i)}};
+        std::optional<MappingType> value;
+        if (rows[i] >= 0) {
+            if (auto mapped = mapping[rows[i]][KeyCount]; mapped != static_cast<MappingType>(s_reclassNodataKey)) { // mapping table key lookup result is NODATA
+                value = mapped;
+            }
+        } else if (!warningGiven) {
+            Log::warn("No mapping available for raster values: {}", values_to_string<MappingType, KeyCount>(valuesAt(i)));
+            warningGiven = true;
+        }
 
-        auto v = internal::reclass_value<MappingType, 1>(values, mapping, warningGiven);
-        if (v) {
-            result[i] = static_cast<ResultType>(*v);
+        if (value) {
+            result[i] = static_cast<typename ResultRaster::value_type>(*value);
             result.mark_as_data(i);
         } else {
             result[i] = nodata;
             result.mark_as_nodata(i);
         }
     }
+}
+
+/* Index of the nreclass mapping rows, the rows map the keys within the interval (low, high]
+ * The interval bounds split the key domain in segments that match the same rows,
+ * the first matching row of every segment is stored so a lookup is a binary search of the bounds.
+ */
+template <typename T>
+class NReclassIndex
+{
+public:
+    explicit NReclassIndex(const MappingData<float>& mapping)
+    {
+        for (auto& mappingValues : mapping) {
+            _bounds.push_back(T(mappingValues[0]));
+            _bounds.push_back(T(mappingValues[1]));
+        }
+
+        _bounds.erase(std::remove_if(_bounds.begin(), _bounds.end(), [](T value) { return value != value; }), _bounds.end());
+        std::sort(_bounds.begin(), _bounds.end());
+        _bounds.erase(std::unique(_bounds.begin(), _bounds.end()), _bounds.end());
+
+        // segment i contains the keys in (_bounds[i - 1], _bounds[i]]
+        _segmentRows.assign(_bounds.size(), -1);
+        for (std::size_t row = 0; row < mapping.size(); ++row) {
+            const auto low  = T(mapping[row][0]);
+            const auto high = T(mapping[row][1]);
+            if (!(low < high)) {
+                continue;
+            }
+
+            const auto first = std::lower_bound(_bounds.begin(), _bounds.end(), low) - _bounds.begin() + 1;
+            const auto last  = std::lower_bound(_bounds.begin(), _bounds.end(), high) - _bounds.begin();
+            for (auto segment = first; segment <= last; ++segment) {
+                if (_segmentRows[segment] < 0) {
+                    _segmentRows[segment] = int32_t(row);
+                }
+            }
+        }
+    }
+
+    // Index of the first mapping row with low < key <= high, -1 if there is no such row
+    int32_t find(T key) const noexcept
+    {
+        const auto segment = std::lower_bound(_bounds.begin(), _bounds.end(), key) - _bounds.begin();
+        if (segment == 0 || segment == std::ptrdiff_t(_bounds.size())) {
+            return -1;
+        }
+
+        return _segmentRows[segment];
+    }
+
+private:
+    std::vector<T> _bounds;
+    std::vector<int32_t> _segmentRows;
+};
+}
+
+template <typename ResultType, template <typename> typename RasterType, typename MappingType, typename T>
+auto reclass_to(const MappingData<MappingType>& mapping, const RasterType<T>& ras)
+{
+    RasterType<ResultType> result(ras.metadata());
+    ResultType nodata = static_cast<ResultType>(result.has_nan() ? RasterType<ResultType>::NaN : -9999.0);
+    result.set_nodata(nodata);
+
+    internal::reclass_cells<1>(mapping, result, nodata, [&](std::size_t i) {
+        return std::array<std::optional<MappingType>, 1>{{ras.template optional_value_as<MappingType>(i)}};
+    });
 
     return result;
 }
@@ -141,22 +373,10 @@ auto reclass_to(const MappingData<MappingType>& mapping, const RasterType<T1>& r
         throw InvalidArgument("Raster sizes should match {} {}", ras1.size(), ras2.size());
     }
 
-    const auto size   = ras1.size();
-    bool warningGiven = false;
-
-    for (std::size_t i = 0; i < size; ++i) {
-        std::array<std::optional<MappingType>, 2> values = {{ras1.template optional_value_as<MappingType>(i),
+    internal::reclass_cells<2>(mapping, result, nodata, [&](std::size_t i) {
+        return std::array<std::optional<MappingType>, 2>{{ras1.template optional_value_as<MappingType>(i),
             ras2.template optional_value_as<MappingType>(i)}};
-
-        auto v = internal::reclass_value<MappingType, 2>(values, mapping, warningGiven);
-        if (v) {
-            result[i] = static_cast<ResultType>(*v);
-            result.mark_as_data(i);
-        } else {
-            result[i] = nodata;
-            result.mark_as_nodata(i);
-        }
-    }
+    });
 
     return result;
 }
@@ -172,23 +392,11 @@ auto reclass_to(const MappingData<MappingType>& mapping, const RasterType<T1>& r
         throw InvalidArgument("Raster sizes should match {} {} {}", ras1.size(), ras2.size(), ras3.size());
     }
 
-    const auto size   = ras1.size();
-    bool warningGiven = false;
-
-    for (std::size_t i = 0; i < size; ++i) {
-        std::array<std::optional<MappingType>, 3> values = {{ras1.template optional_value_as<MappingType>(i),
+    internal::reclass_cells<3>(mapping, result, nodata, [&](std::size_t i) {
+        return std::array<std::optional<MappingType>, 3>{{ras1.template optional_value_as<MappingType>(i),
             ras2.template optional_value_as<MappingType>(i),
             ras3.template optional_value_as<MappingType>(i)}};
-
-        auto v = internal::reclass_value<ResultType, 3>(values, mapping, warningGiven);
-        if (v) {
-            result[i] = static_cast<ResultType>(*v);
-            result.mark_as_data(i);
-        } else {
-            result[i] = nodata;
-            result.mark_as_nodata(i);
-        }
-    }
+    });
 
     return result;
 }
@@ -310,30 +518,35 @@ RasterType<T> nreclass(const MappingData<float>& mapping, const RasterType<T>& r
     int countNANbecauseKeyNAN    = 0;
     int countNANbecauseNoSuchKey = 0;
 
+    const internal::NReclassIndex<T> index(mapping);
+    std::vector<int32_t> rows(raster.size(), -1);
+
+    const auto chunkCount = (raster.size() + internal::s_reclassChunkSize - 1) / internal::s_reclassChunkSize;
+#pragma omp parallel for schedule(static)
+    for (int64_t chunk = 0; chunk < int64_t(chunkCount); ++chunk) {
+        const auto end = std::min(raster.size(), std::size_t(chunk + 1) * internal::s_reclassChunkSize);
+        for (auto i = std::size_t(chunk) * internal::s_reclassChunkSize; i < end; ++i) {
+            if (!raster.is_nodata(i)) {
+                rows[i] = index.find(raster[i]);
+            }
+        }
+    }
+
     for (std::size_t i = 0; i < raster.size(); ++i) {
         if (raster.is_nodata(i)) {
             ++countNANbecauseKeyNAN;
             continue;
         }
 
-        const auto key = raster[i];
-        bool found     = false;
-        for (std::size_t j = 0; j < mapping.size(); ++j) {
-            if (T(mapping[j][0]) < key && key <= T(mapping[j][1])) {
-                if (!std::isnan(mapping[j][2])) {
-                    result[i] = static_cast<T>(mapping[j][2]);
-                    result.mark_as_data(i);
-                }
-
-                found = true;
-                break;
+        if (const auto row = rows[i]; row >= 0) {
+            if (!std::isnan(mapping[row][2])) {
+                result[i] = static_cast<T>(mapping[row][2]);
+                result.mark_as_data(i);
             }
-        }
-
-        if (!found) {
+        } else {
             if (!warningTriggered) {
                 warningTriggered = true;
-                Log::warn("nreclass : no entry for key {} (has nodata result)", key);
+                Log::warn("nreclass : no entry for key {} (has nodata result)", raster[i]);
             }
 
             ++countNANbecauseNoSuchKey;
@@ -3,10 +3,15 @@
 #include "gdx/exception.h"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <limits>
 #include <set>
 #include <sstream>
+#include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 namespace gdx {
 
@@ -45,56 +50,171 @@ struct RasterStats
     }
 };
 
-template <typename RasterType, uint32_t HistogramValues = 1024>
-RasterStats<HistogramValues> statistics(const RasterType& ras, double maxValue)
+namespace internal {
+
+// Number of cells that are processed as one parallel chunk
+static constexpr std::size_t s_statisticsChunkSize = 1 << 18;
+
+// Raster types that provide simd access to their data values (DenseRaster)
+template <typename RasterType, typename = void>
+struct has_simd_data_visit : std::false_type
 {
-    RasterStats<HistogramValues> stats;
-    if (maxValue >= HistogramValues) {
-        maxValue = HistogramValues - 1;
+};
+
+template <typename RasterType>
+struct has_simd_data_visit<RasterType, std::void_t<decltype(RasterType::simd_supported())>> : std::bool_constant<RasterType::simd_supported()>
+{
+};
+
+template <uint32_t HistogramValues, typename T>
+void add_to_histogram(RasterStats<HistogramValues>& stats, T value, double maxValue)
+{
+    auto intValue = static_cast<int32_t>(value);
+
+    if (intValue < 0) {
+        ++stats.negativeValues;
+    } else if (maxValue < value) {
+        ++stats.countHigh;
+    } else {
+        ++stats.histogram[intValue];
     }
+}
 
-    if (maxValue < 0) {
-        maxValue = 0;
+template <uint32_t HistogramValues, typename T>
+void add_to_statistics(RasterStats<HistogramValues>& stats, T value, double maxValue)
+{
+    if (value != 0) {
+        ++stats.nonZeroValues;
+    } else {
+        ++stats.zeroValues;
     }
 
-    for (std::size_t i = 0; i < ras.size(); ++i) {
-        if (ras.is_nodata(i)) {
-            ++stats.noDataValues;
-            continue;
-        }
+    stats.sum += value;
+    stats.highestValue = std::max(stats.highestValue, static_cast<double>(value));
+    stats.lowestValue  = std::min(stats.lowestValue, static_cast<double>(value));
+
+    add_to_histogram(stats, value, maxValue);
+
+    if (value != 0) {
+        // calculate sigma via sample variance, see https://en.wikipedia.org/wiki/variance#Sample_variance
+        stats.sigmaNonZero += value * value;
+    }
+}
 
-        auto value = ras[i];
-        if constexpr (std::decay_t<RasterType>::raster_type_has_nan) {
-            if (std::isnan(value)) {
-                ++stats.nanValues;
+// Statistics of the cells in the index range [first, last), sigmaNonZero contains the sum of the squared values
+template <uint32_t HistogramValues, typename RasterType>
+void chunk_statistics(const RasterType& ras, std::size_t first, std::size_t last, double maxValue, RasterStats<HistogramValues>& stats)
+{
+    using T = typename std::decay_t<RasterType>::value_type;
+
+    if constexpr (has_simd_data_visit<std::decay_t<RasterType>>::value) {
+        // the counts, minimum and maximum are computed on the simd vectors
+        // the sums and the histogram are updated per value, so the sums are accumulated in double like the serial path
+        ras.visit_data_simd(first, last, [&stats, maxValue](const auto& v, const auto& dataMask) {
+            auto valid = dataMask;
+            stats.noDataValues += v.size() - std::size_t(dataMask.count());
+            if constexpr (std::is_floating_point_v<T>) {
+                valid = dataMask && (v == v);
+                stats.nanValues += std::size_t(dataMask.count() - valid.count());
+            }
+
+            const auto validCount = std::size_t(valid.count());
+            if (validCount == 0) {
+                return;
+            }
+
+            const auto zeroCount = std::size_t((valid && (v == T(0))).count());
+            stats.zeroValues += zeroCount;
+            stats.nonZeroValues += validCount - zeroCount;
+            stats.highestValue = std::max(stats.highestValue, static_cast<double>(v.max(valid)));
+            stats.lowestValue  = std::min(stats.lowestValue, static_cast<double>(v.min(valid)));
+
+            for (std::size_t lane = 0; lane < v.size(); ++lane) {
+                if (!valid[lane]) {
+                    continue;
+                }
+
+                const T value = v[lane];
+                stats.sum += value;
+                stats.sigmaNonZero += value * value;
+                add_to_histogram(stats, value, maxValue);
+            }
+        });
+    } else {
+        for (std::size_t i = first; i < last; ++i) {
+            if (ras.is_nodata(i)) {
+                ++stats.noDataValues;
                 continue;
             }
-        }
 
-        if (value != 0) {
-            ++stats.nonZeroValues;
-        } else {
-            ++stats.zeroValues;
+            auto value = ras[i];
+            if constexpr (std::decay_t<RasterType>::raster_type_has_nan) {
+                if (std::isnan(value)) {
+                    ++stats.nanValues;
+                    continue;
+                }
+            }
+
+            add_to_statistics(stats, value, maxValue);
         }
+    }
+}
 
-        stats.sum += value;
-        stats.highestValue = std::max(stats.highestValue, static_cast<double>(value));
-        stats.lowestValue  = std::min(stats.lowestValue, static_cast<double>(value));
+template <uint32_t HistogramValues>
+void merge_statistics(RasterStats<HistogramValues>& stats, const RasterStats<HistogramValues>& other)
+{
+    stats.negativeValues += other.negativeValues;
+    stats.countHigh += other.countHigh;
+    stats.nonZeroValues += other.nonZeroValues;
+    stats.zeroValues += other.zeroValues;
+    stats.nanValues += other.nanValues;
+    stats.noDataValues += other.noDataValues;
 
-        auto intValue = static_cast<int32_t>(value);
+    stats.sum += other.sum;
+    stats.sigmaNonZero += other.sigmaNonZero;
+    stats.highestValue = std::max(stats.highestValue, other.highestValue);
+    stats.lowestValue  = std::min(stats.lowestValue, other.lowestValue);
 
-        if (intValue < 0) {
-            ++stats.negativeValues;
-        } else if (maxValue < value) {
-            ++stats.countHigh;
-        } else {
-            ++stats.histogram[intValue];
-        }
+    for (uint32_t i = 0; i < HistogramValues; ++i) {
+        stats.histogram[i] += other.histogram[i];
+    }
+}
 
-        if (value != 0) {
-            // calculate sigma via sample variance, see https://en.wikipedia.org/wiki/variance#Sample_variance
-            stats.sigmaNonZero += value * value;
-        }
+// Small integral types are collected in a flag per possible value instead of a set
+template <typename T>
+inline constexpr bool use_unique_value_flags_v = std::is_integral_v<T> && sizeof(T) <= 2;
+
+}
+
+/* The raster is split in chunks that are processed in parallel, every chunk has its own partial statistics
+ * The partial statistics are merged in chunk order so the result does not depend on the number of threads
+ * For DenseRaster the chunks are processed with simd instructions
+ */
+template <typename RasterType, uint32_t HistogramValues = 1024>
+RasterStats<HistogramValues> statistics(const RasterType& ras, double maxValue)
+{
+    RasterStats<HistogramValues> stats;
+    if (maxValue >= HistogramValues) {
+        maxValue = HistogramValues - 1;
+    }
+
+    if (maxValue < 0) {
+        maxValue = 0;
+    }
+
+    const auto size       = ras.size();
+    const auto chunkCount = (size + internal::s_statisticsChunkSize - 1) / internal::s_statisticsChunkSize;
+    std::vector<RasterStats<HistogramValues>> chunkStats(chunkCount);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t chunk = 0; chunk < int64_t(chunkCount); ++chunk) {
+        const auto first = std::size_t(chunk) * internal::s_statisticsChunkSize;
+        const auto last  = std::min(size, first + internal::s_statisticsChunkSize);
+        internal::chunk_statistics(ras, first, last, maxValue, chunkStats[chunk]);
+    }
+
+    for (auto& partialStats : chunkStats) {
+        internal::merge_statistics(stats, partialStats);
     }
 
     size_t n     = stats.nonZeroValues;
@@ -106,15 +226,64 @@ RasterStats<HistogramValues> statistics(const RasterType& ras, double maxValue)
     return stats;
 }
 
+/* Every thread collects the values of its part of the raster, the results are merged at the end
+ * 8 and 16 bit integral values are collected as a flag per possible value
+ */
 template <typename RasterType, typename MapType>
 auto unique_raster_values(const RasterType& ras, MapType& map)
 {
-    for (std::size_t i = 0; i < ras.size(); ++i) {
-        if (ras.is_nodata(i)) {
-            continue;
+    using T = typename std::decay_t<RasterType>::value_type;
+
+    const auto size       = ras.size();
+    const auto chunkCount = int64_t((size + internal::s_statisticsChunkSize - 1) / internal::s_statisticsChunkSize);
+
+    if constexpr (internal::use_unique_value_flags_v<T>) {
+        constexpr auto valueCount = std::size_t(std::numeric_limits<T>::max()) - std::size_t(int64_t(std::numeric_limits<T>::lowest())) + 1;
+        std::vector<uint8_t> present(valueCount, 0);
+
+#pragma omp parallel
+        {
+            std::vector<uint8_t> threadPresent(valueCount, 0);
+
+#pragma omp for schedule(static)
+            for (int64_t chunk = 0; chunk < chunkCount; ++chunk) {
+                const auto last = std::min(size, std::size_t(chunk + 1) * internal::s_statisticsChunkSize);
+                for (auto i = std::size_t(chunk) * internal::s_statisticsChunkSize; i < last; ++i) {
+                    if (!ras.is_nodata(i)) {
+                        threadPresent[std::size_t(int64_t(ras[i]) - int64_t(std::numeric_limits<T>::lowest()))] = 1;
+                    }
+                }
+            }
+
+#pragma omp critical
+            for (std::size_t i = 0; i < valueCount; ++i) {
+                present[i] |= threadPresent[i];
+            }
         }
 
-        map.insert(ras[i]);
+        for (std::size_t i = 0; i < valueCount; ++i) {
+            if (present[i]) {
+                map.insert(static_cast<T>(int64_t(i) + int64_t(std::numeric_limits<T>::lowest())));
+            }
+        }
+    } else {
+#pragma omp parallel
+        {
+            MapType threadMap;
+
+#pragma omp for schedule(static)
+            for (int64_t chunk = 0; chunk < chunkCount; ++chunk) {
+                const auto last = std::min(size, std::size_t(chunk + 1) * internal::s_statisticsChunkSize);
+                for (auto i = std::size_t(chunk) * internal::s_statisticsChunkSize; i < last; ++i) {
+                    if (!ras.is_nodata(i)) {
+                        threadMap.insert(ras[i]);
+                    }
+                }
+            }
+
+#pragma omp critical
+            map.insert(threadMap.begin(), threadMap.end());
+        }
     }
 }
 
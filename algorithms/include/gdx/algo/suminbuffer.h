@@ -10,11 +10,15 @@
 #include "infra/math.h"
 #include "infra/span.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 namespace gdx {
 
 // "summed area table" technique, see wikipedia
+// The row prefix sums are computed in parallel over the rows, the column accumulation in parallel over blocks of columns
 template <template <typename> typename RasterType, typename T>
 RasterType<double> compute_integral_image(const RasterType<T>& image)
 {
@@ -23,30 +27,35 @@ RasterType<double> compute_integral_image(const RasterType<T>& image)
 
     RasterType<double> summedArea(image.metadata());
 
-    summedArea(0, 0) = image(0, 0);
-
-    for (int c = 1; c < nCols; ++c) {
-        summedArea(0, c) = summedArea(0, c - 1) + image(0, c);
-    }
-
-    for (int r = 1; r < nRows; ++r) {
-        summedArea(r, 0) = summedArea(r - 1, 0) + image(r, 0);
-    }
-
-    for (int r = 1; r < nRows; ++r) {
-        double rowSum            = image(r, 0);
-        auto* pImage             = &image(r, 1);
-        auto* pPrevSummedAreaRow = &summedArea(r - 1, 1);
-        auto* pSummedAreaRow     = &summedArea(r, 1);
-        for (int c = 1; c < nCols; ++c) {
-            rowSum += *pImage;                              // rowSum += image(r, c);
-            *pSummedAreaRow = rowSum + *pPrevSummedAreaRow; // summedArea(r,c) = rowSum + summedArea(r-1,c);
+#pragma omp parallel for schedule(static)
+    for (int r = 0; r < nRows; ++r) {
+        double rowSum        = 0.0;
+        auto* pImage         = &image(r, 0);
+        auto* pSummedAreaRow = &summedArea(r, 0);
+        for (int c = 0; c < nCols; ++c) {
+            rowSum += *pImage; // rowSum += image(r, c);
+            *pSummedAreaRow = rowSum;
             ++pImage;
-            ++pPrevSummedAreaRow;
             ++pSummedAreaRow;
         }
     }
 
+    const int columnBlockSize  = 1024;
+    const int columnBlockCount = (nCols + columnBlockSize - 1) / columnBlockSize;
+
+#pragma omp parallel for schedule(static)
+    for (int block = 0; block < columnBlockCount; ++block) {
+        const int c0 = block * columnBlockSize;
+        const int c1 = std::min(nCols, c0 + columnBlockSize);
+        for (int r = 1; r < nRows; ++r) {
+            auto* pPrevSummedAreaRow = &summedArea(r - 1, 0);
+            auto* pSummedAreaRow     = &summedArea(r, 0);
+            for (int c = c0; c < c1; ++c) {
+                pSummedAreaRow[c] += pPrevSummedAreaRow[c]; // summedArea(r,c) = rowSum + summedArea(r-1,c);
+            }
+        }
+    }
+
     return summedArea;
 }
 
@@ -148,13 +157,28 @@ T compute_sum_within_circle(const int32_t row, const int32_t col, const int32_t
     return static_cast<T>(thisSum);
 }
 
+// Number of rows that share the sliding circle state in sum_in_buffer, the strips are processed in parallel
+static constexpr int32_t s_sumInBufferStripRows = 16;
+
 template <template <typename> typename RasterType, typename T>
 RasterType<T> sum_in_buffer(const RasterType<T>& ras, float radiusInMeter, BufferStyle bufferStyle)
 {
     static_assert(!std::is_same_v<T, uint8_t>, "Bad overload chosen for uint8_t");
 
-    auto src = ras.copy();
-    replace_nodata_in_place(src, 0);
+    // the values with nodata as 0, without a nodata value so the raster does not keep a mask
+    auto srcMeta = ras.metadata();
+    srcMeta.nodata.reset();
+    RasterType<T> src(srcMeta);
+
+    const auto rows = ras.metadata().rows;
+    const auto cols = ras.metadata().cols;
+
+#pragma omp parallel for schedule(static)
+    for (int32_t r = 0; r < rows; ++r) {
+        for (size_t i = size_t(r) * cols; i < size_t(r + 1) * cols; ++i) {
+            src[i] = ras.is_nodata(i) ? T(0) : ras[i];
+        }
+    }
 
     float radiusInCells = radiusInMeter / static_cast<float>(ras.metadata().cellSize.x);
     int32_t radius      = int32_t(radiusInCells);
@@ -167,30 +191,35 @@ RasterType<T> sum_in_buffer(const RasterType<T>& ras, float radiusInMeter, Buffe
 
     RasterType<T> result(ras.metadata());
 
-    const auto rows = ras.metadata().rows;
-    const auto cols = ras.metadata().cols;
-
-    long double prevSum = 0;
-    int prevR           = -radius + 1;
-    int prevC           = -radius + 1;
-
     // datastructure for RoundBuffer style
     std::vector<Cell> plusRight;
     std::vector<Cell> minLeft;
     std::vector<Cell> plusDown;
     std::vector<Cell> minTop;
 
-    auto summedArea = compute_integral_image(src);
+    const auto summedArea = compute_integral_image(src);
     if (bufferStyle == BufferStyle::Circular) {
         compute_circle_border_offsets(radius, plusRight, minLeft, plusDown, minTop);
     }
 
-    for (int32_t r = 0; r < rows; ++r) {
-        for (int32_t c = 0; c < cols; ++c) {
-            if (bufferStyle == BufferStyle::Circular) {
-                result(r, c) = compute_sum_within_circle<T>(r, c, radius, rows, cols, src, prevSum, prevR, prevC, plusRight, minLeft, plusDown, minTop, summedArea);
-            } else {
-                result(r, c) = compute_sum_within_rectangle_around<T>(r, c, radius, summedArea, rows, cols);
+    // Every strip of rows has its own sliding circle state, the strips only share the read only source and integral image
+    const int32_t stripCount = (rows + s_sumInBufferStripRows - 1) / s_sumInBufferStripRows;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int32_t strip = 0; strip < stripCount; ++strip) {
+        long double prevSum = 0;
+        int prevR           = -radius + 1;
+        int prevC           = -radius + 1;
+
+        const int32_t r0 = strip * s_sumInBufferStripRows;
+        const int32_t r1 = std::min(rows, r0 + s_sumInBufferStripRows);
+        for (int32_t r = r0; r < r1; ++r) {
+            for (int32_t c = 0; c < cols; ++c) {
+                if (bufferStyle == BufferStyle::Circular) {
+                    result(r, c) = compute_sum_within_circle<T>(r, c, radius, rows, cols, src, prevSum, prevR, prevC, plusRight, minLeft, plusDown, minTop, summedArea);
+                } else {
+                    result(r, c) = compute_sum_within_rectangle_around<T>(r, c, radius, summedArea, rows, cols);
+                }
             }
         }
     }
@@ -227,36 +256,183 @@ inline auto compute_d2(const T arow, const T acol, const T brow, const T bcol) -
     return drow * drow + dcol * dcol;
 }
 
-template <template <typename> typename RasterType, typename T>
-RasterType<T> max_in_buffer(const RasterType<T>& ras, float radiusInMeter)
+namespace internal {
+
+/* Extreme (max or min) of every window of 2 * halfWidth + 1 values using the van Herk/Gil-Werman algorithm
+ * The values are split in blocks of the window size, every window covers the end of one block and the start of the next block
+ * so it is the extreme of a suffix and a prefix within those blocks: 3 comparisons per value, independent of the window size
+ * The buffers are kept between calls so one instance per thread can process all the rows
+ */
+template <typename T, typename Select>
+class SlidingWindowExtreme
 {
-    float radiusInCells            = radiusInMeter / static_cast<float>(ras.metadata().cellSize.x);
-    const long long radius2InCells = (long long)(ceil(radiusInCells * radiusInCells));
-    const auto rows                = ras.metadata().rows;
-    const auto cols                = ras.metadata().cols;
+public:
+    SlidingWindowExtreme(T identity, Select select)
+    : _identity(identity)
+    , _select(select)
+    {
+    }
 
-    RasterType<T> result(ras.metadata());
-    result.fill(0);
+    // Combines the extreme of the window around every value with the current value in output
+    // values outside of [0, count) are treated as the identity value
+    void combine(const T* values, int32_t count, int32_t halfWidth, T* output)
+    {
+        const int32_t window = 2 * halfWidth + 1;
+        const int32_t size   = count + 2 * halfWidth;
 
-    for (int32_t row = 0; row < rows; ++row) {
-        for (int32_t col = 0; col < cols; ++col) {
-            int r0, c0, r1, c1;
-            compute_rect_on_map_around(row, col, int(ceil(radiusInCells)), r0, c0, r1, c1, rows, cols);
-            T value = std::numeric_limits<T>::lowest();
-            for (int r = r0; r <= r1; ++r) {
-                for (int c = c0; c <= c1; ++c) {
-                    if (compute_d2<long long>(row, col, r, c) <= radius2InCells) {
-                        if (!ras.is_nodata(r, c) && value < ras(r, c)) {
-                            value = ras(r, c);
-                        }
+        _prefix.resize(size);
+        _suffix.resize(size);
+
+        for (int32_t i = 0; i < size; ++i) {
+            const auto value = padded_value(values, count, halfWidth, i);
+            _prefix[i]       = (i % window == 0) ? value : _select(_prefix[i - 1], value);
+        }
+
+        for (int32_t i = size - 1; i >= 0; --i) {
+            const auto value = padded_value(values, count, halfWidth, i);
+            _suffix[i]       = (i == size - 1 || (i + 1) % window == 0) ? value : _select(_suffix[i + 1], value);
+        }
+
+        for (int32_t i = 0; i < count; ++i) {
+            output[i] = _select(output[i], _select(_suffix[i], _prefix[i + window - 1]));
+        }
+    }
+
+private:
+    T padded_value(const T* values, int32_t count, int32_t halfWidth, int32_t index) const noexcept
+    {
+        const int32_t valueIndex = index - halfWidth;
+        return (valueIndex >= 0 && valueIndex < count) ? values[valueIndex] : _identity;
+    }
+
+    T _identity;
+    Select _select;
+    std::vector<T> _prefix;
+    std::vector<T> _suffix;
+};
+
+/* Every cell gets the extreme of the values within the buffer, cells without data in their buffer get the identity value
+ * Circular: the circle is a set of horizontal segments, the result row is combined from the sliding window extremes of the
+ *           segments on the neighbouring rows, which is O(radius) per cell
+ * Square: the square is separable, a horizontal and a vertical sliding window pass, which is O(1) per cell
+ */
+template <template <typename> typename RasterType, typename T, typename Select>
+RasterType<T> extreme_in_buffer(const RasterType<T>& ras, float radiusInMeter, BufferStyle bufferStyle, T identity, Select select)
+{
+    if (radiusInMeter < 0) {
+        throw InvalidArgument("Buffer radius should not be negative ({})", radiusInMeter);
+    }
+
+    const float radiusInCells = radiusInMeter / static_cast<float>(ras.metadata().cellSize.x);
+    const auto rows           = ras.metadata().rows;
+    const auto cols           = ras.metadata().cols;
+
+    std::vector<T> values(ras.size(), identity);
+    for (size_t i = 0; i < ras.size(); ++i) {
+        if (!ras.is_nodata(i)) {
+            if constexpr (std::is_floating_point_v<T>) {
+                if (std::isnan(ras[i])) {
+                    continue;
+                }
+            }
+
+            values[i] = ras[i];
+        }
+    }
+
+    std::vector<T> extremes(ras.size(), identity);
+
+    if (bufferStyle == BufferStyle::Circular) {
+        const auto radius              = int32_t(std::ceil(radiusInCells));
+        const long long radius2InCells = (long long)(std::ceil(radiusInCells * radiusInCells));
+
+        // the columns within the radius on every row of the circle are [-halfWidth, halfWidth], -1 if the row is outside of the circle
+        std::vector<int32_t> halfWidths(2 * radius + 1, -1);
+        for (int32_t dr = -radius; dr <= radius; ++dr) {
+            auto& halfWidth = halfWidths[dr + radius];
+            while (halfWidth < radius && (long long)(dr * dr) + (long long)(halfWidth + 1) * (halfWidth + 1) <= radius2InCells) {
+                ++halfWidth;
+            }
+        }
+
+#pragma omp parallel
+        {
+            SlidingWindowExtreme<T, Select> slidingWindow(identity, select);
+
+#pragma omp for schedule(dynamic)
+            for (int32_t r = 0; r < rows; ++r) {
+                const int32_t dr0 = std::max(-radius, -r);
+                const int32_t dr1 = std::min(radius, rows - 1 - r);
+                for (int32_t dr = dr0; dr <= dr1; ++dr) {
+                    if (const auto halfWidth = halfWidths[dr + radius]; halfWidth >= 0) {
+                        slidingWindow.combine(&values[size_t(r + dr) * cols], cols, halfWidth, &extremes[size_t(r) * cols]);
                     }
                 }
             }
-            result(row, col) = value;
         }
+    } else {
+        // same buffer size as sum_in_buffer: the square with the area of the circle
+        const auto radius = int32_t(int32_t(radiusInCells) * std::sqrt(inf::math::pi) / 2.0);
+
+        std::vector<T> rowExtremes(ras.size(), identity);
+
+#pragma omp parallel
+        {
+            SlidingWindowExtreme<T, Select> slidingWindow(identity, select);
+            std::vector<T> column(rows), columnExtremes(rows);
+
+#pragma omp for schedule(dynamic)
+            for (int32_t r = 0; r < rows; ++r) {
+                slidingWindow.combine(&values[size_t(r) * cols], cols, radius, &rowExtremes[size_t(r) * cols]);
+            }
+
+#pragma omp for schedule(dynamic)
+            for (int32_t c = 0; c < cols; ++c) {
+                for (int32_t r = 0; r < rows; ++r) {
+                    column[r] = rowExtremes[size_t(r) * cols + c];
+                }
+
+                std::fill(columnExtremes.begin(), columnExtremes.end(), identity);
+                slidingWindow.combine(column.data(), rows, radius, columnExtremes.data());
+
+                for (int32_t r = 0; r < rows; ++r) {
+                    extremes[size_t(r) * cols + c] = columnExtremes[r];
+                }
+            }
+        }
+    }
+
+    RasterType<T> result(ras.metadata());
+    result.fill(0);
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = extremes[i];
     }
 
     return result;
 }
 
 }
+
+/* Every cell gets the maximum of the values within its radius (in meter), nodata values are ignored
+ * Cells without data within the radius get the lowest value of the type
+ */
+template <template <typename> typename RasterType, typename T>
+RasterType<T> max_in_buffer(const RasterType<T>& ras, float radiusInMeter, BufferStyle bufferStyle = BufferStyle::Circular)
+{
+    return internal::extreme_in_buffer(ras, radiusInMeter, bufferStyle, std::numeric_limits<T>::lowest(), [](T lhs, T rhs) {
+        return std::max(lhs, rhs);
+    });
+}
+
+/* Every cell gets the minimum of the values within its radius (in meter), nodata values are ignored
+ * Cells without data within the radius get the maximum value of the type
+ */
+template <template <typename> typename RasterType, typename T>
+RasterType<T> min_in_buffer(const RasterType<T>& ras, float radiusInMeter, BufferStyle bufferStyle = BufferStyle::Circular)
+{
+    return internal::extreme_in_buffer(ras, radiusInMeter, bufferStyle, std::numeric_limits<T>::max(), [](T lhs, T rhs) {
+        return std::min(lhs, rhs);
+    });
+}
+
+}
@@ -1,13 +1,14 @@
 #pragma once
 
+#include "gdx/algo/zonalstatistics.h"
 #include "gdx/exception.h"
 #include "gdx/log.h"
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <limits>
-#include <map>
-#include <set>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -34,131 +35,106 @@ table_row_impl(
     const RasterType<TCat>& categoryRaster, // this is typically a Byte or int16 raster
     Operation op)
 {
-    const auto rows = ras.rows();
-    const auto cols = ras.cols();
-    std::map<int, std::pair<double, int>> cat;
+    const internal::ZoneIndex zones(
+        ras.size(), [&categoryRaster](std::size_t i) { return static_cast<int>(categoryRaster[i]); }, [&categoryRaster](std::size_t i) { return !categoryRaster.is_nodata(i); });
+    const auto stats = internal::zonal_statistics(zones, ras);
 
-    if (op == Operation::AverageInCat1) {
-        cat[1] = std::pair<double, int>(0, 0);
-    }
-
-    int countNodata = 0;
-    std::set<int> catWithNodata;
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            int currentCategory = static_cast<int>(categoryRaster(r, c));
-            auto currentValue   = ras(r, c);
-
-            if (!categoryRaster.is_nodata(r, c)) {
-                if (!ras.is_nodata(r, c)) {
-                    auto iter = cat.find(currentCategory);
-
-                    if (iter == cat.end()) {
-                        if (op == Operation::Sum || op == Operation::Average || op == Operation::Count || op == Operation::Min || op == Operation::Max) {
-                            cat.emplace(currentCategory, std::pair<double, int>(static_cast<double>(currentValue), 1));
-                        } else if (op == Operation::CountNonZero) {
-                            if (currentValue != 0) {
-                                cat.emplace(currentCategory, std::pair<double, int>(static_cast<double>(currentValue), 1));
-                            }
-                        } else if (op == Operation::MinNonZero) {
-                            if (currentValue != 0) {
-                                cat.emplace(currentCategory, std::pair<double, int>(static_cast<double>(currentValue), 1));
-                            }
-                        } else if (op == Operation::AverageInCat1) {
-                            if (currentCategory == 1) {
-                                cat.emplace(currentCategory, std::pair<double, int>(static_cast<double>(currentValue), 1));
-                            }
-                        }
-                    } else {
-                        if (op == Operation::Sum || op == Operation::Average || op == Operation::Count) {
-                            iter->second.first += currentValue;
-                            ++iter->second.second;
-                        } else if (op == Operation::CountNonZero) {
-                            if (currentValue != 0) {
-                                ++iter->second.second;
-                            }
-                        } else if (op == Operation::Min) {
-                            if (iter->second.first > currentValue) {
-                                iter->second.first = currentValue;
-                            }
-                        } else if (op == Operation::MinNonZero) {
-                            if (currentValue != 0) {
-                                if (iter->second.first > currentValue) {
-                                    iter->second.first = currentValue;
-                                }
-                            }
-                        } else if (op == Operation::Max) {
-                            if (iter->second.first < currentValue) {
-                                iter->second.first = currentValue;
-                            }
-                        } else if (op == Operation::AverageInCat1) {
-                            if (currentCategory == 1) {
-                                iter->second.first += currentValue;
-                                ++iter->second.second;
-                            }
-                        } else {
-                            throw RuntimeError("table_row : unsupported operation {}", int(op));
-                        }
-                    }
-                } else if (ras.is_nodata(r, c)) {
-                    ++countNodata;
-                    catWithNodata.insert(currentCategory);
-                    auto iter = cat.find(currentCategory);
-                    if (iter == cat.end()) {
-                        if (op != Operation::AverageInCat1) {
-                            cat.emplace(currentCategory, std::make_pair<double, int>(0.0, 0));
-                        }
-                    }
-                }
-            }
-        }
+    int64_t countNodata = 0;
+    for (auto& zoneStats : stats) {
+        countNodata += zoneStats.nodataCount;
     }
 
     if (countNodata) {
         Log::warn("tablerow(xls,op,A,B): map A contains {} NODATA values where B is a normal nonzero value\nThese values of A are ignored in the output table", countNodata);
     }
 
-    if (op != Operation::AverageInCat1) {
-        for (auto& elem : catWithNodata) {
-            if (cat.find(elem) == cat.end()) {
-                cat.emplace(elem, std::pair<double, int>(std::numeric_limits<double>::quiet_NaN(), 1));
-            }
+    auto isNan = [&ras](int64_t index) {
+        if constexpr (std::numeric_limits<TVal>::has_quiet_NaN) {
+            return std::isnan(ras[index]);
+        } else {
+            (void)index;
+            return false;
         }
-    }
+    };
 
     std::vector<std::string> header;
-    if (true) {
-        for (auto iter = cat.begin(); iter != cat.end(); ++iter) {
-            header.push_back(std::to_string(iter->first));
-        }
-        if (cat.empty()) {
-            header.push_back(""); // print an empty column, that prevents problems with automatic processing those reults
+    std::vector<std::string> line;
+
+    if (op == Operation::AverageInCat1) {
+        header.push_back(std::to_string(1));
+        if (const auto zone = zones.find(1); zone >= 0 && stats[zone].count > 0 && !std::isnan(double(stats[zone].sum))) {
+            line.push_back(std::to_string(double(stats[zone].sum) / stats[zone].count));
+        } else {
+            line.push_back("");
         }
+
+        return std::pair(header, line);
     }
 
-    std::vector<std::string> line;
-    for (auto& [catKey, value] : cat) {
-        (void)catKey;
-        if (op == Operation::AverageInCat1) {
-            if (value.second > 0 && !std::isnan(value.first)) {
-                line.push_back(std::to_string(value.first / value.second));
-            } else {
-                line.push_back("");
+    const bool nonZeroOperation = op == Operation::CountNonZero || op == Operation::MinNonZero;
+    for (std::size_t zone = 0; zone < zones.zone_count(); ++zone) {
+        const auto& zoneStats = stats[zone];
+
+        // a category is listed from its first data value (nonzero value for the non zero operations) or nodata value
+        // when the nodata value comes first, the minimum and maximum are not available
+        const auto firstValueCell = nonZeroOperation ? zoneStats.firstNonZeroCell : zoneStats.firstDataCell;
+        if (firstValueCell == internal::s_noZoneCell && zoneStats.nodataCount == 0) {
+            continue;
+        }
+
+        const bool startsWithNodata = zoneStats.firstNodataCell < firstValueCell;
+        const bool firstValueIsNan  = !startsWithNodata && isNan(firstValueCell);
+        const bool hasSum           = zoneStats.count > 0 && !std::isnan(double(zoneStats.sum));
+
+        std::optional<std::string> value;
+        switch (op) {
+        case Operation::Sum:
+            if (hasSum) {
+                value = std::to_string(double(zoneStats.sum));
             }
-        } else {
-            if (value.second > 0 && !std::isnan(value.first)) {
-                if (op != Operation::Count && op != Operation::CountNonZero) {
-                    line.push_back(std::to_string((op != Operation::Average ? value.first : value.first / value.second)));
-                } else {
-                    line.push_back(std::to_string(value.second));
-                }
-            } else {
-                line.push_back("=NA()");
+            break;
+        case Operation::Average:
+            if (hasSum) {
+                value = std::to_string(double(zoneStats.sum) / zoneStats.count);
+            }
+            break;
+        case Operation::Count:
+            if (hasSum) {
+                value = std::to_string(zoneStats.count);
             }
+            break;
+        case Operation::CountNonZero:
+            if (zoneStats.nonZeroCount > 0 && !firstValueIsNan) {
+                value = std::to_string(zoneStats.nonZeroCount);
+            }
+            break;
+        case Operation::Min:
+            if (!startsWithNodata && !firstValueIsNan) {
+                value = std::to_string(double(zoneStats.min));
+            }
+            break;
+        case Operation::MinNonZero:
+            if (!startsWithNodata && !firstValueIsNan) {
+                value = std::to_string(double(zoneStats.minNonZero));
+            }
+            break;
+        case Operation::Max:
+            if (!startsWithNodata && !firstValueIsNan) {
+                value = std::to_string(double(zoneStats.max));
+            }
+            break;
+        default:
+            throw RuntimeError("table_row : unsupported operation {}", int(op));
         }
+
+        header.push_back(std::to_string(zones.zone_id(int32_t(zone))));
+        line.push_back(value.value_or("=NA()"));
     }
-    if (cat.empty()) {
-        line.push_back(""); // print an empty column, that prevents problems with automatic processing those reults
+
+    if (header.empty()) {
+        // print an empty column, that prevents problems with automatic processing those reults
+        header.push_back("");
+        line.push_back("");
     }
 
     return std::pair(header, line);
@@ -5,6 +5,12 @@
 #include "gdx/rastermetadata.h"
 #include "infra/span.h"
 
+#include "gdx/algo/distancetransform.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 namespace gdx {
 
 /*! calculates Voronoi polygons mask for a given list of locations
@@ -16,6 +22,8 @@ namespace gdx {
  *  The calculated mask contains 0 in the polygon surrounding the first location,
  *  1 in the polygon surrounding the seconds location, and so on
  *  returns a numpy array containing the calculated Voronoi polygons mask
+ *  The nearest location of every cell is obtained from a euclidean nearest target transform, which is linear
+ *  in the number of cells instead of visiting every location for every cell
  */
 template <typename RasterType>
 RasterType voronoi(const RasterMetadata& meta, std::span<const Cell> locations)
@@ -31,35 +39,30 @@ RasterType voronoi(const RasterMetadata& meta, std::span<const Cell> locations)
     }
 
     // put locations in the grid and check for duplicates
-    T locationIndex = 0;
+    std::vector<int64_t> locationIndexes(voronoi.size(), -1);
+    int64_t locationIndex = 0;
     for (auto& location : locations) {
-        auto testIndex = voronoi[location];
+        auto& testIndex = locationIndexes[size_t(location.r) * voronoi.cols() + location.c];
         if (testIndex >= 0) {
             throw InvalidArgument("Duplicate cell in locations: {}", location);
         }
 
-        voronoi[location] = locationIndex++;
+        testIndex = locationIndex++;
     }
 
-    // calculate nearest location in each cell
-    for (int r = 0; r < voronoi.rows(); ++r) {
-        for (int c = 0; c < voronoi.cols(); ++c) {
-            if (voronoi(r, c) == -1) {
-                double minDist = std::numeric_limits<double>::max();
-                T minIndex     = 0;
-                T index        = 0;
-                for (auto& location : locations) {
-                    auto dist = distance(location, Cell(r, c));
-                    if (dist < minDist) {
-                        minDist       = dist;
-                        minIndex      = index;
-                        voronoi(r, c) = minIndex;
-                    }
+    if (locations.empty()) {
+        return voronoi;
+    }
 
-                    ++index;
-                }
-            }
-        }
+    // the nearest location of each cell, in case of equal distances the location that comes first in the list
+    std::vector<int64_t> nearestLocation;
+    internal::euclidean_distance_transform(voronoi.rows(), voronoi.cols(), [&locationIndexes](size_t index) {
+        return locationIndexes[index];
+    },
+                                           nearestLocation, nullptr);
+
+    for (size_t i = 0; i < voronoi.size(); ++i) {
+        voronoi[i] = static_cast<T>(locationIndexes[size_t(nearestLocation[i])]);
     }
 
     return voronoi;
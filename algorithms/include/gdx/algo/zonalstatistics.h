@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdx::internal {
+
+// Zone id ranges up to this size (or up to the number of cells) are remapped with a lookup table
+static constexpr int64_t s_zoneLookupRange = 1 << 16;
+
+// Number of cells that are processed as one parallel chunk
+static constexpr std::size_t s_zonalChunkSize = 1 << 16;
+
+// Cell index of the statistics that have not encountered a cell
+static constexpr int64_t s_noZoneCell = std::numeric_limits<int64_t>::max();
+
+/* Remaps the zone ids of the cells to a dense zone index [0, zone_count()), ordered on the zone id
+ * The remapping is done once, so the statistics can be accumulated in flat arrays instead of maps
+ */
+class ZoneIndex
+{
+public:
+    // zoneId(i) returns the zone id of cell i, the cells for which isZone(i) returns false do not belong to a zone
+    template <typename ZoneIdFunc, typename IsZoneFunc>
+    ZoneIndex(std::size_t size, ZoneIdFunc&& zoneId, IsZoneFunc&& isZone)
+    : _cellZones(size, -1)
+    {
+        int64_t minId = std::numeric_limits<int64_t>::max();
+        int64_t maxId = std::numeric_limits<int64_t>::lowest();
+        for (std::size_t i = 0; i < size; ++i) {
+            if (isZone(i)) {
+                minId = std::min(minId, int64_t(zoneId(i)));
+                maxId = std::max(maxId, int64_t(zoneId(i)));
+            }
+        }
+
+        if (minId > maxId) {
+            return;
+        }
+
+        const auto chunkCount = int64_t((size + s_zonalChunkSize - 1) / s_zonalChunkSize);
+        auto visitChunk       = [size](int64_t chunk, auto&& cb) {
+            const auto last = std::min(size, std::size_t(chunk + 1) * s_zonalChunkSize);
+            for (auto i = std::size_t(chunk) * s_zonalChunkSize; i < last; ++i) {
+                cb(i);
+            }
+        };
+
+        if (double(maxId) - double(minId) < double(std::max(s_zoneLookupRange, int64_t(size)))) {
+            _minId = minId;
+            _lookup.assign(std::size_t(maxId - minId + 1), -1);
+            for (std::size_t i = 0; i < size; ++i) {
+                if (isZone(i)) {
+                    _lookup[std::size_t(int64_t(zoneId(i)) - minId)] = 0;
+                }
+            }
+
+            for (std::size_t i = 0; i < _lookup.size(); ++i) {
+                if (_lookup[i] == 0) {
+                    _lookup[i] = int32_t(_zoneIds.size());
+                    _zoneIds.push_back(minId + int64_t(i));
+                }
+            }
+        } else {
+            for (std::size_t i = 0; i < size; ++i) {
+                if (isZone(i)) {
+                    _zoneIds.push_back(int64_t(zoneId(i)));
+                }
+            }
+
+            std::sort(_zoneIds.begin(), _zoneIds.end());
+            _zoneIds.erase(std::unique(_zoneIds.begin(), _zoneIds.end()), _zoneIds.end());
+        }
+
+#pragma omp parallel for schedule(static)
+        for (int64_t chunk = 0; chunk < chunkCount; ++chunk) {
+            visitChunk(chunk, [&](std::size_t i) {
+                if (isZone(i)) {
+                    _cellZones[i] = find(int64_t(zoneId(i)));
+                }
+            });
+        }
+    }
+
+    std::size_t zone_count() const noexcept
+    {
+        return _zoneIds.size();
+    }
+
+    int64_t zone_id(int32_t zone) const noexcept
+    {
+        return _zoneIds[zone];
+    }
+
+    // The zone of the cell, -1 if the cell does not belong to a zone
+    int32_t cell_zone(std::size_t index) const noexcept
+    {
+        return _cellZones[index];
+    }
+
+    // The zone with the given id, -1 if there is no such zone
+    int32_t find(int64_t id) const noexcept
+    {
+        if (!_lookup.empty()) {
+            const auto offset = id - _minId;
+            return (offset < 0 || offset >= int64_t(_lookup.size())) ? -1 : _lookup[std::size_t(offset)];
+        }
+
+        const auto iter = std::lower_bound(_zoneIds.begin(), _zoneIds.end(), id);
+        return (iter == _zoneIds.end() || *iter != id) ? -1 : int32_t(iter - _zoneIds.begin());
+    }
+
+private:
+    int64_t _minId = 0;
+    std::vector<int32_t> _lookup;
+    std::vector<int64_t> _zoneIds;
+    std::vector<int32_t> _cellZones;
+};
+
+/* The statistics of the values within a zone
+ * The minimum and maximum ignore nan values, the first cell indexes allow the callers
+ * to determine in which order the zone encountered its values
+ */
+template <typename T>
+struct ZoneStatistics
+{
+    using SumType = std::conditional_t<std::is_integral_v<T>, int64_t, double>;
+
+    int64_t count        = 0;
+    int64_t nonZeroCount = 0;
+    int64_t nodataCount  = 0;
+
+    SumType sum  = 0;
+    T min        = std::numeric_limits<T>::max();
+    T max        = std::numeric_limits<T>::lowest();
+    T minNonZero = std::numeric_limits<T>::max();
+    T maxNonZero = std::numeric_limits<T>::lowest();
+
+    int64_t firstDataCell    = s_noZoneCell;
+    int64_t firstNonZeroCell = s_noZoneCell;
+    int64_t firstNodataCell  = s_noZoneCell;
+
+    void add(T value, int64_t index) noexcept
+    {
+        ++count;
+        sum += value;
+        firstDataCell = std::min(firstDataCell, index);
+        min           = std::min(min, value);
+        max           = std::max(max, value);
+
+        if (value != 0) {
+            ++nonZeroCount;
+            firstNonZeroCell = std::min(firstNonZeroCell, index);
+            minNonZero       = std::min(minNonZero, value);
+            maxNonZero       = std::max(maxNonZero, value);
+        }
+    }
+
+    void add_nodata(int64_t index) noexcept
+    {
+        ++nodataCount;
+        firstNodataCell = std::min(firstNodataCell, index);
+    }
+
+    void merge(const ZoneStatistics& other) noexcept
+    {
+        count += other.count;
+        nonZeroCount += other.nonZeroCount;
+        nodataCount += other.nodataCount;
+        sum += other.sum;
+        min        = std::min(min, other.min);
+        max        = std::max(max, other.max);
+        minNonZero = std::min(minNonZero, other.minNonZero);
+        maxNonZero = std::max(maxNonZero, other.maxNonZero);
+
+        firstDataCell    = std::min(firstDataCell, other.firstDataCell);
+        firstNonZeroCell = std::min(firstNonZeroCell, other.firstNonZeroCell);
+        firstNodataCell  = std::min(firstNodataCell, other.firstNodataCell);
+    }
+};
+
+/* Computes the statistics of all the zones in one parallel pass over the cells
+ * Every chunk keeps the statistics of the zones it encountered (accumulated in a flat array of the thread),
+ * the chunk statistics are merged in chunk order so the sums do not depend on the number of threads
+ */
+template <template <typename> typename RasterType, typename T>
+std::vector<ZoneStatistics<T>> zonal_statistics(const ZoneIndex& zones, const RasterType<T>& values)
+{
+    const auto size       = values.size();
+    const auto chunkCount = int64_t((size + s_zonalChunkSize - 1) / s_zonalChunkSize);
+
+    std::vector<std::vector<std::pair<int32_t, ZoneStatistics<T>>>> chunkResults(chunkCount);
+
+#pragma omp parallel
+    {
+        std::vector<ZoneStatistics<T>> threadResult(zones.zone_count());
+        std::vector<int32_t> chunkZones;
+
+#pragma omp for schedule(static)
+        for (int64_t chunk = 0; chunk < chunkCount; ++chunk) {
+            const auto last = std::min(size, std::size_t(chunk + 1) * s_zonalChunkSize);
+            for (auto i = std::size_t(chunk) * s_zonalChunkSize; i < last; ++i) {
+                const auto zone = zones.cell_zone(i);
+                if (zone < 0) {
+                    continue;
+                }
+
+                auto& stats = threadResult[zone];
+                if (stats.count == 0 && stats.nodataCount == 0) {
+                    chunkZones.push_back(zone);
+                }
+
+                if (values.is_nodata(i)) {
+                    stats.add_nodata(int64_t(i));
+                } else {
+                    stats.add(values[i], int64_t(i));
+                }
+            }
+
+            auto& chunkResult = chunkResults[chunk];
+            chunkResult.reserve(chunkZones.size());
+            for (auto zone : chunkZones) {
+                chunkResult.emplace_back(zone, threadResult[zone]);
+                threadResult[zone] = ZoneStatistics<T>();
+            }
+            chunkZones.clear();
+        }
+    }
+
+    std::vector<ZoneStatistics<T>> result(zones.zone_count());
+    for (auto& chunkResult : chunkResults) {
+        for (auto& [zone, stats] : chunkResult) {
+            result[zone].merge(stats);
+        }
+
+        chunkResult = {};
+    }
+
+    return result;
+}
+
+/* The most occurring data value of every zone, the lowest value in case of equal counts
+ * The values are grouped per zone so the zones can be processed in parallel, zones without data values get 0
+ */
+template <template <typename> typename RasterType, typename T>
+std::vector<T> zonal_mode(const ZoneIndex& zones, const RasterType<T>& values)
+{
+    const auto size = values.size();
+
+    std::vector<std::size_t> zoneOffsets(zones.zone_count() + 1, 0);
+    for (std::size_t i = 0; i < size; ++i) {
+        if (const auto zone = zones.cell_zone(i); zone >= 0 && !values.is_nodata(i)) {
+            ++zoneOffsets[zone + 1];
+        }
+    }
+
+    for (std::size_t zone = 0; zone < zones.zone_count(); ++zone) {
+        zoneOffsets[zone + 1] += zoneOffsets[zone];
+    }
+
+    std::vector<T> zoneValues(zoneOffsets.back());
+    {
+        auto insertPosition = zoneOffsets;
+        for (std::size_t i = 0; i < size; ++i) {
+            if (const auto zone = zones.cell_zone(i); zone >= 0 && !values.is_nodata(i)) {
+                zoneValues[insertPosition[zone]++] = values[i];
+            }
+        }
+    }
+
+    std::vector<T> result(zones.zone_count(), T(0));
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t zone = 0; zone < int64_t(zones.zone_count()); ++zone) {
+        const auto first = zoneValues.begin() + zoneOffsets[zone];
+        const auto last  = zoneValues.begin() + zoneOffsets[zone + 1];
+        std::sort(first, last);
+
+        std::ptrdiff_t maxCount = 0;
+        for (auto iter = first; iter != last;) {
+            const auto runEnd = std::upper_bound(iter, last, *iter);
+            if (runEnd - iter > maxCount) {
+                maxCount     = runEnd - iter;
+                result[zone] = *iter;
+            }
+            iter = runEnd;
+        }
+    }
+
+    return result;
+}
+
+}
@@ -5,10 +5,15 @@
 #include "infra/geometry.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 #ifdef GDX_HAVE_GEOS
+#include <geos/geom/CoordinateSequence.h>
 #include <geos/geom/Geometry.h>
-#include <geos/geom/prep/PreparedGeometryFactory.h>
+#include <geos/geom/LinearRing.h>
+#include <geos/geom/Polygon.h>
 #endif
 
 #ifdef GDX_HAVE_PAR_EXECUTION
@@ -66,35 +71,192 @@ static inf::GeoMetadata create_geometry_extent(const geos::geom::Geometry& geom,
     }
 }
 
+// Covered cell fractions below this tolerance are considered empty, above 1 - tolerance as fully covered
+static constexpr double s_coverageTolerance = 1e-9;
+
+// The area contribution of a piece of a polygon ring that lies within a single cell of the polygon grid
+struct RingPieceArea
+{
+    int32_t row = 0;
+    int32_t col = 0;
+    double cellArea  = 0.0; // contribution to the cell of the piece
+    double belowArea = 0.0; // contribution to every cell below the piece in the same column
+};
+
+static double ring_area(const std::vector<Point<double>>& ring)
+{
+    double area = 0.0;
+    for (size_t i = 0; i + 1 < ring.size(); ++i) {
+        area += ring[i].x * ring[i + 1].y - ring[i + 1].x * ring[i].y;
+    }
+
+    return area / 2.0;
+}
+
+/* Walks the ring over the polygon grid, the ring coordinates are in cell units (column, row) relative to the top left of the grid.
+ * Every ring edge is split on the cell borders, by Green's theorem a piece within a cell contributes the area between the piece
+ * and the bottom of the cell to that cell and its full width to all the cells below it in the same column.
+ * The sign makes the exterior rings contribute positive and the holes negative areas, regardless of their orientation.
+ */
+static void add_ring_pieces(const std::vector<Point<double>>& ring, int32_t rows, int32_t cols, double sign, std::vector<RingPieceArea>& pieces)
+{
+    auto addPiece = [&](double u0, double v0, double u1, double v1) {
+        const double width = u1 - u0;
+        const auto col     = static_cast<int32_t>(std::floor((u0 + u1) / 2.0));
+        const auto row     = static_cast<int32_t>(std::floor((v0 + v1) / 2.0));
+        if (width == 0.0 || col < 0 || col >= cols || row >= rows) {
+            return;
+        }
+
+        if (row < 0) {
+            // above the grid, only the cells below the piece are affected
+            pieces.push_back({-1, col, 0.0, sign * width});
+        } else {
+            pieces.push_back({row, col, sign * width * (row + 1 - (v0 + v1) / 2.0), sign * width});
+        }
+    };
+
+    for (size_t i = 0; i + 1 < ring.size(); ++i) {
+        const auto& p0  = ring[i];
+        const auto& p1  = ring[i + 1];
+        const double du = p1.x - p0.x;
+        const double dv = p1.y - p0.y;
+        if (du == 0.0) {
+            // vertical edges have no area contribution
+            continue;
+        }
+
+        // the next column and row border that is crossed and the edge parameter at which it is crossed
+        double nextU = du > 0 ? std::floor(p0.x) + 1.0 : std::ceil(p0.x) - 1.0;
+        double nextV = dv > 0 ? std::floor(p0.y) + 1.0 : std::ceil(p0.y) - 1.0;
+        double tU    = (nextU - p0.x) / du;
+        double tV    = dv == 0.0 ? std::numeric_limits<double>::infinity() : (nextV - p0.y) / dv;
+
+        double t0 = 0.0;
+        double u0 = p0.x;
+        double v0 = p0.y;
+        while (t0 < 1.0) {
+            const double t1 = std::min({tU, tV, 1.0});
+            const double u1 = t1 == 1.0 ? p1.x : p0.x + t1 * du;
+            const double v1 = t1 == 1.0 ? p1.y : p0.y + t1 * dv;
+            addPiece(u0, v0, u1, v1);
+
+            if (t1 == tU) {
+                nextU += du > 0 ? 1.0 : -1.0;
+                tU = (nextU - p0.x) / du;
+            }
+
+            if (t1 == tV) {
+                nextV += dv > 0 ? 1.0 : -1.0;
+                tV = (nextV - p0.y) / dv;
+            }
+
+            t0 = t1;
+            u0 = u1;
+            v0 = v1;
+        }
+    }
+}
+
+static void add_polygon_rings(const geos::geom::Geometry& geom, const Point<double>& gridTopLeft, const Point<double>& cellSize, std::vector<std::vector<Point<double>>>& exteriorRings, std::vector<std::vector<Point<double>>>& interiorRings)
+{
+    auto toGridRing = [&](const geos::geom::LineString& ring) {
+        const auto* coords = ring.getCoordinatesRO();
+
+        std::vector<Point<double>> gridRing;
+        gridRing.reserve(coords->size());
+        for (size_t i = 0; i < coords->size(); ++i) {
+            gridRing.emplace_back((coords->getX(i) - gridTopLeft.x) / cellSize.x, (gridTopLeft.y - coords->getY(i)) / std::abs(cellSize.y));
+        }
+
+        return gridRing;
+    };
+
+    if (const auto* polygon = dynamic_cast<const geos::geom::Polygon*>(&geom); polygon != nullptr) {
+        exteriorRings.push_back(toGridRing(*polygon->getExteriorRing()));
+        for (size_t i = 0; i < polygon->getNumInteriorRing(); ++i) {
+            interiorRings.push_back(toGridRing(*polygon->getInteriorRingN(i)));
+        }
+    } else {
+        for (size_t i = 0; i < geom.getNumGeometries(); ++i) {
+            if (const auto* part = geom.getGeometryN(i); part != &geom) {
+                add_polygon_rings(*part, gridTopLeft, cellSize, exteriorRings, interiorRings);
+            }
+        }
+    }
+}
+
+/* Computes the exact covered area of the cells by walking the polygon rings over the grid instead of intersecting every cell
+ * with the polygon. Only the cells on the rings get a partial area, the contributions to the cells below them are accumulated
+ * per column so the interior cells are filled in a single sweep over the rows.
+ */
 static std::vector<PolygonCellCoverage::CellInfo> create_cell_coverages(const GeoMetadata& extent, const GeoMetadata& polygonExtent, const geos::geom::Geometry& geom)
 {
     std::vector<PolygonCellCoverage::CellInfo> result;
 
-    auto preparedGeom   = geos::geom::prep::PreparedGeometryFactory::prepare(&geom);
-    const auto cellSize = extent.cellSize;
-    const auto cellArea = std::abs(cellSize.x * cellSize.y);
-
-    auto polygonArea = preparedGeom->getGeometry().getArea();
-
-    for (auto polygonCell : gdx::RasterCells(polygonExtent.rows, polygonExtent.cols)) {
-        const Rect<double> box = polygonExtent.bounding_box(polygonCell);
-        const auto cellGeom    = geom::create_polygon(box.topLeft, box.bottomRight);
-
-        // Intersect it with the polygon
-        auto xyCentre   = polygonExtent.convert_cell_centre_to_xy(polygonCell);
-        auto outputCell = extent.convert_point_to_cell(xyCentre);
-
-        if (preparedGeom->within(cellGeom.get())) {
-            result.emplace_back(outputCell, polygonCell, 1.0, polygonArea / cellArea);
-        } else if (preparedGeom->containsProperly(cellGeom.get())) {
-            result.emplace_back(outputCell, polygonCell, cellArea / polygonArea, 1.0);
-        } else if (preparedGeom->intersects(cellGeom.get())) {
-            auto intersectGeometry   = preparedGeom->getGeometry().intersection(cellGeom.get());
-            const auto intersectArea = intersectGeometry->getArea();
-            if (intersectArea > 0) {
-                result.emplace_back(outputCell, polygonCell, intersectArea / polygonArea, intersectArea / cellArea);
+    const auto rows = polygonExtent.rows;
+    const auto cols = polygonExtent.cols;
+
+    std::vector<std::vector<Point<double>>> exteriorRings, interiorRings;
+    add_polygon_rings(geom, polygonExtent.bounding_box(Cell(0, 0)).topLeft, extent.cellSize, exteriorRings, interiorRings);
+
+    std::vector<RingPieceArea> pieces;
+    for (const auto* rings : {&exteriorRings, &interiorRings}) {
+        for (const auto& ring : *rings) {
+            const auto area = ring_area(ring);
+            if (area == 0.0) {
+                continue;
+            }
+
+            const double sign = (area > 0) == (rings == &exteriorRings) ? 1.0 : -1.0;
+            add_ring_pieces(ring, rows, cols, sign, pieces);
+        }
+    }
+
+    std::sort(pieces.begin(), pieces.end(), [](const RingPieceArea& lhs, const RingPieceArea& rhs) {
+        return lhs.row < rhs.row;
+    });
+
+    std::vector<double> belowArea(cols, 0.0);
+    std::vector<double> rowArea(cols, 0.0);
+
+    auto piece = pieces.begin();
+    for (; piece != pieces.end() && piece->row < 0; ++piece) {
+        belowArea[piece->col] += piece->belowArea;
+    }
+
+    // the area is expressed as a fraction of the cell
+    double polygonArea = 0.0;
+    for (int32_t r = 0; r < rows; ++r) {
+        const auto rowPieces = piece;
+        for (; piece != pieces.end() && piece->row == r; ++piece) {
+            rowArea[piece->col] += piece->cellArea;
+        }
+
+        for (int32_t c = 0; c < cols; ++c) {
+            auto area = belowArea[c] + rowArea[c];
+            if (area <= s_coverageTolerance) {
+                continue;
             }
+
+            if (area >= 1.0 - s_coverageTolerance) {
+                area = 1.0;
+            }
+
+            const Cell polygonCell(r, c);
+            const auto outputCell = extent.convert_point_to_cell(polygonExtent.convert_cell_centre_to_xy(polygonCell));
+            result.emplace_back(outputCell, polygonCell, 0.0, area);
+            polygonArea += area;
         }
+
+        for (auto iter = rowPieces; iter != piece; ++iter) {
+            belowArea[iter->col] += iter->belowArea;
+            rowArea[iter->col] = 0.0;
+        }
+    }
+
+    for (auto& cell : result) {
+        cell.coverage = cell.cellCoverage / polygonArea;
     }
 
     return result;
@@ -61,6 +61,31 @@ TEST_CASE("AccufluxTest.AccufluxNANValues")
     CHECK_RASTER_NEAR(expected, result);
 }
 
+TEST_CASE("AccufluxTest.AccufluxLongFlowPath")
+{
+    // serpentine flow path through the entire map ending in a single pit
+    const int32_t rows = 50;
+    const int32_t cols = 40;
+    RasterMetadata meta(rows, cols);
+
+    MaskedRaster<uint8_t> lddMap(meta);
+    MaskedRaster<float> expected(meta);
+
+    float pathIndex = 1;
+    for (int32_t r = 0; r < rows; ++r) {
+        const bool eastward = r % 2 == 0;
+        for (int32_t i = 0; i < cols; ++i) {
+            const int32_t c = eastward ? i : cols - 1 - i;
+            lddMap(r, c)   = i == cols - 1 ? 2 : (eastward ? 6 : 4);
+            expected(r, c) = pathIndex++;
+        }
+    }
+    lddMap(rows - 1, 0) = 5;
+
+    MaskedRaster<float> freightMap(meta, 1);
+    CHECK_RASTER_EQ(expected, accuflux(lddMap, freightMap));
+}
+
 TEST_CASE("AccufluxTest.AccufluxFailsLddLoop")
 {
     RasterMetadata meta(4, 4);
@@ -2,6 +2,10 @@
 #include "gdx/test/testbase.h"
 #include "testconfig.h"
 
+#include <map>
+#include <random>
+#include <set>
+
 namespace gdx::test {
 
 TEST_CASE_TEMPLATE("Category", TypeParam, UnspecializedRasterTypes)
@@ -111,5 +115,61 @@ TEST_CASE_TEMPLATE("Category", TypeParam, UnspecializedRasterTypes)
         CHECK(actual.metadata() == expected.metadata());
         CHECK_RASTER_NEAR_WITH_TOLERANCE(expected, actual, 1e-5);
     }
+
+    SUBCASE("categorySumInBuffer compared with the sum over every circle")
+    {
+        // a radius of 2.5 cells: the circle spans 5 rows and its rows have different widths
+        RasterMetadata bufferMeta(30, 25, 0.0, 0.0, 100.0, -9999.0);
+        const float radiusInCells = 2.5f;
+        const int32_t radiusSqr   = int32_t(radiusInCells * radiusInCells);
+
+        std::mt19937 rng(7);
+        IntRaster clusters(bufferMeta, 0);
+        FloatRaster values(bufferMeta, 0.f);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            clusters[i] = rng() % 4 == 0 ? int32_t(rng() % 5) : 0;
+            values[i]   = float(rng() % 4);
+            if (rng() % 10 == 0) {
+                clusters.mark_as_nodata(i);
+                values.mark_as_nodata(i);
+            }
+        }
+
+        std::map<int32_t, double> sums;
+        for (int32_t r = 0; r < bufferMeta.rows; ++r) {
+            for (int32_t c = 0; c < bufferMeta.cols; ++c) {
+                if (values.is_nodata(r, c)) {
+                    continue;
+                }
+
+                std::set<int32_t> ids;
+                for (int32_t rr = 0; rr < bufferMeta.rows; ++rr) {
+                    for (int32_t cc = 0; cc < bufferMeta.cols; ++cc) {
+                        const auto dr = rr - r;
+                        const auto dc = cc - c;
+                        if (!clusters.is_nodata(rr, cc) && clusters(rr, cc) != 0 && dr * dr + dc * dc <= radiusSqr) {
+                            ids.insert(clusters(rr, cc));
+                        }
+                    }
+                }
+
+                for (auto id : ids) {
+                    sums[id] += values(r, c);
+                }
+            }
+        }
+
+        FloatRaster expected(bufferMeta, 0.f);
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            if (values.is_nodata(i)) {
+                expected.mark_as_nodata(i);
+            } else if (clusters[i] != 0) {
+                expected[i] = float(sums[clusters[i]]);
+            }
+        }
+
+        FloatRaster actual = gdx::category_sum_in_buffer(clusters, values, radiusInCells * float(bufferMeta.cellSize.x));
+        CHECK_RASTER_NEAR_WITH_TOLERANCE(expected, actual, 1e-3);
+    }
 }
 }
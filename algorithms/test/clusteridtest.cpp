@@ -44,6 +44,31 @@ TEST_CASE_TEMPLATE("cluster_id", TypeParam, UnspecializedRasterTypes)
         CHECK_RASTER_EQ(expected, cluster_id(ras, ClusterDiagonals::Exclude));
     }
 
+    SUBCASE("cluster_id_diagonal_line_over_many_rows")
+    {
+        // diagonal line and a vertical line that are long enough to cross multiple labelling blocks
+        RasterMetadata lineMeta(200, 201);
+        IntRaster ras(lineMeta, 0);
+        for (int32_t r = 0; r < lineMeta.rows; ++r) {
+            ras(r, r)   = 1;
+            ras(r, 200) = 2;
+        }
+
+        IntRaster expectedInclude(lineMeta, 0);
+        IntRaster expectedExclude(lineMeta, 0);
+        for (int32_t r = 0; r < lineMeta.rows; ++r) {
+            expectedInclude(r, r)   = 1;
+            expectedInclude(r, 200) = 2;
+
+            // without diagonals every cell of the diagonal line is a separate cluster
+            expectedExclude(r, r)   = r == 0 ? 1 : r + 2;
+            expectedExclude(r, 200) = 2;
+        }
+
+        CHECK_RASTER_EQ(expectedInclude, cluster_id(ras, ClusterDiagonals::Include));
+        CHECK_RASTER_EQ(expectedExclude, cluster_id(ras, ClusterDiagonals::Exclude));
+    }
+
     SUBCASE("fuzzy_cluster_id")
     {
         RasterMetadata meta(10, 10);
@@ -76,6 +101,97 @@ TEST_CASE_TEMPLATE("cluster_id", TypeParam, UnspecializedRasterTypes)
         CHECK_RASTER_EQ(expected, fuzzy_cluster_id(ras, 1.42f * static_cast<float>(meta.cellSize.x)));
     }
 
+    SUBCASE("fuzzy_cluster_id large radius")
+    {
+        // compared with the cells that are reachable from the first cell of every cluster within the radius
+        // the 4 cell tiles give 38 tile rows, so the clusters are linked over the borders of the 16 tile row blocks
+        RasterMetadata meta(150, 55);
+        meta.set_cell_size(10.0);
+        const float radius = 4.7f;
+
+        std::mt19937 rng(3);
+        FloatRaster ras(meta, 0.f);
+        for (size_t i = 0; i < ras.size(); ++i) {
+            ras[i] = (rng() % 40 == 0) ? 1.f : 0.f;
+        }
+
+        IntRaster expected(meta, 0);
+        int32_t clusterId = 0;
+        for (int32_t r = 0; r < meta.rows; ++r) {
+            for (int32_t c = 0; c < meta.cols; ++c) {
+                if (ras(r, c) == 0 || expected(r, c) != 0) {
+                    continue;
+                }
+
+                expected(r, c) = ++clusterId;
+                std::vector<Cell> todo = {Cell(r, c)};
+                while (!todo.empty()) {
+                    const auto cell = todo.back();
+                    todo.pop_back();
+                    for (int32_t rr = 0; rr < meta.rows; ++rr) {
+                        for (int32_t cc = 0; cc < meta.cols; ++cc) {
+                            const auto dr = rr - cell.r;
+                            const auto dc = cc - cell.c;
+                            if (ras(rr, cc) > 0 && expected(rr, cc) == 0 && dr * dr + dc * dc <= int(radius * radius)) {
+                                expected(rr, cc) = clusterId;
+                                todo.push_back(Cell(rr, cc));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        CHECK_RASTER_EQ(expected, fuzzy_cluster_id(ras, radius * static_cast<float>(meta.cellSize.x)));
+    }
+
+    SUBCASE("fuzzy_cluster_id_with_obstacles")
+    {
+        RasterMetadata meta(7, 8);
+        meta.set_cell_size(10.0);
+        meta.nodata = -1;
+
+        // the wall in column 3 separates the item cells at (2, 2) and (2, 4), but the area below it connects both sides,
+        // the wall in row 5 creates a second background area
+        IntRaster items(meta, std::vector<int32_t>{
+                                  1, 0, 1, 0, 0, 2, 0, 2,
+                                  0, 0, 0, 1, 0, 0, 0, 0,
+                                  1, 0, 1, 0, 1, 0, 2, 2,
+                                  0, 0, 0, 0, 0, 0, 0, 0,
+                                  1, 1, 0, 0, 1, 0, 0, 2,
+                                  0, 0, 0, 0, 0, 0, 0, 0,
+                                  1, 0, 1, 0, 0, 0, 2, 2});
+
+        // the nodata cell would link the item 2 cells above and below it
+        items.mark_as_nodata(Cell(2, 7));
+
+        RasterMetadata obstacleMeta(7, 8);
+        obstacleMeta.set_cell_size(10.0);
+        const ByteRaster obstacles(obstacleMeta, std::vector<uint8_t>{
+                                                     0, 0, 0, 1, 0, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0, 0,
+                                                     0, 0, 0, 0, 0, 0, 0, 0,
+                                                     1, 1, 1, 1, 1, 1, 1, 1,
+                                                     0, 0, 0, 0, 0, 0, 0, 0});
+
+        // the item on the obstacle gets its own id, cells without items are nodata
+        const int32_t n = -9999;
+        auto expectedMeta   = meta;
+        expectedMeta.nodata = n;
+        const IntRaster expected(expectedMeta, std::vector<int32_t>{
+                                                   1, n, 1, n, n, 2, n, 2,
+                                                   n, n, n, 3, n, n, n, n,
+                                                   1, n, 1, n, 4, n, 5, n,
+                                                   n, n, n, n, n, n, n, n,
+                                                   1, 1, n, n, 4, n, n, 6,
+                                                   n, n, n, n, n, n, n, n,
+                                                   7, n, 7, n, n, n, 8, 8});
+
+        CHECK_RASTER_EQ(expected, fuzzy_cluster_id_with_obstacles(items, obstacles, 2.f * static_cast<float>(meta.cellSize.x)));
+    }
+
     SUBCASE("cluster_id_with_obstacles")
     {
         IntRaster categories, expected;
@@ -89,4 +205,79 @@ TEST_CASE_TEMPLATE("cluster_id", TypeParam, UnspecializedRasterTypes)
         CHECK_RASTER_EQ(expected, res);
     }
 }
+
+TEST_CASE("Cell queue")
+{
+    const int32_t rows = 300;
+    const int32_t cols = 400;
+    FiLo<Cell> queue(rows, cols);
+
+    // the frontier never holds more than 100 cells, so only a couple of chunks are allocated
+    int32_t popped = 0;
+    for (int32_t r = 0; r < rows; ++r) {
+        for (int32_t c = 0; c < cols; ++c) {
+            queue.push_back(Cell(r, c));
+            if (queue.size() > 100) {
+                CHECK(queue.pop_head() == Cell(popped / cols, popped % cols));
+                ++popped;
+            }
+        }
+    }
+
+    const auto allocated = queue.allocated_bytes();
+    CHECK(allocated < size_t(rows) * cols * sizeof(Cell) / 5);
+
+    while (!queue.empty()) {
+        CHECK(queue.pop_head() == Cell(popped / cols, popped % cols));
+        ++popped;
+    }
+    CHECK(popped == rows * cols);
+
+    // a full raster frontier spans multiple chunks, reusing the queue afterwards takes the chunks from the pool
+    for (int32_t i = 0; i < rows * cols; ++i) {
+        queue.push_back(Cell(i / cols, i % cols));
+    }
+
+    const auto allocatedFull = queue.allocated_bytes();
+    queue.clear();
+    CHECK(queue.empty());
+
+    for (int32_t i = 0; i < rows * cols; ++i) {
+        queue.push_back(Cell(i / cols, i % cols));
+    }
+    CHECK(queue.size() == rows * cols);
+    CHECK(queue.allocated_bytes() == allocatedFull);
+    CHECK(queue.pop_head() == Cell(0, 0));
+}
+
+TEST_CASE("Mark grid")
+{
+    // odd dimensions so the last byte is only partially used
+    MarkGrid mark(7, 9, s_markTodo);
+
+    for (int32_t r = 0; r < 7; ++r) {
+        for (int32_t c = 0; c < 9; ++c) {
+            mark(r, c) = uint8_t((r + c) % 3);
+        }
+    }
+
+    for (int32_t r = 0; r < 7; ++r) {
+        for (int32_t c = 0; c < 9; ++c) {
+            CHECK(mark(r, c) == (r + c) % 3);
+            CHECK(mark[Cell(r, c)] == (r + c) % 3);
+            CHECK(mark[size_t(r * 9 + c)] == (r + c) % 3);
+        }
+    }
+
+    // the cells that share the byte keep their state
+    mark[Cell(3, 4)] = s_markTodo;
+    CHECK(mark(3, 3) == 0);
+    CHECK(mark(3, 4) == s_markTodo);
+    CHECK(mark(3, 5) == 2);
+
+    mark.fill(s_markBorder);
+    for (size_t i = 0; i < 7 * 9; ++i) {
+        CHECK(mark[i] == s_markBorder);
+    }
+}
 }
@@ -58,6 +58,64 @@ TEST_CASE_TEMPLATE("distance", TypeParam, UnspecializedRasterTypes)
         CHECK_RASTER_NEAR_WITH_TOLERANCE(expected, actual, 1e-4);
     }
 
+    SUBCASE("euclidean distance")
+    {
+        auto targetsMeta   = meta;
+        targetsMeta.nodata = 255;
+        ByteRaster targets(targetsMeta, std::vector<uint8_t>{
+                                            0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            1, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            3, 0, 0, 1, 0, 0, 0, 0, 0, 0,
+                                            0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+
+        FloatRaster expected(meta, std::vector<float>{
+                                       200.f, 200.f, 223.607f, 282.843f, 316.228f, 360.555f, 424.264f, 500.f, 583.095f, 670.820f,
+                                       100.f, 100.f, 141.421f, 200.f, 223.607f, 282.843f, 360.555f, 447.214f, 538.516f, 632.456f,
+                                       0.f, 0.f, 100.f, 100.f, 141.421f, 223.607f, 316.228f, 412.311f, 509.902f, 608.276f,
+                                       0.f, 100.f, 100.f, 0.f, 100.f, 200.f, 300.f, 400.f, 500.f, 600.f,
+                                       100.f, 141.421f, 141.421f, 100.f, 141.421f, 223.607f, 316.228f, 412.311f, 509.902f, 608.276f});
+
+        auto actual = distance(targets, DistanceMethod::Euclidean);
+
+        CHECK_RASTER_NEAR_WITH_TOLERANCE(expected, actual, 1e-4);
+    }
+
+    SUBCASE("euclidean closest target")
+    {
+        // the nodata cell does not block the path to the nearest target
+        using IntRaster = typename TypeParam::template type<int32_t>;
+
+        RasterMetadata targetsMeta(5, 10, -1);
+        IntRaster targets(targetsMeta, std::vector<int32_t>{
+                                           4, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                           0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                           0, 0, 0, 0, 0, 0, 0, -1, 0, 0,
+                                           0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                           0, 0, 0, 0, 0, 0, 0, 0, 0, 7});
+
+        const IntRaster expected(targetsMeta.rows, targetsMeta.cols, std::vector<int32_t>{
+                                                                         4, 4, 4, 4, 4, 4, 7, 7, 7, 7,
+                                                                         4, 4, 4, 4, 4, 7, 7, 7, 7, 7,
+                                                                         4, 4, 4, 4, 4, 7, 7, 7, 7, 7,
+                                                                         4, 4, 4, 4, 4, 7, 7, 7, 7, 7,
+                                                                         4, 4, 4, 4, 7, 7, 7, 7, 7, 7});
+
+        CHECK_RASTER_EQ(expected, closest_target(targets, DistanceMethod::Euclidean));
+
+        FloatRaster values(RasterMetadata(5, 10), 1.f);
+        values(4, 9) = 2.f;
+
+        const FloatRaster expectedValues(RasterMetadata(5, 10), std::vector<float>{
+                                                                    1, 1, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                                    1, 1, 1, 1, 1, 2, 2, 2, 2, 2,
+                                                                    1, 1, 1, 1, 1, 2, 2, 2, 2, 2,
+                                                                    1, 1, 1, 1, 1, 2, 2, 2, 2, 2,
+                                                                    1, 1, 1, 1, 2, 2, 2, 2, 2, 2});
+
+        CHECK_RASTER_EQ(expectedValues, value_at_closest_target(targets, values, DistanceMethod::Euclidean));
+    }
+
     SUBCASE("with obstacles")
     {
         auto targetsMeta   = meta;
@@ -185,5 +243,28 @@ TEST_CASE_TEMPLATE("distance", TypeParam, UnspecializedRasterTypes)
             CHECK_RASTER_NEAR_WITH_TOLERANCE(expected, actual, 1e-4);
         }
     }
+
+    SUBCASE("travel distance")
+    {
+        RasterMetadata travelMeta(3, 5, nan);
+
+        ByteRaster targets(RasterMetadata(3, 5, 255), std::vector<uint8_t>{
+                                                          0, 0, 0, 0, 0,
+                                                          1, 0, 0, 0, 0,
+                                                          0, 0, 0, 0, 0});
+
+        FloatRaster travelTime(travelMeta, std::vector<float>{
+                                               1.f, 1.f, 1.f, 1.f, 1.f,
+                                               1.f, 9.f, 9.f, 9.f, 1.f,
+                                               1.f, 1.f, nan, 1.f, 1.f});
+
+        FloatRaster expected(travelMeta, std::vector<float>{
+                                             1.f, 1.41421f, 2.41421f, 3.41421f, 4.41421f,
+                                             0.f, 9.f, 11.4142f, 12.4142f, 4.82843f,
+                                             1.f, 1.41421f, nan, 6.24264f, 5.82843f});
+
+        auto actual = travel_distance(targets, travelTime);
+        CHECK_RASTER_NEAR_WITH_TOLERANCE(expected, actual, 1e-4);
+    }
 }
 }
@@ -65,5 +65,137 @@ TEST_CASE_TEMPLATE("filter", TypeParam, RasterFloatTypes)
         auto actual = average_filter_square<Raster>(ras, 1);
         CHECK_RASTER_NEAR(expected, actual);
     }
+
+    SUBCASE("filterLargeRadius")
+    {
+        // large enough radius to use the fft implementation, compared with the weighted sum of the neighbours
+        const int radius = 9;
+
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> dist(0, 20);
+
+        Raster ras(RasterMetadata(30, 45, -1.0), T(0));
+        for (int32_t r = 0; r < ras.rows(); ++r) {
+            for (int32_t c = 0; c < ras.cols(); ++c) {
+                // leave the top left corner empty so it remains nodata
+                if ((r < 10 && c < 10) || dist(rng) == 0) {
+                    ras.mark_as_nodata(r, c);
+                } else {
+                    ras(r, c) = T(dist(rng));
+                }
+            }
+        }
+
+        for (auto mode : {FilterMode::Linear, FilterMode::Exponential, FilterMode::Exponential2}) {
+            Raster expected(ras.metadata(), T(0));
+            for (int32_t r = 0; r < ras.rows(); ++r) {
+                for (int32_t c = 0; c < ras.cols(); ++c) {
+                    double weightedSum = 0.0;
+                    bool hasData       = false;
+                    for (int32_t rr = std::max(0, r - radius); rr <= std::min(ras.rows() - 1, r + radius); ++rr) {
+                        for (int32_t cc = std::max(0, c - radius); cc <= std::min(ras.cols() - 1, c + radius); ++cc) {
+                            const double dSqr = (rr - r) * (rr - r) + (cc - c) * (cc - c);
+                            if (dSqr <= radius * radius && !ras.is_nodata(rr, cc)) {
+                                weightedSum += ras(rr, cc) * detail::filter_weight(mode, radius, dSqr);
+                                hasData = true;
+                            }
+                        }
+                    }
+
+                    if (hasData) {
+                        expected(r, c) = T(weightedSum);
+                    } else {
+                        expected.mark_as_nodata(r, c);
+                    }
+                }
+            }
+
+            CHECK_RASTER_NEAR_WITH_TOLERANCE(expected, filter<Raster>(ras, mode, radius, false), 1e-3);
+        }
+    }
+}
+
+TEST_CASE_TEMPLATE("filter integer output", TypeParam, RasterIntTypes)
+{
+    using T      = typename TypeParam::value_type;
+    using Raster = typename TypeParam::raster;
+
+    // the weighted sum of every output cell is truncated once, not every spread value
+    SUBCASE("single value")
+    {
+        // radius 7 uses the fft implementation, the center keeps the exact value
+        const int radius = 7;
+        Raster ras(RasterMetadata(21, 21, -1.0), T(0));
+        ras(10, 10) = T(5);
+
+        const auto actual = filter<Raster>(ras, FilterMode::Linear, radius, false);
+        for (int32_t r = 0; r < ras.rows(); ++r) {
+            for (int32_t c = 0; c < ras.cols(); ++c) {
+                const double dSqr = (r - 10) * (r - 10) + (c - 10) * (c - 10);
+                const double expected = dSqr <= radius * radius ? 5 * detail::filter_weight(FilterMode::Linear, radius, dSqr) : 0.0;
+                CHECK(actual(r, c) == T(expected));
+            }
+        }
+        CHECK(actual(10, 10) == T(5));
+    }
+
+    SUBCASE("compared with the truncated weighted sum")
+    {
+        std::mt19937 rng(9);
+        std::uniform_int_distribution<int> dist(0, 30);
+
+        Raster ras(RasterMetadata(25, 30, -1.0), T(0));
+        for (std::size_t i = 0; i < ras.size(); ++i) {
+            if (dist(rng) == 0) {
+                ras.mark_as_nodata(i);
+            } else {
+                ras[i] = T(dist(rng));
+            }
+        }
+
+        // the kernel weight sum within the raster of every input cell
+        auto weightSum = [&](int32_t r, int32_t c, int radius, FilterMode mode) {
+            double sum = 0.0;
+            for (int32_t rr = std::max(0, r - radius); rr <= std::min(ras.rows() - 1, r + radius); ++rr) {
+                for (int32_t cc = std::max(0, c - radius); cc <= std::min(ras.cols() - 1, c + radius); ++cc) {
+                    const double dSqr = (rr - r) * (rr - r) + (cc - c) * (cc - c);
+                    if (dSqr <= radius * radius) {
+                        sum += detail::filter_weight(mode, radius, dSqr);
+                    }
+                }
+            }
+            return sum;
+        };
+
+        for (int radius : {2, 7}) {
+            for (bool normalize : {false, true}) {
+                CAPTURE(radius);
+                CAPTURE(normalize);
+
+                const auto actual = filter<Raster>(ras, FilterMode::Linear, radius, normalize);
+                for (int32_t r = 0; r < ras.rows(); ++r) {
+                    for (int32_t c = 0; c < ras.cols(); ++c) {
+                        double weightedSum = 0.0;
+                        for (int32_t rr = std::max(0, r - radius); rr <= std::min(ras.rows() - 1, r + radius); ++rr) {
+                            for (int32_t cc = std::max(0, c - radius); cc <= std::min(ras.cols() - 1, c + radius); ++cc) {
+                                const double dSqr = (rr - r) * (rr - r) + (cc - c) * (cc - c);
+                                if (dSqr <= radius * radius && !ras.is_nodata(rr, cc)) {
+                                    const double factor = normalize ? weightSum(rr, cc, radius, FilterMode::Linear) : 1.0;
+                                    weightedSum += ras(rr, cc) * detail::filter_weight(FilterMode::Linear, radius, dSqr) / factor;
+                                }
+                            }
+                        }
+
+                        // sums within the rounding error of an integer can end up on either side of it
+                        if (std::abs(weightedSum - std::round(weightedSum)) < 1e-6) {
+                            CHECK(std::abs(double(actual(r, c)) - std::round(weightedSum)) <= 1.0);
+                        } else {
+                            CHECK(actual(r, c) == T(weightedSum));
+                        }
+                    }
+                }
+            }
+        }
+    }
 }
 }
@@ -78,4 +78,44 @@ TEST_CASE("Majority filter float")
     auto result = majority_filter(raster, 142.0);
     CHECK_RASTER_EQ(expected, result);
 }
+
+TEST_CASE("Majority filter sliding window matches the full window")
+{
+    RasterMetadata meta(40, 55, -9999);
+    meta.set_cell_size(100.0);
+
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<int32_t> dist(0, 5);
+
+    MaskedRaster<int32_t> raster(meta, 0);
+    for (int32_t r = 0; r < meta.rows; ++r) {
+        for (int32_t c = 0; c < meta.cols; ++c) {
+            // values 0 to 4, 5 becomes nodata
+            if (auto value = dist(rng); value == 5) {
+                raster.mark_as_nodata(r, c);
+            } else {
+                raster(r, c) = value;
+            }
+        }
+    }
+
+    for (float radius : {100.f, 142.f, 350.f}) {
+        const auto radiusInCells  = static_cast<int32_t>(radius / 100.f);
+        const auto radiusInCells2 = static_cast<int32_t>((radius / 100.f) * (radius / 100.f));
+
+        MaskedRaster<int32_t> expected(meta);
+        std::map<int32_t, int32_t> count;
+        for (int32_t r = 0; r < meta.rows; ++r) {
+            for (int32_t c = 0; c < meta.cols; ++c) {
+                if (auto majority = compute_majority(Cell(r, c), raster, radiusInCells, radiusInCells2, meta, count); majority.has_value()) {
+                    expected(r, c) = *majority;
+                } else {
+                    expected.mark_as_nodata(r, c);
+                }
+            }
+        }
+
+        CHECK_RASTER_EQ(expected, majority_filter(raster, radius));
+    }
+}
 }
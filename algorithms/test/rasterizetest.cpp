@@ -109,5 +109,62 @@ TEST_CASE_TEMPLATE("RasterizePolygons", TypeParam, UnspecializedRasterTypes)
         CHECK(actual.metadata() == expected.metadata());
         CHECK_RASTER_NEAR_WITH_TOLERANCE(expected, actual, 1e-5f);
     }
+
+    SUBCASE("rasterize_polygon_partial_coverage")
+    {
+        // Json with polygons that partially cover the cells of the 2x2 grid
+        // - Polygon 1: triangle below the diagonal, covering the bottom right pixel and half of the top right and bottom left pixels
+        // - Polygon 2: the full grid with a hole in the center, covering 3/4 of every pixel
+
+        const char* geoJson = R"json(
+        {
+          "type": "FeatureCollection",
+          "features": [
+            {
+              "type": "Feature",
+              "properties": {
+                "prop1": 8.0
+              },
+              "geometry": {
+                "coordinates": [ [ [0, 0], [200, 0], [200, 200], [0, 0] ] ],
+                "type": "Polygon"
+              }
+            },
+            {
+              "type": "Feature",
+              "properties": {
+                "prop1": 12.0
+              },
+              "geometry": {
+                "coordinates": [ [ [0, 0], [200, 0], [200, 200], [0, 200], [0, 0] ], [ [50, 50], [50, 150], [150, 150], [150, 50], [50, 50] ] ],
+                "type": "Polygon"
+              }
+            }
+          ],
+          "crs": {
+            "type": "name",
+            "properties": {
+              "name": "urn:ogc:def:crs:EPSG:31370"
+            }
+          }
+        }
+        )json";
+
+        RasterizePolygonOptions opts;
+        opts.outputMeta = RasterMetadata(2, 2, 0.0, 0.0, 100.0, -9999.0);
+        opts.outputMeta.set_projection_from_epsg(crs::epsg::BelgianLambert72);
+        opts.burnValue = "prop1";
+
+        DoubleRaster expected(opts.outputMeta, std::vector<double>{
+                                                   12.0 / 4.0, 12.0 / 4.0 + 8.0 / 4.0,
+                                                   12.0 / 4.0 + 8.0 / 4.0, 12.0 / 4.0 + 8.0 / 2.0});
+
+        auto jsonPath = fs::u8path(geoJson);
+        auto ds       = gdal::VectorDataSet::open(jsonPath, gdal::VectorType::GeoJson);
+        auto actual   = gdx::rasterize_polygons<DoubleRaster>(ds, opts);
+
+        CHECK(actual.metadata() == expected.metadata());
+        CHECK_RASTER_NEAR_WITH_TOLERANCE(expected, actual, 1e-5f);
+    }
 }
 }
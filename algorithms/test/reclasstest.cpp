@@ -189,6 +189,35 @@ nan	nan	30
         CHECK_RASTER_EQ(expected, std::get<IntRaster>(result_variant));
     }
 
+    SUBCASE("reclassLargeKeyDomain")
+    {
+        // the key values are too far apart for the dense lookup table, the first matching mapping row is used
+        const std::vector<std::vector<int32_t>> map({{1, 5000000, 10},
+            {-9999, 7, 20},
+            {1, 5000000, 30},
+            {2000000, 7, 40},
+            {-3000000, -9999, -9999}});
+
+        RasterMetadata meta(2, 3);
+        meta.nodata = -1;
+
+        const IntRaster ras1(meta, std::vector<int32_t>{
+                                       1, -1, 2000000,
+                                       -3000000, 1, 2000000});
+
+        const IntRaster ras2(meta, std::vector<int32_t>{
+                                       5000000, 7, 7,
+                                       -1, 7, 5000000});
+
+        auto expectedMeta   = meta;
+        expectedMeta.nodata = -9999;
+        const IntRaster expected(expectedMeta, std::vector<int32_t>{
+                                                   10, 20, 40,
+                                                   -9999, -9999, -9999});
+
+        CHECK_RASTER_EQ(expected, reclass_to<int32_t>(map, ras1, ras2));
+    }
+
     SUBCASE("reclassWarningNoMappingAvailableForRasterValue5")
     {
         const std::vector<std::vector<int32_t>> map({{0, 0},
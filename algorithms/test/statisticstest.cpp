@@ -0,0 +1,131 @@
+#include "gdx/algo/statistics.h"
+#include "gdx/test/testbase.h"
+
+namespace gdx::test {
+
+TEST_CASE_TEMPLATE("Statistics", TypeParam, RasterTypes)
+{
+    using T      = typename TypeParam::value_type;
+    using Raster = typename TypeParam::raster;
+
+    SUBCASE("statistics over multiple chunks")
+    {
+        // 280000 cells: one full chunk of 2^18 cells and a partial one, so the histograms and extremes of both are merged
+        RasterMetadata meta(700, 400);
+        meta.nodata = -1;
+
+        Raster ras(meta, T(0));
+        for (std::size_t i = 0; i < ras.size(); ++i) {
+            if (i % 13 == 0) {
+                ras.mark_as_nodata(i);
+            } else {
+                ras[i] = static_cast<T>(int64_t(i * 7919 % 1500) - 200);
+            }
+        }
+
+        RasterStats<1024> expected;
+        for (std::size_t i = 0; i < ras.size(); ++i) {
+            if (ras.is_nodata(i)) {
+                ++expected.noDataValues;
+                continue;
+            }
+
+            const double value = ras[i];
+            if (value != 0) {
+                ++expected.nonZeroValues;
+            } else {
+                ++expected.zeroValues;
+            }
+
+            expected.sum += value;
+            expected.highestValue = std::max(expected.highestValue, value);
+            expected.lowestValue  = std::min(expected.lowestValue, value);
+
+            if (value < 0) {
+                ++expected.negativeValues;
+            } else if (value > 1000) {
+                ++expected.countHigh;
+            } else {
+                ++expected.histogram[size_t(value)];
+            }
+        }
+
+        auto stats = statistics(ras, 1000);
+        CHECK(stats.noDataValues == expected.noDataValues);
+        CHECK(stats.zeroValues == expected.zeroValues);
+        CHECK(stats.nonZeroValues == expected.nonZeroValues);
+        CHECK(stats.negativeValues == expected.negativeValues);
+        CHECK(stats.countHigh == expected.countHigh);
+        CHECK(stats.nanValues == 0);
+        CHECK(stats.highestValue == expected.highestValue);
+        CHECK(stats.lowestValue == expected.lowestValue);
+        CHECK(stats.sum == Approx(expected.sum));
+        CHECK(stats.histogram == expected.histogram);
+    }
+
+    SUBCASE("sum and standard deviation match the serial path")
+    {
+        RasterMetadata meta(700, 400);
+        meta.nodata = -1;
+
+        Raster ras(meta, T(0));
+        MaskedRaster<T> serial(meta, T(0));
+        for (std::size_t i = 0; i < ras.size(); ++i) {
+            if (i % 11 == 0) {
+                ras.mark_as_nodata(i);
+                serial.mark_as_nodata(i);
+            } else {
+                // fractional values for the floating point types so the order of the float operations matters
+                ras[i]    = static_cast<T>(double(i * 7919 % 1500) + (std::is_floating_point_v<T> ? double(i % 7) / 3.0 : 0.0));
+                serial[i] = ras[i];
+            }
+        }
+
+        double sum          = 0.0;
+        double sumOfSquares = 0.0;
+        std::size_t count   = 0;
+        for (std::size_t i = 0; i < ras.size(); ++i) {
+            if (!ras.is_nodata(i) && ras[i] != 0) {
+                const double value = ras[i];
+                sum += value;
+                sumOfSquares += value * value;
+                ++count;
+            }
+        }
+
+        const double mean   = sum / count;
+        const double stddev = std::sqrt((sumOfSquares / count - mean * mean) / ((count - 1.0) / count));
+
+        auto stats       = statistics(ras, 1000);
+        auto serialStats = statistics(serial, 1000);
+        CHECK(stats.sum == serialStats.sum);
+        CHECK(stats.sigmaNonZero == serialStats.sigmaNonZero);
+        CHECK(stats.sum == Approx(sum));
+        CHECK(stats.sigmaNonZero == Approx(stddev));
+    }
+
+    SUBCASE("unique raster values")
+    {
+        RasterMetadata meta(3, 4);
+        meta.nodata = -1;
+
+        const Raster ras(meta, convertTo<T>(std::vector<double>({1, 5, 5, -1,
+                                                                 3, 1, -1, 7,
+                                                                 7, 7, 3, 5})));
+
+        CHECK(unique_raster_values_set(ras) == std::set<T>({1, 3, 5, 7}));
+        CHECK(unique_raster_values(ras).size() == 4);
+    }
+}
+
+TEST_CASE("Unique raster values of small integral types")
+{
+    RasterMetadata meta(2, 4);
+    meta.nodata = 100;
+
+    const MaskedRaster<int16_t> ras(meta, std::vector<int16_t>{-300, 100, 5, -300,
+                                                                 32767, -32768, 5, 0});
+
+    CHECK(unique_raster_values_set(ras) == std::set<int16_t>({-32768, -300, 0, 5, 32767}));
+}
+}
@@ -1,6 +1,8 @@
 #include "gdx/algo/suminbuffer.h"
 #include "gdx/test/testbase.h"
 
+#include <random>
+
 namespace gdx::test {
 
 TEST_CASE_TEMPLATE("Sum in buffer", TypeParam, RasterTypes)
@@ -58,5 +60,108 @@ TEST_CASE_TEMPLATE("Sum in buffer", TypeParam, RasterTypes)
 
         CHECK_RASTER_EQ(expected, actual);
     }
+
+    SUBCASE("minInBuffer")
+    {
+        MaskedRaster<float> expected(meta, std::vector<float>{
+                                               2.f, 2.f, 4.f, 4.f,
+                                               2.f, 4.f, 4.f, 4.f,
+                                               2.f, 2.f, 4.f, 7.f,
+                                               2.f, 4.f, 4.f, -5.f,
+                                               3.f, 3.f, -5.f, -5.f});
+
+        auto actual = min_in_buffer(raster, 5.f);
+
+        CHECK_RASTER_EQ(expected, actual);
+    }
+}
+
+TEST_CASE("Sum in buffer over multiple row strips")
+{
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int32_t> dist(0, 10);
+
+    // the single column raster slides the circle down the rows within a strip
+    for (auto [rows, cols] : {std::pair(70, 23), std::pair(45, 1)}) {
+        RasterMetadata meta(rows, cols, -100);
+        meta.set_cell_size(10.0);
+
+        MaskedRaster<int32_t> raster(meta, 0);
+        for (size_t i = 0; i < raster.size(); ++i) {
+            if (auto value = dist(rng); value == 10) {
+                raster.mark_as_nodata(i);
+            } else {
+                raster[i] = value;
+            }
+        }
+
+        const int32_t radius = 3;
+        MaskedRaster<int32_t> expected(meta, 0);
+        for (int32_t r = 0; r < rows; ++r) {
+            for (int32_t c = 0; c < cols; ++c) {
+                for (int32_t rr = 0; rr < rows; ++rr) {
+                    for (int32_t cc = 0; cc < cols; ++cc) {
+                        if ((rr - r) * (rr - r) + (cc - c) * (cc - c) <= radius * radius && !raster.is_nodata(rr, cc)) {
+                            expected(r, c) += raster(rr, cc);
+                        }
+                    }
+                }
+            }
+        }
+
+        CHECK_RASTER_EQ(expected, sum_in_buffer(raster, 35.f, BufferStyle::Circular));
+    }
+}
+
+TEST_CASE("Max and min in buffer match the values within the radius")
+{
+    RasterMetadata meta(23, 31, -1);
+    meta.set_cell_size(10.0);
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int32_t> dist(0, 100);
+
+    MaskedRaster<int32_t> raster(meta, 0);
+    for (size_t i = 0; i < raster.size(); ++i) {
+        if (auto value = dist(rng); value < 10) {
+            raster.mark_as_nodata(i);
+        } else {
+            raster[i] = value;
+        }
+    }
+
+    for (auto bufferStyle : {BufferStyle::Circular, BufferStyle::Square}) {
+        for (float radius : {0.f, 14.2f, 35.f, 120.f}) {
+            const float radiusInCells      = radius / 10.f;
+            const auto squareRadius        = int32_t(int32_t(radiusInCells) * std::sqrt(inf::math::pi) / 2.0);
+            const auto circleRadius        = int32_t(std::ceil(radiusInCells));
+            const long long radius2InCells = (long long)(std::ceil(radiusInCells * radiusInCells));
+
+            MaskedRaster<int32_t> expectedMax(meta, 0), expectedMin(meta, 0);
+            for (int32_t r = 0; r < meta.rows; ++r) {
+                for (int32_t c = 0; c < meta.cols; ++c) {
+                    auto maxValue = std::numeric_limits<int32_t>::lowest();
+                    auto minValue = std::numeric_limits<int32_t>::max();
+                    for (int32_t rr = 0; rr < meta.rows; ++rr) {
+                        for (int32_t cc = 0; cc < meta.cols; ++cc) {
+                            const bool inBuffer = bufferStyle == BufferStyle::Square
+                                                      ? std::abs(rr - r) <= squareRadius && std::abs(cc - c) <= squareRadius
+                                                      : std::abs(rr - r) <= circleRadius && std::abs(cc - c) <= circleRadius && (rr - r) * (rr - r) + (cc - c) * (cc - c) <= radius2InCells;
+                            if (inBuffer && !raster.is_nodata(rr, cc)) {
+                                maxValue = std::max(maxValue, raster(rr, cc));
+                                minValue = std::min(minValue, raster(rr, cc));
+                            }
+                        }
+                    }
+
+                    expectedMax(r, c) = maxValue;
+                    expectedMin(r, c) = minValue;
+                }
+            }
+
+            CHECK_RASTER_EQ(expectedMax, max_in_buffer(raster, radius, bufferStyle));
+            CHECK_RASTER_EQ(expectedMin, min_in_buffer(raster, radius, bufferStyle));
+        }
+    }
 }
 }
@@ -189,5 +189,31 @@ TEST_CASE_TEMPLATE("SumWithinTravelDistance", TypeParam, UnspecializedRasterType
 
         CHECK_RASTER_EQ(expected, actual);
     }
+
+    SUBCASE("sumWithinTravelDistanceProgress")
+    {
+        ByteRaster mask(meta, 1);
+        FloatRaster resistance(meta, 1.f);
+        FloatRaster value(meta, 1.f);
+
+        float lastProgress = 0.f;
+        auto actual        = sum_within_travel_distance<float>(mask, resistance, value, 1.01f, false, [&](float progress) {
+            CHECK(progress >= lastProgress);
+            lastProgress = progress;
+            return true;
+        });
+
+        CHECK(lastProgress == 1.f);
+        CHECK(actual(2, 2) == 5.f);
+    }
+
+    SUBCASE("sumWithinTravelDistanceCancel")
+    {
+        ByteRaster mask(meta, 1);
+        FloatRaster resistance(meta, 1.f);
+        FloatRaster value(meta, 1.f);
+
+        CHECK_THROWS_AS(sum_within_travel_distance<float>(mask, resistance, value, 1.01f, false, [](float) { return false; }), RuntimeError);
+    }
 }
 }
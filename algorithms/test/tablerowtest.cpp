@@ -1,6 +1,7 @@
 #include "gdx/algo/tablerow.h"
 #include "gdx/test/testbase.h"
 
+#include <map>
 #include <numeric>
 #include <random>
 
@@ -52,5 +53,42 @@ TEST_CASE_TEMPLATE("Tablerow", TypeParam, UnspecializedRasterTypes)
         expected = {"16.000000"};
         CHECK(actual.second == expected);
     }
+
+    SUBCASE("tableRowMultipleChunks")
+    {
+        // the zonal chunk border (cell 2^16) lies in row 218, so the category of rows 200-249 is summed in both chunks
+        RasterMetadata meta(400, 300, 0.0, 0.0, 100.0, -9999.0);
+        IntRaster categories(meta, 0);
+        FloatRaster values(meta, 0.f);
+
+        std::map<int, std::pair<double, int>> expected;
+        std::mt19937 rng(42);
+        for (int32_t r = 0; r < meta.rows; ++r) {
+            for (int32_t c = 0; c < meta.cols; ++c) {
+                categories(r, c) = (r / 50) * 1000 + c % 3;
+                values(r, c)     = float(rng() % 7);
+                if (rng() % 10 == 0) {
+                    values.mark_as_nodata(r, c);
+                } else {
+                    expected[categories(r, c)].first += values(r, c);
+                    ++expected[categories(r, c)].second;
+                }
+            }
+        }
+
+        std::vector<std::string> expectedHeader, expectedSum, expectedCount;
+        for (auto& [cat, sumCount] : expected) {
+            expectedHeader.push_back(std::to_string(cat));
+            expectedSum.push_back(std::to_string(sumCount.first));
+            expectedCount.push_back(std::to_string(sumCount.second));
+        }
+
+        auto actual = table_row_impl(values, categories, gdx::Operation::Sum);
+        CHECK(actual.first == expectedHeader);
+        CHECK(actual.second == expectedSum);
+
+        actual = table_row_impl(values, categories, gdx::Operation::Count);
+        CHECK(actual.second == expectedCount);
+    }
 }
 }
\ No newline at end of file
@@ -40,5 +40,35 @@ TEST_CASE_TEMPLATE("Voronoi", TypeParam, RasterTypes)
 
         CHECK_RASTER_EQ(expected, actual);
     }
+
+    SUBCASE("voronoi equal distances")
+    {
+        // regularly spaced locations result in many cells at an equal distance of several locations
+        // those cells belong to the location that comes first in the list
+        gdx::RasterMetadata meta(25, 30);
+        meta.set_cell_size(1.0);
+
+        std::vector<gdx::Cell> locations;
+        for (int32_t r = 22; r >= 0; r -= 6) {
+            for (int32_t c = 1; c < 30; c += 4) {
+                locations.emplace_back(r, c);
+            }
+        }
+
+        auto expected = Raster(meta, T(0));
+        for (int32_t r = 0; r < meta.rows; ++r) {
+            for (int32_t c = 0; c < meta.cols; ++c) {
+                double minDist = std::numeric_limits<double>::max();
+                for (size_t i = 0; i < locations.size(); ++i) {
+                    if (auto dist = distance(locations[i], Cell(r, c)); dist < minDist) {
+                        minDist        = dist;
+                        expected(r, c) = static_cast<T>(i);
+                    }
+                }
+            }
+        }
+
+        CHECK_RASTER_EQ(expected, voronoi<Raster>(meta, locations));
+    }
 }
 }
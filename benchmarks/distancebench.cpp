@@ -0,0 +1,179 @@
+#include "gdx/algo/distance.h"
+#include "gdx/maskedraster.h"
+#include "gdx/maskedrasterio.h"
+#include "infra/gdal.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <functional>
+#include <random>
+
+using namespace gdx;
+
+namespace {
+
+// The breadth first (FIFO) relaxation that was used by the travel distance algorithms before the dijkstra traversal
+// Kept here as a reference for the benchmarks
+void handle_time_cell_fifo(float deltaD, const Cell& cell, const Cell& newCell,
+                           MaskedRaster<float>& distanceToTarget,
+                           MaskedRaster<uint8_t>& mark,
+                           const MaskedRaster<float>& travelTime,
+                           FiLo<Cell>& border)
+{
+    if (distanceToTarget.is_nodata(cell) || distanceToTarget.is_nodata(newCell)) {
+        return;
+    }
+
+    const float alternativeDist = distanceToTarget[cell] + deltaD * travelTime[newCell];
+    float& d                    = distanceToTarget[newCell];
+    if (d > alternativeDist) {
+        d       = alternativeDist;
+        auto& m = mark[newCell];
+        if (m != s_markBorder) {
+            m = s_markBorder;
+            border.push_back(newCell);
+        }
+    }
+}
+
+MaskedRaster<float> travel_distance_fifo(const MaskedRaster<uint8_t>& target, const MaskedRaster<float>& travelTime)
+{
+    const auto rows = target.rows();
+    const auto cols = target.cols();
+
+    auto meta   = target.metadata();
+    meta.nodata = MaskedRaster<float>::NaN;
+    MaskedRaster<float> distanceToTarget(std::move(meta), std::numeric_limits<float>::max());
+    MaskedRaster<uint8_t> mark(target.metadata(), s_markTodo);
+
+    FiLo<Cell> border(rows, cols);
+
+    for (int32_t r = 0; r < rows; ++r) {
+        for (int32_t c = 0; c < cols; ++c) {
+            if (target.is_nodata(r, c) || travelTime.is_nodata(r, c)) {
+                distanceToTarget.mark_as_nodata(r, c);
+            } else if (target(r, c) != 0) {
+                distanceToTarget(r, c) = 0;
+                mark(r, c)             = s_markBorder;
+                border.push_back(Cell(r, c));
+            }
+        }
+    }
+
+    const float sqrt2 = std::sqrt(2.f);
+    while (!border.empty()) {
+        auto cell  = border.pop_head();
+        mark[cell] = s_markDone;
+
+        visit_neighbour_cells(cell, rows, cols, [&](const Cell& neighbour) {
+            handle_time_cell_fifo(1.f, cell, neighbour, distanceToTarget, mark, travelTime, border);
+        });
+
+        visit_neighbour_diag_cells(cell, rows, cols, [&](const Cell& neighbour) {
+            handle_time_cell_fifo(sqrt2, cell, neighbour, distanceToTarget, mark, travelTime, border);
+        });
+    }
+
+    return distanceToTarget;
+}
+
+// Resistance map of a road network: cheap roads on a grid with expensive and heterogeneous land in between
+MaskedRaster<float> create_road_network_resistance(int32_t dim)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> landCost(1.f, 10.f);
+    std::uniform_real_distribution<float> roadCost(0.05f, 0.2f);
+    std::uniform_real_distribution<float> chance(0.f, 1.f);
+
+    MaskedRaster<float> resistance(RasterMetadata(dim, dim, -1.0), 1.f);
+    for (int32_t r = 0; r < dim; ++r) {
+        for (int32_t c = 0; c < dim; ++c) {
+            if (r % 16 == 0 || c % 25 == 0) {
+                resistance(r, c) = roadCost(rng);
+            } else if (chance(rng) < 0.02f) {
+                resistance.mark_as_nodata(r, c);
+            } else {
+                resistance(r, c) = landCost(rng);
+            }
+        }
+    }
+
+    return resistance;
+}
+
+MaskedRaster<uint8_t> create_targets(const RasterMetadata& meta, float density)
+{
+    std::mt19937 rng(43);
+    std::uniform_real_distribution<float> chance(0.f, 1.f);
+
+    MaskedRaster<uint8_t> targets(RasterMetadata(meta.rows, meta.cols, 255.0), 0);
+    for (auto& target : targets) {
+        target = chance(rng) < density ? 1 : 0;
+    }
+
+    return targets;
+}
+
+void travel_distance_fifo_bench(benchmark::State& state, const MaskedRaster<float>& resistance)
+{
+    auto targets = create_targets(resistance.metadata(), 0.001f);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(travel_distance_fifo(targets, resistance));
+    }
+}
+
+void travel_distance_dijkstra_bench(benchmark::State& state, const MaskedRaster<float>& resistance)
+{
+    auto targets = create_targets(resistance.metadata(), 0.001f);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(travel_distance(targets, resistance));
+    }
+}
+
+void travel_distance_fifo_synthetic(benchmark::State& state)
+{
+    travel_distance_fifo_bench(state, create_road_network_resistance(inf::truncate<int32_t>(state.range(0))));
+}
+
+void travel_distance_dijkstra_synthetic(benchmark::State& state)
+{
+    travel_distance_dijkstra_bench(state, create_road_network_resistance(inf::truncate<int32_t>(state.range(0))));
+}
+
+void sum_within_travel_distance_synthetic(benchmark::State& state)
+{
+    auto resistance = create_road_network_resistance(inf::truncate<int32_t>(state.range(0)));
+    auto targets    = create_targets(resistance.metadata(), 0.01f);
+    MaskedRaster<float> values(resistance.metadata(), 1.f);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sum_within_travel_distance<float>(targets, resistance, values, 5.f, false));
+    }
+}
+
+}
+
+BENCHMARK(travel_distance_fifo_synthetic)->Arg(250)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(travel_distance_dijkstra_synthetic)->Arg(250)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(sum_within_travel_distance_synthetic)->Arg(250)->Arg(500)->Unit(benchmark::kMillisecond);
+
+// Set GDX_BENCH_RESISTANCE_RASTER to the path of a resistance raster to also benchmark on real data
+int main(int argc, char** argv)
+{
+    inf::gdal::Registration reg;
+
+    MaskedRaster<float> realResistance;
+    if (auto* path = std::getenv("GDX_BENCH_RESISTANCE_RASTER"); path != nullptr) {
+        realResistance = read_masked_raster<float>(path);
+        benchmark::RegisterBenchmark("travel_distance_fifo_real", travel_distance_fifo_bench, std::cref(realResistance))->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("travel_distance_dijkstra_real", travel_distance_dijkstra_bench, std::cref(realResistance))->Unit(benchmark::kMillisecond);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
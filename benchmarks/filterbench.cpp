@@ -0,0 +1,85 @@
+#include "gdx/algo/filter.h"
+#include "gdx/maskedraster.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace gdx;
+
+static std::vector<double> create_filter_values(int32_t dim)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dist(0.0, 10.0);
+
+    std::vector<double> values(size_t(dim) * dim);
+    for (auto& value : values) {
+        value = dist(rng);
+    }
+
+    return values;
+}
+
+// The filter engines on a 1000x1000 raster with the radius as argument
+// used to determine the radius from which the fft engine is faster (detail::s_fftFilterRadius)
+static void filterDirect(benchmark::State& state)
+{
+    const int32_t dim = 1000;
+    auto values       = create_filter_values(dim);
+    detail::FilterKernel kernel(FilterMode::Linear, inf::truncate<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(detail::filter_direct(values, dim, dim, kernel));
+    }
+}
+
+static void filterFft(benchmark::State& state)
+{
+    const int32_t dim = 1000;
+    auto values       = create_filter_values(dim);
+    detail::FilterKernel kernel(FilterMode::Linear, inf::truncate<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(detail::filter_fft(values, dim, dim, kernel));
+    }
+}
+
+static void filterConstant(benchmark::State& state)
+{
+    const int32_t dim = 1000;
+    auto values       = create_filter_values(dim);
+    detail::FilterKernel kernel(FilterMode::Constant, inf::truncate<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(detail::filter_constant(values, dim, dim, kernel));
+    }
+}
+
+// The filter with automatic engine selection
+static void filterMaskedRaster(benchmark::State& state, FilterMode mode, bool normalize)
+{
+    const auto dim = 1000;
+    auto values    = create_filter_values(dim);
+
+    MaskedRaster<float> ras(RasterMetadata(dim, dim, -1.0), 0.f);
+    for (size_t i = 0; i < ras.size(); ++i) {
+        if (i % 11 == 0) {
+            ras.mark_as_nodata(i);
+        } else {
+            ras[i] = static_cast<float>(values[i]);
+        }
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(filter<MaskedRaster<float>>(ras, mode, inf::truncate<int>(state.range(0)), normalize));
+    }
+}
+
+BENCHMARK(filterDirect)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK(filterFft)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->Arg(64)->Unit(benchmark::kMillisecond);
+BENCHMARK(filterConstant)->Arg(4)->Arg(16)->Arg(64)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(filterMaskedRaster, constant, FilterMode::Constant, false)->Arg(5)->Arg(50)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(filterMaskedRaster, linear, FilterMode::Linear, false)->Arg(5)->Arg(50)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(filterMaskedRaster, exponential_normalized, FilterMode::Exponential, true)->Arg(5)->Arg(50)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
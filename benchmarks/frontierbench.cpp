@@ -0,0 +1,114 @@
+#include "gdx/algo/clusterutils.h"
+#include "gdx/maskedraster.h"
+
+#include <benchmark/benchmark.h>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace gdx;
+
+namespace {
+
+// The ring buffer that was used for the flood fill frontier before the chunked queue
+// It preallocates a cell for every raster cell, kept here as a reference for the benchmarks
+class RasterSizeRingBuffer
+{
+public:
+    RasterSizeRingBuffer(int nRows, int nCols)
+    : _values((static_cast<size_t>(nRows) * static_cast<size_t>(nCols)) + 1)
+    {
+    }
+
+    bool empty() const noexcept
+    {
+        return _tail == _head;
+    }
+
+    void push_back(Cell value)
+    {
+        _values[_tail] = value;
+        _tail          = (_tail + 1) % _values.size();
+    }
+
+    Cell pop_head()
+    {
+        auto value = _values[_head];
+        _head      = (_head + 1) % _values.size();
+        return value;
+    }
+
+    size_t allocated_bytes() const noexcept
+    {
+        return _values.size() * sizeof(Cell);
+    }
+
+private:
+    size_t _head = 0, _tail = 0;
+    std::vector<Cell> _values;
+};
+
+double peak_rss_in_mb()
+{
+#ifndef _WIN32
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0; // kilobytes on linux
+#else
+    return 0.0;
+#endif
+}
+
+// Breadth first flood fill of the full raster starting from the center, like the cluster algorithms do for one large cluster
+template <typename Queue>
+int64_t flood_fill(MaskedRaster<uint8_t>& mark, Queue& border)
+{
+    const auto rows = mark.rows();
+    const auto cols = mark.cols();
+    mark.fill(s_markTodo);
+
+    int64_t visited = 0;
+    Cell center(rows / 2, cols / 2);
+    mark[center] = s_markBorder;
+    border.push_back(center);
+
+    while (!border.empty()) {
+        const auto cell = border.pop_head();
+        ++visited;
+
+        visit_neighbour_cells(cell, rows, cols, [&](const Cell& neighbour) {
+            if (mark[neighbour] == s_markTodo) {
+                mark[neighbour] = s_markBorder;
+                border.push_back(neighbour);
+            }
+        });
+    }
+
+    return visited;
+}
+
+// The peak rss is the maximum of the process, run the benchmarks in registration order to compare them
+template <typename Queue>
+void flood_fill_bench(benchmark::State& state)
+{
+    const auto dim = inf::truncate<int32_t>(state.range(0));
+    MaskedRaster<uint8_t> mark(RasterMetadata(dim, dim), s_markTodo);
+
+    size_t queueBytes = 0;
+    for (auto _ : state) {
+        Queue border(dim, dim);
+        benchmark::DoNotOptimize(flood_fill(mark, border));
+        queueBytes = border.allocated_bytes();
+    }
+
+    state.counters["queue_mb"]    = double(queueBytes) / (1024.0 * 1024.0);
+    state.counters["peak_rss_mb"] = peak_rss_in_mb();
+}
+
+}
+
+BENCHMARK_TEMPLATE(flood_fill_bench, FiLo<Cell>)->Arg(1000)->Arg(8000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(flood_fill_bench, RasterSizeRingBuffer)->Arg(1000)->Arg(8000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,11 +1,14 @@
 #include "denserasternonsimd.h"
 #include "gdx/algo/sum.h"
+#include "gdx/cpudispatch.h"
 #include "gdx/denseraster.h"
+#include "gdx/denserasterexpression.h"
 #include "gdx/maskedraster.h"
 #include "gdx/rasteriterator.h"
 
 #include <Eigen/Core>
 
+#include <algorithm>
 #include <benchmark/benchmark.h>
 #include <iostream>
 #include <numeric>
@@ -221,6 +224,93 @@ static void initFloatRasterWithData(benchmark::State& state)
     }
 }
 
+// Weighted overlay with a threshold: every eager operation creates a temporary raster
+static void weightedOverlayEager(benchmark::State& state)
+{
+    auto dim = inf::truncate<int32_t>(state.range(0));
+    DenseRaster<float> ras1(RasterMetadata(dim, dim, -1.0), 1.f);
+    DenseRaster<float> ras2(RasterMetadata(dim, dim, -1.0), 2.f);
+    DenseRaster<float> ras3(RasterMetadata(dim, dim, -1.0), 4.f);
+    for (auto _ : state) {
+        DenseRaster<uint8_t> res = (ras1 * 0.3f + ras2 * 0.7f) / ras3 > 0.25f;
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+// The same weighted overlay evaluated in one pass over the input rasters
+static void weightedOverlayFused(benchmark::State& state)
+{
+    auto dim = inf::truncate<int32_t>(state.range(0));
+    DenseRaster<float> ras1(RasterMetadata(dim, dim, -1.0), 1.f);
+    DenseRaster<float> ras2(RasterMetadata(dim, dim, -1.0), 2.f);
+    DenseRaster<float> ras3(RasterMetadata(dim, dim, -1.0), 4.f);
+    for (auto _ : state) {
+        DenseRaster<uint8_t> res = (lazy(ras1) * 0.3f + lazy(ras2) * 0.7f) / ras3 > 0.25f;
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+static void weightedSumIntEager(benchmark::State& state)
+{
+    auto dim = inf::truncate<int32_t>(state.range(0));
+    DenseRaster<int32_t> ras1(RasterMetadata(dim, dim, -1.0), 1);
+    DenseRaster<int32_t> ras2(RasterMetadata(dim, dim, -1.0), 2);
+    for (auto _ : state) {
+        DenseRaster<int32_t> res = ras1 * 3 + ras2 * 5 - 1;
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+static void weightedSumIntFused(benchmark::State& state)
+{
+    auto dim = inf::truncate<int32_t>(state.range(0));
+    DenseRaster<int32_t> ras1(RasterMetadata(dim, dim, -1.0), 1);
+    DenseRaster<int32_t> ras2(RasterMetadata(dim, dim, -1.0), 2);
+    for (auto _ : state) {
+        DenseRaster<int32_t> res = lazy(ras1) * 3 + lazy(ras2) * 5 - 1;
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+// Both rasters contain nodata, so every operation has to combine the nodata masks
+template <typename T>
+static void addMaskedRastersWithNodata(benchmark::State& state)
+{
+    auto dim = inf::truncate<int32_t>(state.range(0));
+    MaskedRaster<T> ras1(RasterMetadata(dim, dim, -1.0), T(1));
+    MaskedRaster<T> ras2(RasterMetadata(dim, dim, -1.0), T(2));
+    ras1.mark_as_nodata(0);
+    ras2.mark_as_nodata(ras2.size() - 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ras1 + ras2);
+    }
+}
+
+// Compares the runtime dispatched kernels of every instruction set the processor supports
+template <typename T>
+static void multiplyMaskedRasterPerInstructionSet(benchmark::State& state)
+{
+    const auto instructionSet = cpu::InstructionSet(state.range(1));
+    const auto supported      = cpu::supported_instruction_sets();
+    if (std::find(supported.begin(), supported.end(), instructionSet) == supported.end()) {
+        state.SkipWithError("Instruction set not supported by this processor");
+        return;
+    }
+
+    const auto activeInstructionSet = cpu::active_instruction_set();
+    cpu::set_instruction_set(instructionSet);
+    state.SetLabel(std::string(cpu::instruction_set_name(instructionSet)));
+
+    auto dim = inf::truncate<int32_t>(state.range(0));
+    MaskedRaster<T> ras1(RasterMetadata(dim, dim), T(3));
+    MaskedRaster<T> ras2(RasterMetadata(dim, dim), T(2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ras1 * ras2);
+    }
+
+    cpu::set_instruction_set(activeInstructionSet);
+}
+
 #ifndef _MSC_VER
 BENCHMARK_TEMPLATE(add_2_rasters, DenseRaster<uint8_t>)->Arg(10)->Arg(100);
 BENCHMARK_TEMPLATE(add_2_rasters, nosimd::DenseRaster<int32_t>)->Arg(10)->Arg(100);
@@ -258,5 +348,13 @@ BENCHMARK_TEMPLATE(fill_raster_values, nosimd::DenseRaster<int32_t>)->Arg(10)->A
 BENCHMARK_TEMPLATE(fill_raster_values, DenseRaster<float>)->Arg(10)->Arg(100);
 BENCHMARK_TEMPLATE(fill_raster_values, nosimd::DenseRaster<float>)->Arg(10)->Arg(100);
 BENCHMARK(initFloatRasterWithData)->Arg(10)->Arg(100);
+BENCHMARK(weightedOverlayEager)->Arg(100)->Arg(2000);
+BENCHMARK(weightedOverlayFused)->Arg(100)->Arg(2000);
+BENCHMARK(weightedSumIntEager)->Arg(100)->Arg(2000);
+BENCHMARK(weightedSumIntFused)->Arg(100)->Arg(2000);
+BENCHMARK_TEMPLATE(addMaskedRastersWithNodata, int32_t)->Arg(100)->Arg(2000);
+BENCHMARK_TEMPLATE(addMaskedRastersWithNodata, float)->Arg(100)->Arg(2000);
+BENCHMARK_TEMPLATE(multiplyMaskedRasterPerInstructionSet, int32_t)->ArgsProduct({{2000}, {0, 1, 2, 3}});
+BENCHMARK_TEMPLATE(multiplyMaskedRasterPerInstructionSet, float)->ArgsProduct({{2000}, {0, 1, 2, 3}});
 
 BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+#include "gdx/algo/reclass.h"
+#include "gdx/maskedraster.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace gdx;
+
+// Raster with values in [0, keyCount) multiplied with the key step, every 13th cell is nodata
+static MaskedRaster<int32_t> create_reclass_raster(int32_t dim, int32_t keyCount, int32_t keyStep, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int32_t> dist(0, keyCount - 1);
+
+    RasterMetadata meta(dim, dim, -1.0);
+    MaskedRaster<int32_t> ras(meta, 0);
+    for (size_t i = 0; i < ras.size(); ++i) {
+        if (i % 13 == 0) {
+            ras.mark_as_nodata(i);
+        } else {
+            ras[i] = dist(rng) * keyStep;
+        }
+    }
+
+    return ras;
+}
+
+// Mapping with every combination of the key values for the given number of key columns
+static MappingData<int32_t> create_reclass_mapping(int keyColumns, int32_t keyCount, int32_t keyStep)
+{
+    MappingData<int32_t> mapping;
+    std::vector<int32_t> keys(keyColumns, 0);
+    while (keys.back() < keyCount) {
+        std::vector<int32_t> row;
+        for (auto key : keys) {
+            row.push_back(key * keyStep);
+        }
+        row.push_back(int32_t(mapping.size()));
+        mapping.push_back(row);
+
+        for (int i = 0; i < keyColumns; ++i) {
+            if (++keys[i] < keyCount || i == keyColumns - 1) {
+                break;
+            }
+            keys[i] = 0;
+        }
+    }
+
+    return mapping;
+}
+
+// Reclass of a 2000x2000 raster with the number of key columns as argument
+// a key step of 1 uses the dense lookup table, a large key step the hash table
+static void reclassMapping(benchmark::State& state, int32_t keyStep)
+{
+    const int32_t dim      = 2000;
+    const auto keyColumns  = inf::truncate<int>(state.range(0));
+    const int32_t keyCount = keyColumns == 1 ? 4000 : (keyColumns == 2 ? 60 : 15);
+    const auto mapping     = create_reclass_mapping(keyColumns, keyCount, keyStep);
+    const auto ras1        = create_reclass_raster(dim, keyCount, keyStep, 1);
+    const auto ras2        = create_reclass_raster(dim, keyCount, keyStep, 2);
+    const auto ras3        = create_reclass_raster(dim, keyCount, keyStep, 3);
+
+    for (auto _ : state) {
+        if (keyColumns == 1) {
+            benchmark::DoNotOptimize(reclass_to<int32_t>(mapping, ras1));
+        } else if (keyColumns == 2) {
+            benchmark::DoNotOptimize(reclass_to<int32_t>(mapping, ras1, ras2));
+        } else {
+            benchmark::DoNotOptimize(reclass_to<int32_t>(mapping, ras1, ras2, ras3));
+        }
+    }
+
+    state.counters["mapping_rows"] = double(mapping.size());
+}
+
+// Nreclass of a 2000x2000 raster with the number of intervals as argument
+static void nreclassIntervals(benchmark::State& state)
+{
+    const int32_t dim    = 2000;
+    const auto intervals = inf::truncate<int32_t>(state.range(0));
+    const auto intRaster = create_reclass_raster(dim, intervals, 1, 4);
+
+    MaskedRaster<float> ras(intRaster.metadata(), 0.f);
+    for (size_t i = 0; i < ras.size(); ++i) {
+        ras[i] = float(intRaster[i]) + 0.5f;
+    }
+
+    MappingData<float> mapping;
+    for (int32_t i = 0; i < intervals; ++i) {
+        mapping.push_back({float(i), float(i + 1), float(i % 100)});
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(nreclass(mapping, ras));
+    }
+}
+
+BENCHMARK_CAPTURE(reclassMapping, dense, 1)->Arg(1)->Arg(2)->Arg(3)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(reclassMapping, hash, 100003)->Arg(1)->Arg(2)->Arg(3)->Unit(benchmark::kMillisecond);
+BENCHMARK(nreclassIntervals)->Arg(100)->Arg(4000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
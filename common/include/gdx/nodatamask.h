@@ -0,0 +1,375 @@
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace gdx {
+
+/* Nodata mask of a raster: one bit per cell, packed in 64-bit words
+ * The number of nodata cells is kept up to date, so masks without nodata cells can be skipped entirely.
+ * The unused bits of the last word are always 0, so the words can be combined and counted as a whole.
+ *
+ * Code that needs an addressable value per cell (numpy masked arrays) can share a byte view of the mask.
+ * While the view is shared the words that change are written through to it, changes made to the view
+ * are applied to the mask with update_from_byte_view.
+ *
+ * Cells share their word and the nodata count, so set is not thread safe, not even for different cells.
+ * Parallel loops set the cells with set_block on blocks that start on a word border.
+ */
+class NodataMask
+{
+public:
+    using word_type = uint64_t;
+    using Index     = std::ptrdiff_t;
+
+    static constexpr Index s_wordBits = 64;
+
+    NodataMask() = default;
+
+    NodataMask(int32_t rows, int32_t cols, bool nodata = false)
+    {
+        resize(rows, cols);
+        fill(nodata);
+    }
+
+    // a copy does not share the byte view
+    NodataMask(const NodataMask& other)
+    : _rows(other._rows)
+    , _cols(other._cols)
+    , _nodataCount(other._nodataCount)
+    , _words(other._words)
+    {
+    }
+
+    NodataMask(NodataMask&&) noexcept = default;
+
+    // the byte view of this mask is kept and receives the assigned cells
+    NodataMask& operator=(const NodataMask& other)
+    {
+        if (this != &other) {
+            _rows        = other._rows;
+            _cols        = other._cols;
+            _nodataCount = other._nodataCount;
+            assign_words(other._words);
+        }
+
+        return *this;
+    }
+
+    NodataMask& operator=(NodataMask&& other) noexcept
+    {
+        _rows        = other._rows;
+        _cols        = other._cols;
+        _nodataCount = other._nodataCount;
+        assign_words(std::move(other._words));
+        return *this;
+    }
+
+    int32_t rows() const noexcept
+    {
+        return _rows;
+    }
+
+    int32_t cols() const noexcept
+    {
+        return _cols;
+    }
+
+    Index size() const noexcept
+    {
+        return Index(_rows) * Index(_cols);
+    }
+
+    // Changes the dimensions, the cells are kept if the number of cells does not change, otherwise all cells become data
+    void resize(int32_t rows, int32_t cols)
+    {
+        const auto newSize = Index(rows) * Index(cols);
+        if (newSize != size()) {
+            _words.assign(std::size_t((newSize + s_wordBits - 1) / s_wordBits), word_type(0));
+            _nodataCount = 0;
+        }
+
+        _rows = rows;
+        _cols = cols;
+        if (_byteView && _byteView->size() != std::size_t(newSize)) {
+            _byteView.reset();
+        }
+    }
+
+    void fill(bool nodata) noexcept
+    {
+        for (std::size_t w = 0; w < _words.size(); ++w) {
+            // the unused bits of the last word stay 0
+            const auto usedBits = w + 1 == _words.size() ? used_bits_mask() : ~word_type(0);
+            set_word(w, nodata ? usedBits : word_type(0));
+        }
+
+        _nodataCount = nodata ? size() : 0;
+    }
+
+    bool operator()(Index index) const noexcept
+    {
+        assert(index >= 0 && index < size());
+        return (_words[std::size_t(index / s_wordBits)] >> (index % s_wordBits)) & word_type(1);
+    }
+
+    bool operator()(int32_t row, int32_t col) const noexcept
+    {
+        return (*this)(Index(row) * _cols + col);
+    }
+
+    // Not thread safe, use set_block to set the cells from a parallel loop
+    void set(Index index, bool nodata) noexcept
+    {
+        assert(index >= 0 && index < size());
+        auto& word     = _words[std::size_t(index / s_wordBits)];
+        const auto bit = word_type(1) << (index % s_wordBits);
+        if (((word & bit) != 0) != nodata) {
+            word ^= bit;
+            _nodataCount += nodata ? 1 : -1;
+        }
+
+        if (_byteView) {
+            (*_byteView)[std::size_t(index)] = nodata ? 1 : 0;
+        }
+    }
+
+    void set(int32_t row, int32_t col, bool nodata) noexcept
+    {
+        set(Index(row) * _cols + col, nodata);
+    }
+
+    // Rebuilds the mask from a predicate that is called for every cell index
+    template <typename IsNodata>
+    void assign(IsNodata&& isNodata)
+    {
+        const auto wordCount = int64_t(_words.size());
+        int64_t nodataCount  = 0;
+
+#pragma omp parallel for reduction(+ : nodataCount)
+        for (int64_t w = 0; w < wordCount; ++w) {
+            const auto word = pack_word(std::size_t(w), isNodata);
+            set_word(std::size_t(w), word);
+            nodataCount += int64_t(std::bitset<s_wordBits>(word).count());
+        }
+
+        _nodataCount = Index(nodataCount);
+    }
+
+    // Sets the cells [first, first + count) to the result of the predicate for their index
+    // Can be called concurrently for blocks that do not share a word: first is a multiple of s_wordBits and
+    // the block ends on a word border or at the end of the mask.
+    template <typename IsNodata>
+    void set_block(Index first, Index count, IsNodata&& isNodata)
+    {
+        assert(first % s_wordBits == 0);
+        assert((first + count) % s_wordBits == 0 || first + count == size());
+
+        Index countDiff = 0;
+        for (auto w = std::size_t(first / s_wordBits); w < std::size_t((first + count + s_wordBits - 1) / s_wordBits); ++w) {
+            const auto word = pack_word(w, isNodata);
+            countDiff += Index(std::bitset<s_wordBits>(word).count()) - Index(std::bitset<s_wordBits>(_words[w]).count());
+            set_word(w, word);
+        }
+
+#pragma omp atomic
+        _nodataCount += countDiff;
+    }
+
+    // Invokes the callback with the index of every nodata cell, words without nodata cells are skipped as a whole
+    template <typename Callback>
+    void for_each_nodata(Callback&& cb) const
+    {
+        if (_nodataCount == 0) {
+            return;
+        }
+
+        for (std::size_t w = 0; w < _words.size(); ++w) {
+            for (auto word = _words[w]; word != 0; word &= word - 1) {
+                cb(Index(w) * s_wordBits + lowest_bit_index(word));
+            }
+        }
+    }
+
+    // The cells that are nodata in the other mask become nodata in this mask
+    NodataMask& operator|=(const NodataMask& other) noexcept
+    {
+        assert(size() == other.size());
+        if (other._nodataCount == 0 || _nodataCount == size()) {
+            return *this;
+        }
+
+        Index nodataCount = 0;
+        for (std::size_t w = 0; w < _words.size(); ++w) {
+            set_word(w, _words[w] | other._words[w]);
+            nodataCount += Index(std::bitset<s_wordBits>(_words[w]).count());
+        }
+
+        _nodataCount = nodataCount;
+        return *this;
+    }
+
+    // Byte per cell view of the mask (1 = nodata), the same view is returned as long as it is shared
+    std::shared_ptr<std::vector<uint8_t>> byte_view()
+    {
+        if (!_byteView) {
+            _byteView = std::make_shared<std::vector<uint8_t>>(std::size_t(size()));
+
+            const auto wordCount = int64_t(_words.size());
+#pragma omp parallel for
+            for (int64_t w = 0; w < wordCount; ++w) {
+                write_byte_view_word(std::size_t(w));
+            }
+        }
+
+        return _byteView;
+    }
+
+    // Applies the changes made to the byte view, only the words that differ from the view are modified
+    // The view is released when this mask is its only owner
+    void update_from_byte_view()
+    {
+        if (!_byteView) {
+            return;
+        }
+
+        assert(_byteView->size() == std::size_t(size()));
+        const auto* bytes    = _byteView->data();
+        const auto wordCount = int64_t(_words.size());
+        int64_t countDiff    = 0;
+
+#pragma omp parallel for reduction(+ : countDiff)
+        for (int64_t w = 0; w < wordCount; ++w) {
+            const auto word = pack_word(std::size_t(w), [bytes](Index index) { return bytes[index] != 0; });
+            if (auto& current = _words[std::size_t(w)]; word != current) {
+                countDiff += int64_t(std::bitset<s_wordBits>(word).count()) - int64_t(std::bitset<s_wordBits>(current).count());
+                current = word;
+            }
+        }
+
+        _nodataCount += Index(countDiff);
+        if (_byteView.use_count() == 1) {
+            _byteView.reset();
+        }
+    }
+
+    // The number of nodata cells
+    Index nodata_count() const noexcept
+    {
+        return _nodataCount;
+    }
+
+    // True if at least one of the cells is nodata
+    bool any() const noexcept
+    {
+        return _nodataCount != 0;
+    }
+
+    const word_type* words() const noexcept
+    {
+        return _words.data();
+    }
+
+    std::size_t word_count() const noexcept
+    {
+        return _words.size();
+    }
+
+    bool operator==(const NodataMask& other) const noexcept
+    {
+        return _rows == other._rows && _cols == other._cols && _words == other._words;
+    }
+
+    bool operator!=(const NodataMask& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    // The word of the cells of word w for which the predicate returns true
+    template <typename IsNodata>
+    word_type pack_word(std::size_t w, IsNodata&& isNodata) const
+    {
+        const auto first = Index(w) * s_wordBits;
+        const auto last  = std::min(size(), first + s_wordBits);
+
+        word_type word = 0;
+        for (auto i = first; i < last; ++i) {
+            word |= word_type(isNodata(i) ? 1 : 0) << (i - first);
+        }
+
+        return word;
+    }
+
+    // Stores the word, the byte view is only written when the word changes
+    void set_word(std::size_t w, word_type word) noexcept
+    {
+        if (_words[w] != word) {
+            _words[w] = word;
+            if (_byteView) {
+                write_byte_view_word(w);
+            }
+        }
+    }
+
+    void write_byte_view_word(std::size_t w) noexcept
+    {
+        auto* bytes      = _byteView->data();
+        const auto first = Index(w) * s_wordBits;
+        const auto last  = std::min(size(), first + s_wordBits);
+        const auto word  = _words[w];
+        for (auto i = first; i < last; ++i) {
+            bytes[i] = uint8_t((word >> (i - first)) & word_type(1));
+        }
+    }
+
+    // Assigns the words of a mask with the current dimensions, a byte view that no longer matches the dimensions is released
+    template <typename Words>
+    void assign_words(Words&& words)
+    {
+        if (_byteView && _byteView->size() == std::size_t(size())) {
+            assert(_words.size() == words.size());
+            for (std::size_t w = 0; w < words.size(); ++w) {
+                set_word(w, words[w]);
+            }
+        } else {
+            _words = std::forward<Words>(words);
+            _byteView.reset();
+        }
+    }
+
+    word_type used_bits_mask() const noexcept
+    {
+        const auto usedBits = size() % s_wordBits;
+        return usedBits == 0 ? ~word_type(0) : (word_type(1) << usedBits) - 1;
+    }
+
+    static Index lowest_bit_index(word_type word) noexcept
+    {
+        return Index(std::bitset<s_wordBits>((word & (~word + 1)) - 1).count());
+    }
+
+    int32_t _rows      = 0;
+    int32_t _cols      = 0;
+    Index _nodataCount = 0;
+    std::vector<word_type> _words;
+    std::shared_ptr<std::vector<uint8_t>> _byteView;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const NodataMask& mask)
+{
+    for (int32_t r = 0; r < mask.rows(); ++r) {
+        for (int32_t c = 0; c < mask.cols(); ++c) {
+            os << (c == 0 ? "" : " ") << mask(r, c);
+        }
+        os << '\n';
+    }
+
+    return os;
+}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gdx/cell.h"
+#include "gdx/nodatamask.h"
 #include "infra/cast.h"
 
 #include <cassert>
@@ -67,11 +68,11 @@ private:
     std::optional<T> _nodata;
 };
 
-template <typename TData, typename TMask, bool is_const>
+template <typename TData, bool is_const>
 class NodataMaskFilterPolicy
 {
     using pointer      = std::conditional_t<is_const, const TData*, TData*>;
-    using mask_pointer = std::conditional_t<is_const, const TMask*, TMask*>;
+    using mask_pointer = std::conditional_t<is_const, const NodataMask*, NodataMask*>;
 
 public:
     NodataMaskFilterPolicy() = default;
@@ -83,8 +84,7 @@ public:
 
     constexpr bool exclude(const TData& data) const noexcept
     {
-        std::ptrdiff_t dataOffset = &data - _dataBegin;
-        return _maskBegin && *(_maskBegin + dataOffset);
+        return _maskBegin && (*_maskBegin)(&data - _dataBegin);
     }
 
     mask_pointer proxy_construction_arg() noexcept
@@ -278,12 +278,13 @@ struct MaskValueProxy
     using reference     = std::conditional_t<is_const, const T&, T&>;
     using pointer       = std::conditional_t<is_const, const T*, T*>;
     using const_pointer = const T*;
-    using mask_pointer  = std::conditional_t<is_const, const bool*, bool*>;
+    using mask_pointer  = std::conditional_t<is_const, const NodataMask*, NodataMask*>;
 
     MaskValueProxy() = default;
     MaskValueProxy(pointer data, ptrdiff_t offset, int32_t stride, mask_pointer maskData) noexcept
     : _value(data + offset)
-    , _mask(maskData + offset)
+    , _mask(maskData)
+    , _maskIndex(offset)
     , _dataBegin(data)
     , _stride(stride)
     {
@@ -336,7 +337,7 @@ struct MaskValueProxy
     {
         *_value = val;
         if (_mask) {
-            *_mask = false;
+            _mask->set(_maskIndex, false);
         }
         return *this;
     }
@@ -346,40 +347,36 @@ struct MaskValueProxy
         if (val.has_value()) {
             *_value = val.value();
             if (_mask) {
-                *_mask = false;
+                _mask->set(_maskIndex, false);
             }
         } else {
             assert(_mask);
-            *_mask = true;
+            _mask->set(_maskIndex, true);
         }
         return *this;
     }
 
     bool is_nodata() const noexcept
     {
-        return _mask ? *_mask : false;
+        return _mask ? (*_mask)(_maskIndex) : false;
     }
 
     void reset() noexcept
     {
         assert(_mask);
-        *_mask = true;
+        _mask->set(_maskIndex, true);
     }
 
     void increment()
     {
         ++_value;
-        if (_mask) {
-            ++_mask;
-        }
+        ++_maskIndex;
     }
 
     void increment(int32_t amount)
     {
         _value += amount;
-        if (_mask) {
-            _mask += amount;
-        }
+        _maskIndex += amount;
     }
 
     Cell cell() const noexcept
@@ -402,8 +399,9 @@ struct MaskValueProxy
     }
 
 private:
-    pointer _value     = nullptr;
-    mask_pointer _mask = nullptr;
+    pointer _value            = nullptr;
+    mask_pointer _mask        = nullptr;
+    std::ptrdiff_t _maskIndex = 0;
 
     const_pointer _dataBegin = nullptr;
     int32_t _stride          = 0;
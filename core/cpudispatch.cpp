@@ -0,0 +1,269 @@
+#include "gdx/cpudispatch.h"
+#include "cpukernels.h"
+#include "gdx/exception.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace gdx::cpu {
+
+namespace {
+
+// number of elements per parallel chunk, small buffers are processed on the calling thread
+static constexpr std::size_t s_chunkSize = 64 * 1024;
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+bool processor_supports(InstructionSet instructionSet) noexcept
+{
+    int info[4];
+    __cpuid(info, 0);
+    const auto maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse42   = (info[2] & (1 << 20)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+
+    // the operating system has to preserve the ymm (and zmm) registers on context switches
+    const auto xcr0      = osxsave ? _xgetbv(0) : 0;
+    const bool ymmState  = (xcr0 & 0x06) == 0x06;
+    const bool zmmState  = (xcr0 & 0xe6) == 0xe6;
+    bool avx2            = false;
+    bool avx512          = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2             = (info[1] & (1 << 5)) != 0;
+        const auto flags = (1 << 16) | (1 << 17) | (1 << 30) | (1u << 31); // f, dq, bw, vl
+        avx512           = (unsigned(info[1]) & flags) == flags;
+    }
+
+    switch (instructionSet) {
+    case InstructionSet::Generic:
+        return true;
+    case InstructionSet::Sse4_2:
+        return sse42;
+    case InstructionSet::Avx2:
+        return avx && avx2 && ymmState;
+    case InstructionSet::Avx512:
+        return avx512 && zmmState;
+    }
+
+    return false;
+}
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+bool processor_supports(InstructionSet instructionSet) noexcept
+{
+    // also checks if the operating system supports the avx registers
+    __builtin_cpu_init();
+
+    switch (instructionSet) {
+    case InstructionSet::Generic:
+        return true;
+    case InstructionSet::Sse4_2:
+        return __builtin_cpu_supports("sse4.2");
+    case InstructionSet::Avx2:
+        return __builtin_cpu_supports("avx2");
+    case InstructionSet::Avx512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+               __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq");
+    }
+
+    return false;
+}
+#else
+bool processor_supports(InstructionSet instructionSet) noexcept
+{
+    return instructionSet == InstructionSet::Generic;
+}
+#endif
+
+// The kernels of the instruction set, nullptr if they are not compiled in (e.g. non x86 builds)
+const detail::KernelTable* compiled_kernels(InstructionSet instructionSet) noexcept
+{
+    switch (instructionSet) {
+    case InstructionSet::Generic:
+        return &detail::generic::kernels;
+    case InstructionSet::Sse4_2:
+#ifdef GDX_CPU_KERNELS_SSE4_2
+        return &detail::sse4_2::kernels;
+#else
+        return nullptr;
+#endif
+    case InstructionSet::Avx2:
+#ifdef GDX_CPU_KERNELS_AVX2
+        return &detail::avx2::kernels;
+#else
+        return nullptr;
+#endif
+    case InstructionSet::Avx512:
+#ifdef GDX_CPU_KERNELS_AVX512
+        return &detail::avx512::kernels;
+#else
+        return nullptr;
+#endif
+    }
+
+    return nullptr;
+}
+
+bool is_supported(InstructionSet instructionSet) noexcept
+{
+    return compiled_kernels(instructionSet) != nullptr && processor_supports(instructionSet);
+}
+
+InstructionSet best_instruction_set() noexcept
+{
+    for (auto instructionSet : {InstructionSet::Avx512, InstructionSet::Avx2, InstructionSet::Sse4_2}) {
+        if (is_supported(instructionSet)) {
+            return instructionSet;
+        }
+    }
+
+    return InstructionSet::Generic;
+}
+
+// Selected during static initialization, so the detection does not happen in the middle of a parallel section
+std::atomic<InstructionSet> s_instructionSet = best_instruction_set();
+
+const detail::KernelTable& active_kernels() noexcept
+{
+    return *compiled_kernels(s_instructionSet.load(std::memory_order_relaxed));
+}
+
+template <typename T>
+const detail::TypedKernels<T>& typed_kernels() noexcept
+{
+    const auto& table = active_kernels();
+    if constexpr (std::is_same_v<T, int8_t>) return table.i8;
+    if constexpr (std::is_same_v<T, uint8_t>) return table.u8;
+    if constexpr (std::is_same_v<T, int16_t>) return table.i16;
+    if constexpr (std::is_same_v<T, uint16_t>) return table.u16;
+    if constexpr (std::is_same_v<T, int32_t>) return table.i32;
+    if constexpr (std::is_same_v<T, uint32_t>) return table.u32;
+    if constexpr (std::is_same_v<T, int64_t>) return table.i64;
+    if constexpr (std::is_same_v<T, uint64_t>) return table.u64;
+    if constexpr (std::is_same_v<T, float>) return table.f32;
+    if constexpr (std::is_same_v<T, double>) return table.f64;
+}
+
+// Invokes the kernel with (offset, count) for every chunk of the buffer
+template <typename Kernel>
+void for_each_chunk(std::size_t count, Kernel&& kernel)
+{
+    if (count <= s_chunkSize) {
+        kernel(std::size_t(0), count);
+        return;
+    }
+
+    const auto chunkCount = int64_t((count + s_chunkSize - 1) / s_chunkSize);
+#pragma omp parallel for
+    for (int64_t chunk = 0; chunk < chunkCount; ++chunk) {
+        const auto offset = std::size_t(chunk) * s_chunkSize;
+        kernel(offset, std::min(s_chunkSize, count - offset));
+    }
+}
+
+}
+
+InstructionSet active_instruction_set() noexcept
+{
+    return s_instructionSet.load(std::memory_order_relaxed);
+}
+
+std::vector<InstructionSet> supported_instruction_sets()
+{
+    std::vector<InstructionSet> result;
+    for (auto instructionSet : {InstructionSet::Generic, InstructionSet::Sse4_2, InstructionSet::Avx2, InstructionSet::Avx512}) {
+        if (is_supported(instructionSet)) {
+            result.push_back(instructionSet);
+        }
+    }
+
+    return result;
+}
+
+void set_instruction_set(InstructionSet instructionSet)
+{
+    if (!is_supported(instructionSet)) {
+        throw InvalidArgument("The {} instruction set is not supported", instruction_set_name(instructionSet));
+    }
+
+    s_instructionSet = instructionSet;
+}
+
+std::string_view instruction_set_name(InstructionSet instructionSet) noexcept
+{
+    switch (instructionSet) {
+    case InstructionSet::Generic:
+        return "generic";
+    case InstructionSet::Sse4_2:
+        return "sse4.2";
+    case InstructionSet::Avx2:
+        return "avx2";
+    case InstructionSet::Avx512:
+        return "avx512";
+    }
+
+    return "unknown";
+}
+
+template <typename T>
+void arithmetic(ArithmeticOperation op, const T* lhs, const T* rhs, T* result, std::size_t count)
+{
+    const auto kernel = typed_kernels<T>().arithmetic;
+    for_each_chunk(count, [=](std::size_t offset, std::size_t length) {
+        kernel(op, lhs + offset, rhs + offset, result + offset, length);
+    });
+}
+
+template <typename T>
+void arithmetic_scalar(ArithmeticOperation op, const T* lhs, T rhs, T* result, std::size_t count)
+{
+    const auto kernel = typed_kernels<T>().arithmetic_scalar;
+    for_each_chunk(count, [=](std::size_t offset, std::size_t length) {
+        kernel(op, lhs + offset, rhs, result + offset, length);
+    });
+}
+
+template <typename T>
+void compare(ComparisonOperation op, const T* lhs, const T* rhs, uint8_t* result, std::size_t count)
+{
+    const auto kernel = typed_kernels<T>().compare;
+    for_each_chunk(count, [=](std::size_t offset, std::size_t length) {
+        kernel(op, lhs + offset, rhs + offset, result + offset, length);
+    });
+}
+
+template <typename T>
+void compare_scalar(ComparisonOperation op, const T* lhs, T rhs, uint8_t* result, std::size_t count)
+{
+    const auto kernel = typed_kernels<T>().compare_scalar;
+    for_each_chunk(count, [=](std::size_t offset, std::size_t length) {
+        kernel(op, lhs + offset, rhs, result + offset, length);
+    });
+}
+
+#define GDX_INSTANTIATE_CPU_KERNELS(T)                                                                  \
+    template void arithmetic<T>(ArithmeticOperation, const T*, const T*, T*, std::size_t);             \
+    template void arithmetic_scalar<T>(ArithmeticOperation, const T*, T, T*, std::size_t);             \
+    template void compare<T>(ComparisonOperation, const T*, const T*, uint8_t*, std::size_t);          \
+    template void compare_scalar<T>(ComparisonOperation, const T*, T, uint8_t*, std::size_t);
+
+GDX_INSTANTIATE_CPU_KERNELS(int8_t)
+GDX_INSTANTIATE_CPU_KERNELS(uint8_t)
+GDX_INSTANTIATE_CPU_KERNELS(int16_t)
+GDX_INSTANTIATE_CPU_KERNELS(uint16_t)
+GDX_INSTANTIATE_CPU_KERNELS(int32_t)
+GDX_INSTANTIATE_CPU_KERNELS(uint32_t)
+GDX_INSTANTIATE_CPU_KERNELS(int64_t)
+GDX_INSTANTIATE_CPU_KERNELS(uint64_t)
+GDX_INSTANTIATE_CPU_KERNELS(float)
+GDX_INSTANTIATE_CPU_KERNELS(double)
+
+#undef GDX_INSTANTIATE_CPU_KERNELS
+}
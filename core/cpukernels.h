@@ -0,0 +1,47 @@
+#pragma once
+
+#include "gdx/cpudispatch.h"
+
+namespace gdx::cpu::detail {
+
+template <typename T>
+struct TypedKernels
+{
+    void (*arithmetic)(ArithmeticOperation, const T*, const T*, T*, std::size_t);
+    void (*arithmetic_scalar)(ArithmeticOperation, const T*, T, T*, std::size_t);
+    void (*compare)(ComparisonOperation, const T*, const T*, uint8_t*, std::size_t);
+    void (*compare_scalar)(ComparisonOperation, const T*, T, uint8_t*, std::size_t);
+};
+
+// The kernels of one instruction set, for all the supported types
+struct KernelTable
+{
+    TypedKernels<int8_t> i8;
+    TypedKernels<uint8_t> u8;
+    TypedKernels<int16_t> i16;
+    TypedKernels<uint16_t> u16;
+    TypedKernels<int32_t> i32;
+    TypedKernels<uint32_t> u32;
+    TypedKernels<int64_t> i64;
+    TypedKernels<uint64_t> u64;
+    TypedKernels<float> f32;
+    TypedKernels<double> f64;
+};
+
+// Every cpukernels_*.cpp file defines the table of its instruction set
+namespace generic {
+extern const KernelTable kernels;
+}
+
+namespace sse4_2 {
+extern const KernelTable kernels;
+}
+
+namespace avx2 {
+extern const KernelTable kernels;
+}
+
+namespace avx512 {
+extern const KernelTable kernels;
+}
+}
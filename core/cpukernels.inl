@@ -0,0 +1,116 @@
+// Kernel implementations, included by the cpukernels_*.cpp files with GDX_CPU_KERNEL_NAMESPACE set to the instruction set
+// of the file. Every file is compiled with different instruction set flags, so only plain loops are used in here:
+// inline functions from other headers would be compiled with those flags as well and the linker could pick
+// that version for processors that do not support the instruction set.
+
+#include "cpukernels.h"
+
+#ifndef GDX_CPU_KERNEL_NAMESPACE
+#error "GDX_CPU_KERNEL_NAMESPACE should be defined before including cpukernels.inl"
+#endif
+
+namespace gdx::cpu::detail::GDX_CPU_KERNEL_NAMESPACE {
+
+namespace {
+
+template <typename T, typename TResult, typename BinaryOperation>
+void transform(const T* lhs, const T* rhs, TResult* result, std::size_t count, BinaryOperation op)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        result[i] = op(lhs[i], rhs[i]);
+    }
+}
+
+template <typename T, typename TResult, typename BinaryOperation>
+void transform_scalar(const T* lhs, T rhs, TResult* result, std::size_t count, BinaryOperation op)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        result[i] = op(lhs[i], rhs);
+    }
+}
+
+template <typename T, typename TRhs>
+void arithmetic(ArithmeticOperation op, const T* lhs, TRhs rhs, T* result, std::size_t count)
+{
+    constexpr bool isScalar = std::is_same_v<T, TRhs>;
+    auto apply              = [=](auto operation) {
+        if constexpr (isScalar) {
+            transform_scalar(lhs, rhs, result, count, operation);
+        } else {
+            transform(lhs, rhs, result, count, operation);
+        }
+    };
+
+    switch (op) {
+    case ArithmeticOperation::Add:
+        apply([](T a, T b) { return T(a + b); });
+        break;
+    case ArithmeticOperation::Subtract:
+        apply([](T a, T b) { return T(a - b); });
+        break;
+    case ArithmeticOperation::Multiply:
+        apply([](T a, T b) { return T(a * b); });
+        break;
+    }
+}
+
+template <typename T, typename TRhs>
+void compare(ComparisonOperation op, const T* lhs, TRhs rhs, uint8_t* result, std::size_t count)
+{
+    constexpr bool isScalar = std::is_same_v<T, TRhs>;
+    auto apply              = [=](auto predicate) {
+        if constexpr (isScalar) {
+            transform_scalar(lhs, rhs, result, count, predicate);
+        } else {
+            transform(lhs, rhs, result, count, predicate);
+        }
+    };
+
+    switch (op) {
+    case ComparisonOperation::Equal:
+        apply([](T a, T b) { return uint8_t(a == b); });
+        break;
+    case ComparisonOperation::NotEqual:
+        apply([](T a, T b) { return uint8_t(a != b); });
+        break;
+    case ComparisonOperation::Less:
+        apply([](T a, T b) { return uint8_t(a < b); });
+        break;
+    case ComparisonOperation::LessEqual:
+        apply([](T a, T b) { return uint8_t(a <= b); });
+        break;
+    case ComparisonOperation::Greater:
+        apply([](T a, T b) { return uint8_t(a > b); });
+        break;
+    case ComparisonOperation::GreaterEqual:
+        apply([](T a, T b) { return uint8_t(a >= b); });
+        break;
+    }
+}
+
+template <typename T>
+constexpr TypedKernels<T> typed_kernels()
+{
+    return TypedKernels<T>{
+        &arithmetic<T, const T*>,
+        &arithmetic<T, T>,
+        &compare<T, const T*>,
+        &compare<T, T>,
+    };
+}
+
+}
+
+const KernelTable kernels = {
+    typed_kernels<int8_t>(),
+    typed_kernels<uint8_t>(),
+    typed_kernels<int16_t>(),
+    typed_kernels<uint16_t>(),
+    typed_kernels<int32_t>(),
+    typed_kernels<uint32_t>(),
+    typed_kernels<int64_t>(),
+    typed_kernels<uint64_t>(),
+    typed_kernels<float>(),
+    typed_kernels<double>(),
+};
+}
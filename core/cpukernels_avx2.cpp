@@ -0,0 +1,3 @@
+// Kernels compiled for avx2, only used when the processor supports it
+#define GDX_CPU_KERNEL_NAMESPACE avx2
+#include "cpukernels.inl"
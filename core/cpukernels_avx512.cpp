@@ -0,0 +1,3 @@
+// Kernels compiled for avx512 (f, bw, vl and dq), only used when the processor supports it
+#define GDX_CPU_KERNEL_NAMESPACE avx512
+#include "cpukernels.inl"
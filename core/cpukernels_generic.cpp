@@ -0,0 +1,3 @@
+// Kernels compiled for the instruction set the library is built for
+#define GDX_CPU_KERNEL_NAMESPACE generic
+#include "cpukernels.inl"
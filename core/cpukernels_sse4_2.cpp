@@ -0,0 +1,3 @@
+// Kernels compiled for sse4.2, only used when the processor supports it
+#define GDX_CPU_KERNEL_NAMESPACE sse4_2
+#include "cpukernels.inl"
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace gdx::cpu {
+
+/* Element wise raster kernels that are compiled for multiple instruction sets
+ * The best instruction set that is supported by the processor is selected when the library is loaded,
+ * so the packages can be built for the lowest common denominator and still use the wide registers of newer processors.
+ * Generic is the instruction set the rest of the library is built for (GDX_AVX2 or the compiler default).
+ */
+enum class InstructionSet
+{
+    Generic,
+    Sse4_2,
+    Avx2,
+    Avx512,
+};
+
+enum class ArithmeticOperation
+{
+    Add,
+    Subtract,
+    Multiply,
+};
+
+enum class ComparisonOperation
+{
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+};
+
+// The instruction set of the kernels that are currently used
+InstructionSet active_instruction_set() noexcept;
+
+// The instruction sets that are compiled in and supported by this processor, from generic to the best one
+std::vector<InstructionSet> supported_instruction_sets();
+
+// Selects the kernels of another instruction set (e.g. to compare or benchmark them)
+// Throws InvalidArgument when the instruction set is not supported
+void set_instruction_set(InstructionSet instructionSet);
+
+std::string_view instruction_set_name(InstructionSet instructionSet) noexcept;
+
+// The kernels are available for the fixed width integer types and for float/double
+template <typename T>
+inline constexpr bool has_kernels_v = std::disjunction_v<std::is_same<T, int8_t>, std::is_same<T, uint8_t>,
+                                                         std::is_same<T, int16_t>, std::is_same<T, uint16_t>,
+                                                         std::is_same<T, int32_t>, std::is_same<T, uint32_t>,
+                                                         std::is_same<T, int64_t>, std::is_same<T, uint64_t>,
+                                                         std::is_same<T, float>, std::is_same<T, double>>;
+
+// result[i] = lhs[i] op rhs[i], large buffers are processed in parallel
+template <typename T>
+void arithmetic(ArithmeticOperation op, const T* lhs, const T* rhs, T* result, std::size_t count);
+
+// result[i] = lhs[i] op rhs
+template <typename T>
+void arithmetic_scalar(ArithmeticOperation op, const T* lhs, T rhs, T* result, std::size_t count);
+
+// result[i] = lhs[i] op rhs[i] ? 1 : 0
+template <typename T>
+void compare(ComparisonOperation op, const T* lhs, const T* rhs, uint8_t* result, std::size_t count);
+
+// result[i] = lhs[i] op rhs ? 1 : 0
+template <typename T>
+void compare_scalar(ComparisonOperation op, const T* lhs, T rhs, uint8_t* result, std::size_t count);
+
+// Maps the standard library function objects on the kernel operations, nullopt if there is no kernel for the operation
+template <typename BinaryOperation>
+inline constexpr std::optional<ArithmeticOperation> arithmetic_operation_v = std::nullopt;
+
+template <typename T>
+inline constexpr std::optional<ArithmeticOperation> arithmetic_operation_v<std::plus<T>> = ArithmeticOperation::Add;
+template <typename T>
+inline constexpr std::optional<ArithmeticOperation> arithmetic_operation_v<std::minus<T>> = ArithmeticOperation::Subtract;
+template <typename T>
+inline constexpr std::optional<ArithmeticOperation> arithmetic_operation_v<std::multiplies<T>> = ArithmeticOperation::Multiply;
+
+template <typename BinaryPredicate>
+inline constexpr std::optional<ComparisonOperation> comparison_operation_v = std::nullopt;
+
+template <typename T>
+inline constexpr std::optional<ComparisonOperation> comparison_operation_v<std::equal_to<T>> = ComparisonOperation::Equal;
+template <typename T>
+inline constexpr std::optional<ComparisonOperation> comparison_operation_v<std::not_equal_to<T>> = ComparisonOperation::NotEqual;
+template <typename T>
+inline constexpr std::optional<ComparisonOperation> comparison_operation_v<std::less<T>> = ComparisonOperation::Less;
+template <typename T>
+inline constexpr std::optional<ComparisonOperation> comparison_operation_v<std::less_equal<T>> = ComparisonOperation::LessEqual;
+template <typename T>
+inline constexpr std::optional<ComparisonOperation> comparison_operation_v<std::greater<T>> = ComparisonOperation::Greater;
+template <typename T>
+inline constexpr std::optional<ComparisonOperation> comparison_operation_v<std::greater_equal<T>> = ComparisonOperation::GreaterEqual;
+}
@@ -49,6 +49,8 @@ template <typename T, typename Operand>
 class unary_raster_operation_scalar
 {
 public:
+    using operation_type = Operand;
+
     unary_raster_operation_scalar(T scalar)
     : _scalarValue(scalar)
     {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gdx/cell.h"
+#include "gdx/cpudispatch.h"
 #include "gdx/cpupredicates-private.h"
 #include "gdx/exception.h"
 #include "gdx/nodatapredicates-private.h"
@@ -112,6 +113,15 @@ public:
         init_nodata_values();
     }
 
+    // Materialises a lazy raster expression (see denserasterexpression.h)
+    template <typename Expression, typename = typename Expression::raster_expression_tag>
+    DenseRaster(const Expression& expression)
+    : _meta(expression.metadata())
+    , _data(size_t(_meta.rows) * size_t(_meta.cols))
+    {
+        expression.evaluate_into(*this);
+    }
+
     DenseRaster(DenseRaster<T>&&) noexcept   = default;
     DenseRaster(const DenseRaster<T>& other) = delete;
 
@@ -851,6 +861,30 @@ public:
         return result;
     }
 
+    // Calls f(values, dataMask) with the simd vectors of the values in the index range [first, last)
+    // the mask selects the values that are not nodata
+    template <typename BinaryFunction>
+    void visit_data_simd(std::size_t first, std::size_t last, BinaryFunction f) const
+    {
+        static_assert(simd_supported(), "visit_data_simd called with a non supporting type");
+
+        if (!nodata().has_value()) {
+            simd::for_each(cbegin() + first, cbegin() + last, [&f](const auto& v) {
+                f(v, typename std::decay_t<decltype(v)>::mask_type(true));
+            });
+        } else {
+            if constexpr (raster_type_has_nan) {
+                simd::for_each(cbegin() + first, cbegin() + last, [&f](const auto& v) {
+                    f(v, !Vc::isnan(v));
+                });
+            } else {
+                simd::for_each(cbegin() + first, cbegin() + last, [&f, nod = *nodata()](const auto& v) {
+                    f(v, v != nod);
+                });
+            }
+        }
+    }
+
 private:
     std::size_t index(int32_t row, int32_t col) const
     {
@@ -885,16 +919,22 @@ private:
         static_assert(has_nan() && DenseRaster<TOther>::has_nan() && DenseRaster<TResult>::has_nan(), "floating point simd operation called with non floating point types");
         using IsDivision = std::conditional_t<std::is_same_v<BinaryPredicate, std::divides<>>, std::true_type, std::false_type>;
 
-        simd::transform(begin(), end(), other.begin(), result.begin(), [](const auto& v1, const auto& v2) {
-            auto w1  = Vc::simd_cast<Vc::Vector<TResult, typename std::decay_t<decltype(v1)>::abi>>(v1);
-            auto w2  = Vc::simd_cast<Vc::Vector<TResult, typename std::decay_t<decltype(v2)>::abi>>(v2);
-            auto res = BinaryPredicate()(w1, w2);
-            if constexpr (IsDivision::value) {
-                res(w2 == 0) = DenseRaster<TResult>::NaN;
-            }
+        // the runtime dispatched kernels use the widest registers of the processor, Vc the ones selected at build time
+        constexpr auto kernelOperation = cpu::arithmetic_operation_v<BinaryPredicate>;
+        if constexpr (std::is_same_v<T, TOther> && std::is_same_v<T, TResult> && kernelOperation.has_value()) {
+            cpu::arithmetic(*kernelOperation, data(), other.data(), result.data(), size());
+        } else {
+            simd::transform(begin(), end(), other.begin(), result.begin(), [](const auto& v1, const auto& v2) {
+                auto w1  = Vc::simd_cast<Vc::Vector<TResult, typename std::decay_t<decltype(v1)>::abi>>(v1);
+                auto w2  = Vc::simd_cast<Vc::Vector<TResult, typename std::decay_t<decltype(v2)>::abi>>(v2);
+                auto res = BinaryPredicate()(w1, w2);
+                if constexpr (IsDivision::value) {
+                    res(w2 == 0) = DenseRaster<TResult>::NaN;
+                }
 
-            return res;
-        });
+                return res;
+            });
+        }
     }
 
     template <typename BinaryPredicate, typename TOther, typename TResult>
@@ -1058,6 +1098,12 @@ private:
                 return BinaryPredicate()(value, scalar);
             });
         } else if (has_nan() || !nodata().has_value()) {
+            constexpr auto kernelOperation = cpu::arithmetic_operation_v<BinaryPredicate>;
+            if constexpr (std::is_same_v<ResultType, T> && cpu::has_kernels_v<T> && kernelOperation.has_value()) {
+                cpu::arithmetic_scalar(*kernelOperation, data(), static_cast<T>(scalar), result.data(), size());
+                return result;
+            }
+
             simd::transform(begin(), end(), result.begin(), [scalar](auto v) {
                 using ResultVectorType = Vc::Vector<ResultType, typename decltype(v)::abi>;
                 return BinaryPredicate()(Vc::simd_cast<ResultVectorType>(v), scalar);
@@ -1090,6 +1136,12 @@ private:
                 value = BinaryPredicate()(value, scalar);
             });
         } else if (has_nan() || !nodata().has_value()) {
+            constexpr auto kernelOperation = cpu::arithmetic_operation_v<BinaryPredicate>;
+            if constexpr (std::is_same_v<decltype(BinaryPredicate()(T(), TScalar())), T> && cpu::has_kernels_v<T> && kernelOperation.has_value()) {
+                cpu::arithmetic_scalar(*kernelOperation, data(), static_cast<T>(scalar), data(), size());
+                return *this;
+            }
+
             simd::for_each(begin(), end(), [scalar](auto& value) {
                 value = BinaryPredicate()(value, scalar);
             });
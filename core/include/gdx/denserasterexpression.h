@@ -0,0 +1,616 @@
+#pragma once
+
+#include "gdx/denseraster.h"
+#include "gdx/rasterchecks.h"
+#include "gdx/rasterutils-private.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+/* Lazy raster algebra on DenseRaster
+ * The operators on a lazy operand record the operation tree instead of computing a temporary raster for every operation.
+ * The tree is evaluated in chunks of cells when it is assigned to a DenseRaster, the intermediate results of a chunk stay
+ * in the cpu cache, so every input raster is read once and the result is written once.
+ * The nodata handling and the result types follow the eager DenseRaster operators.
+ *
+ * DenseRaster<uint8_t> result = (lazy(a) * w1 + lazy(b) * w2) / c > t;
+ *
+ * The left operand of an operator has to be an expression, the right operand can be an expression, a DenseRaster or a scalar.
+ * Expressions keep a reference to the rasters they operate on, evaluate them before the rasters go out of scope.
+ * Temporary rasters are rejected as operand: lazy(a) + b * 2 does not compile, use lazy(a) + lazy(b) * 2.
+ */
+
+namespace gdx {
+
+namespace detail {
+
+// Number of cells that are evaluated at once
+static constexpr std::size_t s_expressionChunkSize = 1024;
+
+template <typename T>
+using ExpressionChunk = std::array<T, s_expressionChunkSize>;
+
+template <typename T, typename = void>
+struct is_raster_expression : std::false_type
+{
+};
+
+template <typename T>
+struct is_raster_expression<T, std::void_t<typename T::raster_expression_tag>> : std::true_type
+{
+};
+
+template <typename T>
+inline constexpr bool is_raster_expression_v = is_raster_expression<T>::value;
+
+template <typename T>
+struct is_dense_raster : std::false_type
+{
+};
+
+template <typename T>
+struct is_dense_raster<DenseRaster<T>> : std::true_type
+{
+};
+
+// The left operand has to be an expression, the DenseRaster member operators take any right operand
+template <typename Lhs, typename Rhs>
+inline constexpr bool is_raster_expression_operation_v = is_raster_expression_v<Lhs> && (is_raster_expression_v<Rhs> || is_dense_raster<Rhs>::value);
+
+template <typename Expression, typename Scalar>
+inline constexpr bool is_raster_expression_scalar_operation_v = is_raster_expression_v<Expression> && std::is_arithmetic_v<Scalar>;
+
+// The cells that are not nodata in the data mask, nan values are always considered nodata
+template <typename T>
+void set_expression_data_mask(const T* values, std::size_t count, std::optional<double> nodata, uint8_t* dataMask)
+{
+    if constexpr (std::numeric_limits<T>::has_quiet_NaN) {
+        for (std::size_t i = 0; i < count; ++i) {
+            dataMask[i] = !std::isnan(values[i]);
+        }
+    } else if (nodata.has_value()) {
+        const auto nod = static_cast<T>(*nodata);
+        for (std::size_t i = 0; i < count; ++i) {
+            dataMask[i] = values[i] != nod;
+        }
+    } else {
+        std::fill_n(dataMask, count, uint8_t(1));
+    }
+}
+
+// Like the eager operators, a computed value that equals the nodata value is nodata in the following operations
+template <typename T>
+void update_expression_data_mask(const T* values, std::size_t count, std::optional<double> nodata, uint8_t* dataMask)
+{
+    if constexpr (std::numeric_limits<T>::has_quiet_NaN) {
+        for (std::size_t i = 0; i < count; ++i) {
+            dataMask[i] &= uint8_t(!std::isnan(values[i]));
+        }
+    } else if (nodata.has_value()) {
+        const auto nod = static_cast<T>(*nodata);
+        for (std::size_t i = 0; i < count; ++i) {
+            dataMask[i] &= uint8_t(values[i] != nod);
+        }
+    }
+}
+
+// Evaluates the operand chunk as values of the requested type
+template <typename TResult, typename Operand>
+void evaluate_operand_as(const Operand& operand, std::size_t first, std::size_t count, TResult* values, uint8_t* dataMask)
+{
+    using T = typename Operand::value_type;
+
+    if constexpr (std::is_same_v<T, TResult>) {
+        operand.evaluate(first, count, values, dataMask);
+    } else {
+        ExpressionChunk<T> operandValues;
+        operand.evaluate(first, count, operandValues.data(), dataMask);
+        std::transform(operandValues.data(), operandValues.data() + count, values, [](T value) {
+            return static_cast<TResult>(value);
+        });
+    }
+}
+
+template <typename Operation, typename T>
+void apply_expression_operation(const T* lhs, const T* rhs, std::size_t count, T* result)
+{
+    if constexpr (DenseRaster<T>::simd_supported()) {
+        simd::transform(lhs, lhs + count, rhs, result, [](const auto& v1, const auto& v2) {
+            return Operation()(v1, v2);
+        });
+    } else {
+        std::transform(lhs, lhs + count, rhs, result, Operation());
+    }
+}
+
+template <typename TResult>
+std::optional<double> arithmetic_expression_nodata(const RasterMetadata& lhs, const RasterMetadata& rhs)
+{
+    // same choice as assign_nodata_value for the eager operations
+    if (lhs.nodata.has_value()) {
+        return lhs.nodata;
+    }
+
+    if (rhs.nodata.has_value()) {
+        return find_best_nodata_value<TResult>(RasterMetadata(), rhs);
+    }
+
+    return {};
+}
+
+}
+
+// Common functionality of the expression nodes, Derived provides metadata() and evaluate()
+template <typename Derived>
+class RasterExpression
+{
+public:
+    using raster_expression_tag = void;
+
+    int32_t rows() const noexcept
+    {
+        return derived().metadata().rows;
+    }
+
+    int32_t cols() const noexcept
+    {
+        return derived().metadata().cols;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return std::size_t(rows()) * std::size_t(cols());
+    }
+
+    // Evaluates the expression chunk by chunk, the chunks are processed in parallel
+    template <typename T>
+    void evaluate_into(DenseRaster<T>& result) const
+    {
+        using value_type = typename Derived::value_type;
+        static_assert(std::is_same_v<T, value_type>, "The result raster type should match the expression value type");
+
+        throw_on_size_mismatch(*this, result);
+
+        const auto nodata       = derived().metadata().nodata;
+        const auto chunkCount   = int64_t((size() + detail::s_expressionChunkSize - 1) / detail::s_expressionChunkSize);
+        const auto writesNodata = DenseRaster<T>::has_nan() || nodata.has_value();
+        const auto nodataValue  = DenseRaster<T>::has_nan() ? DenseRaster<T>::NaN : static_cast<T>(nodata.value_or(0.0));
+
+#pragma omp parallel for schedule(static)
+        for (int64_t chunk = 0; chunk < chunkCount; ++chunk) {
+            const auto first = std::size_t(chunk) * detail::s_expressionChunkSize;
+            const auto count = std::min(detail::s_expressionChunkSize, size() - first);
+
+            detail::ExpressionChunk<uint8_t> dataMask;
+            derived().evaluate(first, count, result.data() + first, dataMask.data());
+
+            if (writesNodata) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    if (!dataMask[i]) {
+                        result[first + i] = nodataValue;
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const Derived& derived() const noexcept
+    {
+        return static_cast<const Derived&>(*this);
+    }
+};
+
+// A raster operand of an expression
+template <typename T>
+class RasterOperand : public RasterExpression<RasterOperand<T>>
+{
+public:
+    using value_type = T;
+
+    explicit RasterOperand(const DenseRaster<T>& ras)
+    : _ras(ras)
+    {
+    }
+
+    const RasterMetadata& metadata() const noexcept
+    {
+        return _ras.metadata();
+    }
+
+    // Stores the values of the cells [first, first + count) and whether they contain data
+    void evaluate(std::size_t first, std::size_t count, T* values, uint8_t* dataMask) const
+    {
+        std::copy_n(_ras.data() + first, count, values);
+        detail::set_expression_data_mask(values, count, _ras.metadata().nodata, dataMask);
+    }
+
+private:
+    const DenseRaster<T>& _ras;
+};
+
+// A scalar operand of an expression, the scalar is never nodata
+template <typename T>
+class ScalarOperand : public RasterExpression<ScalarOperand<T>>
+{
+public:
+    using value_type = T;
+
+    ScalarOperand(T value, const RasterMetadata& meta)
+    : _value(value)
+    , _meta(meta)
+    {
+        _meta.nodata.reset();
+    }
+
+    const RasterMetadata& metadata() const noexcept
+    {
+        return _meta;
+    }
+
+    void evaluate(std::size_t /*first*/, std::size_t count, T* values, uint8_t* dataMask) const
+    {
+        std::fill_n(values, count, _value);
+        std::fill_n(dataMask, count, uint8_t(1));
+    }
+
+private:
+    T _value;
+    RasterMetadata _meta;
+};
+
+/* Arithmetic operation on two operands, evaluated with the simd kernels in the TResult type
+ * The result is nodata when one of the operands is nodata, division by zero results in nodata
+ */
+template <typename Operation, typename TResult, typename Lhs, typename Rhs>
+class ArithmeticExpression : public RasterExpression<ArithmeticExpression<Operation, TResult, Lhs, Rhs>>
+{
+public:
+    using value_type = TResult;
+
+    ArithmeticExpression(Lhs lhs, Rhs rhs, std::optional<double> nodata)
+    : _lhs(std::move(lhs))
+    , _rhs(std::move(rhs))
+    , _meta(_lhs.metadata())
+    {
+        throw_on_size_mismatch(_lhs, _rhs);
+        _meta.nodata = nodata;
+    }
+
+    const RasterMetadata& metadata() const noexcept
+    {
+        return _meta;
+    }
+
+    void evaluate(std::size_t first, std::size_t count, TResult* values, uint8_t* dataMask) const
+    {
+        detail::ExpressionChunk<TResult> lhsValues, rhsValues;
+        detail::ExpressionChunk<uint8_t> rhsMask;
+
+        detail::evaluate_operand_as<TResult>(_lhs, first, count, lhsValues.data(), dataMask);
+        detail::evaluate_operand_as<TResult>(_rhs, first, count, rhsValues.data(), rhsMask.data());
+
+        for (std::size_t i = 0; i < count; ++i) {
+            dataMask[i] &= rhsMask[i];
+        }
+
+        if constexpr (std::is_same_v<Operation, std::divides<>>) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (rhsValues[i] == 0) {
+                    dataMask[i]  = 0;
+                    rhsValues[i] = 1;
+                }
+            }
+        }
+
+        detail::apply_expression_operation<Operation>(lhsValues.data(), rhsValues.data(), count, values);
+        detail::update_expression_data_mask(values, count, _meta.nodata, dataMask);
+    }
+
+private:
+    Lhs _lhs;
+    Rhs _rhs;
+    RasterMetadata _meta;
+};
+
+/* Comparison of two operands in the TCompare type, results in 0 or 1
+ * The result is nodata (255) when one of the operands is nodata
+ */
+template <typename Predicate, typename TCompare, typename Lhs, typename Rhs>
+class ComparisonExpression : public RasterExpression<ComparisonExpression<Predicate, TCompare, Lhs, Rhs>>
+{
+public:
+    using value_type = uint8_t;
+
+    ComparisonExpression(Lhs lhs, Rhs rhs)
+    : _lhs(std::move(lhs))
+    , _rhs(std::move(rhs))
+    , _meta(_lhs.metadata())
+    {
+        throw_on_size_mismatch(_lhs, _rhs);
+
+        _meta.nodata.reset();
+        if (_lhs.metadata().nodata.has_value() || _rhs.metadata().nodata.has_value()) {
+            _meta.nodata = std::numeric_limits<uint8_t>::max();
+        }
+    }
+
+    const RasterMetadata& metadata() const noexcept
+    {
+        return _meta;
+    }
+
+    void evaluate(std::size_t first, std::size_t count, uint8_t* values, uint8_t* dataMask) const
+    {
+        detail::ExpressionChunk<TCompare> lhsValues, rhsValues;
+        detail::ExpressionChunk<uint8_t> rhsMask;
+
+        detail::evaluate_operand_as<TCompare>(_lhs, first, count, lhsValues.data(), dataMask);
+        detail::evaluate_operand_as<TCompare>(_rhs, first, count, rhsValues.data(), rhsMask.data());
+
+        for (std::size_t i = 0; i < count; ++i) {
+            dataMask[i] &= rhsMask[i];
+            values[i] = dataMask[i] ? uint8_t(Predicate()(lhsValues[i], rhsValues[i])) : std::numeric_limits<uint8_t>::max();
+        }
+    }
+
+private:
+    Lhs _lhs;
+    Rhs _rhs;
+    RasterMetadata _meta;
+};
+
+// Starts a lazy expression on the raster, the raster has to outlive the expression
+template <typename T>
+RasterOperand<T> lazy(const DenseRaster<T>& ras)
+{
+    return RasterOperand<T>(ras);
+}
+
+template <typename T>
+RasterOperand<T> lazy(DenseRaster<T>&& ras) = delete;
+
+// Materialises the expression in a new raster
+template <typename Expression, typename = std::enable_if_t<detail::is_raster_expression_v<Expression>>>
+DenseRaster<typename Expression::value_type> evaluate(const Expression& expression)
+{
+    DenseRaster<typename Expression::value_type> result(expression.metadata());
+    expression.evaluate_into(result);
+    return result;
+}
+
+namespace detail {
+
+template <typename Operand>
+auto as_expression_operand(const Operand& operand)
+{
+    if constexpr (is_dense_raster<Operand>::value) {
+        return RasterOperand<typename Operand::value_type>(operand);
+    } else {
+        return operand;
+    }
+}
+
+template <typename Operation, typename Lhs, typename Rhs>
+auto make_arithmetic_expression(const Lhs& lhs, const Rhs& rhs)
+{
+    auto lhsOperand = as_expression_operand(lhs);
+    auto rhsOperand = as_expression_operand(rhs);
+
+    using T1 = typename decltype(lhsOperand)::value_type;
+    using T2 = typename decltype(rhsOperand)::value_type;
+
+    // same result types as the eager raster operations
+    if constexpr (std::is_same_v<Operation, std::divides<>>) {
+        using TResult = decltype(Operation()(1.f, std::common_type_t<T1, T2>()));
+        return ArithmeticExpression<Operation, TResult, decltype(lhsOperand), decltype(rhsOperand)>(lhsOperand, rhsOperand, DenseRaster<TResult>::NaN);
+    } else {
+        using TResult = decltype(Operation()(T1(), T2()));
+        return ArithmeticExpression<Operation, TResult, decltype(lhsOperand), decltype(rhsOperand)>(lhsOperand, rhsOperand,
+            arithmetic_expression_nodata<TResult>(lhsOperand.metadata(), rhsOperand.metadata()));
+    }
+}
+
+template <typename Operation, typename Expression, typename Scalar>
+auto make_scalar_arithmetic_expression(const Expression& expression, Scalar scalar)
+{
+    using T       = typename Expression::value_type;
+    using TResult = decltype(Operation()(T(), Scalar()));
+
+    if constexpr (std::is_same_v<Operation, std::divides<>>) {
+        if (scalar == 0) {
+            throw InvalidArgument("Division by zero");
+        }
+    }
+
+    return ArithmeticExpression<Operation, TResult, Expression, ScalarOperand<Scalar>>(expression, ScalarOperand<Scalar>(scalar, expression.metadata()), expression.metadata().nodata);
+}
+
+template <typename Operation, typename Scalar, typename Expression>
+auto make_scalar_first_arithmetic_expression(Scalar scalar, const Expression& expression)
+{
+    using T = typename Expression::value_type;
+
+    if constexpr (std::is_same_v<Operation, std::divides<>>) {
+        // division by a zero cell results in nodata, so the result always has nodata
+        using TResult = decltype(1.0f * T());
+        return ArithmeticExpression<Operation, TResult, ScalarOperand<Scalar>, Expression>(ScalarOperand<Scalar>(scalar, expression.metadata()), expression,
+            expression.metadata().nodata.has_value() ? expression.metadata().nodata : std::optional<double>(DenseRaster<TResult>::NaN));
+    } else {
+        using TResult = decltype(Operation()(Scalar(), T()));
+        return ArithmeticExpression<Operation, TResult, ScalarOperand<Scalar>, Expression>(ScalarOperand<Scalar>(scalar, expression.metadata()), expression, expression.metadata().nodata);
+    }
+}
+
+template <typename Predicate, typename Lhs, typename Rhs>
+auto make_comparison_expression(const Lhs& lhs, const Rhs& rhs)
+{
+    auto lhsOperand = as_expression_operand(lhs);
+    auto rhsOperand = as_expression_operand(rhs);
+
+    using TCompare = decltype(typename decltype(lhsOperand)::value_type() * typename decltype(rhsOperand)::value_type());
+    return ComparisonExpression<Predicate, TCompare, decltype(lhsOperand), decltype(rhsOperand)>(lhsOperand, rhsOperand);
+}
+
+template <typename Predicate, typename Expression, typename Scalar>
+auto make_scalar_comparison_expression(const Expression& expression, Scalar scalar)
+{
+    // the threshold is converted to the raster type, like the eager comparisons
+    using T = typename Expression::value_type;
+    return ComparisonExpression<Predicate, T, Expression, ScalarOperand<T>>(expression, ScalarOperand<T>(static_cast<T>(scalar), expression.metadata()));
+}
+
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<detail::is_raster_expression_operation_v<Lhs, Rhs>>>
+auto operator+(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::make_arithmetic_expression<std::plus<>>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<detail::is_raster_expression_operation_v<Lhs, Rhs>>>
+auto operator-(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::make_arithmetic_expression<std::minus<>>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<detail::is_raster_expression_operation_v<Lhs, Rhs>>>
+auto operator*(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::make_arithmetic_expression<std::multiplies<>>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<detail::is_raster_expression_operation_v<Lhs, Rhs>>>
+auto operator/(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::make_arithmetic_expression<std::divides<>>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<detail::is_raster_expression_operation_v<Lhs, Rhs>>>
+auto operator>(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::make_comparison_expression<std::greater<>>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<detail::is_raster_expression_operation_v<Lhs, Rhs>>>
+auto operator>=(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::make_comparison_expression<std::greater_equal<>>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<detail::is_raster_expression_operation_v<Lhs, Rhs>>>
+auto operator<(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::make_comparison_expression<std::less<>>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<detail::is_raster_expression_operation_v<Lhs, Rhs>>>
+auto operator<=(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::make_comparison_expression<std::less_equal<>>(lhs, rhs);
+}
+
+// The expressions keep a reference to their raster operands, so temporary rasters are not accepted
+template <typename Lhs, typename T, typename = std::enable_if_t<detail::is_raster_expression_v<Lhs>>>
+void operator+(const Lhs& lhs, DenseRaster<T>&& rhs) = delete;
+
+template <typename Lhs, typename T, typename = std::enable_if_t<detail::is_raster_expression_v<Lhs>>>
+void operator-(const Lhs& lhs, DenseRaster<T>&& rhs) = delete;
+
+template <typename Lhs, typename T, typename = std::enable_if_t<detail::is_raster_expression_v<Lhs>>>
+void operator*(const Lhs& lhs, DenseRaster<T>&& rhs) = delete;
+
+template <typename Lhs, typename T, typename = std::enable_if_t<detail::is_raster_expression_v<Lhs>>>
+void operator/(const Lhs& lhs, DenseRaster<T>&& rhs) = delete;
+
+template <typename Lhs, typename T, typename = std::enable_if_t<detail::is_raster_expression_v<Lhs>>>
+void operator>(const Lhs& lhs, DenseRaster<T>&& rhs) = delete;
+
+template <typename Lhs, typename T, typename = std::enable_if_t<detail::is_raster_expression_v<Lhs>>>
+void operator>=(const Lhs& lhs, DenseRaster<T>&& rhs) = delete;
+
+template <typename Lhs, typename T, typename = std::enable_if_t<detail::is_raster_expression_v<Lhs>>>
+void operator<(const Lhs& lhs, DenseRaster<T>&& rhs) = delete;
+
+template <typename Lhs, typename T, typename = std::enable_if_t<detail::is_raster_expression_v<Lhs>>>
+void operator<=(const Lhs& lhs, DenseRaster<T>&& rhs) = delete;
+
+template <typename Expression, typename Scalar, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator+(const Expression& expression, Scalar scalar)
+{
+    return detail::make_scalar_arithmetic_expression<std::plus<>>(expression, scalar);
+}
+
+template <typename Expression, typename Scalar, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator-(const Expression& expression, Scalar scalar)
+{
+    return detail::make_scalar_arithmetic_expression<std::minus<>>(expression, scalar);
+}
+
+template <typename Expression, typename Scalar, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator*(const Expression& expression, Scalar scalar)
+{
+    return detail::make_scalar_arithmetic_expression<std::multiplies<>>(expression, scalar);
+}
+
+template <typename Expression, typename Scalar, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator/(const Expression& expression, Scalar scalar)
+{
+    return detail::make_scalar_arithmetic_expression<std::divides<>>(expression, scalar);
+}
+
+template <typename Scalar, typename Expression, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator+(Scalar scalar, const Expression& expression)
+{
+    return detail::make_scalar_first_arithmetic_expression<std::plus<>>(scalar, expression);
+}
+
+template <typename Scalar, typename Expression, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator-(Scalar scalar, const Expression& expression)
+{
+    return detail::make_scalar_first_arithmetic_expression<std::minus<>>(scalar, expression);
+}
+
+template <typename Scalar, typename Expression, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator*(Scalar scalar, const Expression& expression)
+{
+    return detail::make_scalar_first_arithmetic_expression<std::multiplies<>>(scalar, expression);
+}
+
+template <typename Scalar, typename Expression, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator/(Scalar scalar, const Expression& expression)
+{
+    return detail::make_scalar_first_arithmetic_expression<std::divides<>>(scalar, expression);
+}
+
+template <typename Expression, typename Scalar, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator>(const Expression& expression, Scalar scalar)
+{
+    return detail::make_scalar_comparison_expression<std::greater<>>(expression, scalar);
+}
+
+template <typename Expression, typename Scalar, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator>=(const Expression& expression, Scalar scalar)
+{
+    return detail::make_scalar_comparison_expression<std::greater_equal<>>(expression, scalar);
+}
+
+template <typename Expression, typename Scalar, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator<(const Expression& expression, Scalar scalar)
+{
+    return detail::make_scalar_comparison_expression<std::less<>>(expression, scalar);
+}
+
+template <typename Expression, typename Scalar, typename = std::enable_if_t<detail::is_raster_expression_scalar_operation_v<Expression, Scalar>>>
+auto operator<=(const Expression& expression, Scalar scalar)
+{
+    return detail::make_scalar_comparison_expression<std::less_equal<>>(expression, scalar);
+}
+
+}
@@ -8,7 +8,14 @@
 #include "infra/gdalalgo.h"
 #include "infra/gdalio.h"
 
+#include <gdal.h>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace gdx {
 
@@ -95,25 +102,93 @@ const RasterMetadata& read_raster(const fs::path& filename, const RasterMetadata
     return raster.metadata();
 }
 
+namespace detail {
+
+// Number of cells that are converted per chunk when writing rasters that store their nodata values as NaN
+static constexpr size_t s_writeChunkCells = 1 << 20;
+
+// Floating point rasters store nodata as NaN, on disk the NaNs have to be replaced by the nodata value
 template <typename T>
-void write_raster(const DenseRaster<T>& raster, const fs::path& filename, std::span<const std::string> driverOptions = {})
+bool needs_nodata_conversion(const std::optional<double>& nodata)
 {
-    auto copy = raster.copy();
-    copy.collapse_data();
-    inf::gdal::io::write_raster(std::span<const T>(copy), copy.metadata(), filename, driverOptions);
+    if constexpr (DenseRaster<T>::raster_type_has_nan) {
+        return nodata.has_value() && !std::isnan(*nodata);
+    } else {
+        return false;
+    }
 }
 
+// Writes the raster rows to the band starting at raster row firstRow, NaN values are written as the nodata value
+// When nodata conversion is needed the rows are converted in chunks of at most s_writeChunkCells cells
+// so the raster does not have to be copied and the conversion happens while the data is passed to gdal
 template <typename T>
-void write_raster_to_dataset_band(DenseRaster<T>&& raster, inf::gdal::RasterDataSet& ds, int bandNr)
+void write_rows_to_dataset_band(const DenseRaster<T>& raster, const std::optional<double>& nodata, inf::gdal::RasterDataSet& ds, int bandNr, int32_t firstRow)
 {
-    raster.collapse_data();
-    inf::gdal::io::write_raster(std::span<const T>(raster), raster.metadata(), ds, bandNr);
+    const auto rows = raster.rows();
+    const auto cols = raster.cols();
+
+    if (!needs_nodata_conversion<T>(nodata)) {
+        ds.write_rasterdata(bandNr, 0, firstRow, cols, rows, raster.data(), cols, rows);
+        return;
+    }
+
+    const auto nodataValue = static_cast<T>(*nodata);
+    const auto chunkRows   = std::clamp(int32_t(s_writeChunkCells / std::max<size_t>(size_t(cols), 1)), 1, std::max(rows, 1));
+    std::vector<T> buffer(size_t(chunkRows) * size_t(cols));
+
+    for (int32_t row = 0; row < rows; row += chunkRows) {
+        const auto currentRows = std::min(chunkRows, rows - row);
+        const auto begin       = raster.data() + size_t(row) * size_t(cols);
+        std::transform(begin, begin + size_t(currentRows) * size_t(cols), buffer.begin(), [nodataValue](T value) {
+            return std::isnan(value) ? nodataValue : value;
+        });
+
+        ds.write_rasterdata(bandNr, 0, firstRow + row, cols, currentRows, buffer.data(), cols, currentRows);
+    }
+}
+
+}
+
+template <typename T>
+void write_raster(const DenseRaster<T>& raster, const fs::path& filename, std::span<const std::string> driverOptions = {})
+{
+    const auto& meta = raster.metadata();
+    if (!detail::needs_nodata_conversion<T>(meta.nodata)) {
+        inf::gdal::io::write_raster(std::span<const T>(raster), meta, filename, driverOptions);
+        return;
+    }
+
+    auto driver = inf::gdal::RasterDriver::create(filename);
+    if (GDALGetMetadataItem(driver.get(), GDAL_DCAP_CREATE, nullptr) == nullptr) {
+        // Formats that only support CreateCopy (e.g. png) need the complete converted raster
+        auto copy = raster.copy();
+        copy.collapse_data();
+        inf::gdal::io::write_raster(std::span<const T>(copy), copy.metadata(), filename, driverOptions);
+        return;
+    }
+
+    auto dataSet = driver.template create_dataset<T>(meta.rows, meta.cols, 1, filename, driverOptions);
+    dataSet.write_geometadata(meta);
+    detail::write_rows_to_dataset_band(raster, meta.nodata, dataSet, 1, 0);
 }
 
 template <typename T>
 void write_raster_to_dataset_band(const DenseRaster<T>& raster, inf::gdal::RasterDataSet& ds, int bandNr)
 {
-    return write_raster_to_dataset_band(raster.copy(), ds, bandNr);
+    if (!detail::needs_nodata_conversion<T>(raster.metadata().nodata)) {
+        inf::gdal::io::write_raster(std::span<const T>(raster), raster.metadata(), ds, bandNr);
+        return;
+    }
+
+    ds.write_geometadata(raster.metadata());
+    detail::write_rows_to_dataset_band(raster, raster.metadata().nodata, ds, bandNr, 0);
+}
+
+template <typename T>
+void write_raster_to_dataset_band(DenseRaster<T>&& raster, inf::gdal::RasterDataSet& ds, int bandNr)
+{
+    raster.collapse_data();
+    inf::gdal::io::write_raster(std::span<const T>(raster), raster.metadata(), ds, bandNr);
 }
 
 template <typename T>
@@ -123,6 +198,156 @@ void write_raster(DenseRaster<T>&& raster, const fs::path& filename, std::span<c
     inf::gdal::io::write_raster(std::span<const T>(raster), raster.metadata(), filename, driverOptions);
 }
 
+// Strip of consecutive raster rows, used for streaming raster processing
+// The data contains the requested halo rows above and below the strip (when available on the raster)
+template <typename T>
+struct RasterStrip
+{
+    DenseRaster<T> data;
+    int32_t firstRow   = 0; // raster row of the first strip row (excluding the halo)
+    int32_t rows       = 0; // number of strip rows (excluding the halo)
+    int32_t haloTop    = 0;
+    int32_t haloBottom = 0;
+};
+
+// Metadata of the rows [firstRow, firstRow + rows) of the raster
+inline RasterMetadata row_window_metadata(const RasterMetadata& meta, int32_t firstRow, int32_t rows)
+{
+    auto result = meta;
+    result.rows = rows;
+    result.yll  = meta.yll + (meta.rows - (firstRow + rows)) * std::abs(meta.cellSize.y);
+    return result;
+}
+
+// Reads a raster strip by strip so the memory usage is bounded by the strip size instead of the raster size
+// By default the strip height is the gdal block height of the band (at least 64 rows to limit the halo overhead)
+template <typename T>
+class DenseRasterStripReader
+{
+public:
+    DenseRasterStripReader(const fs::path& filename, int32_t haloRows = 0, int32_t stripRows = 0)
+    : _dataSet(inf::gdal::RasterDataSet::open(filename))
+    , _meta(inf::gdal::io::read_metadata(filename))
+    , _haloRows(haloRows)
+    , _stripRows(stripRows)
+    {
+        if (haloRows < 0) {
+            throw InvalidArgument("Halo rows can not be negative");
+        }
+
+        if (_stripRows <= 0) {
+            int blockCols = 0, blockRows = 0;
+            GDALGetBlockSize(GDALGetRasterBand(_dataSet.get(), 1), &blockCols, &blockRows);
+            blockRows  = std::max(blockRows, 1);
+            _stripRows = blockRows * ((64 + blockRows - 1) / blockRows);
+        }
+    }
+
+    const RasterMetadata& metadata() const noexcept
+    {
+        return _meta;
+    }
+
+    int32_t strip_rows() const noexcept
+    {
+        return _stripRows;
+    }
+
+    // Reads the next strip, returns false when all the rows have been read
+    bool read_next(RasterStrip<T>& strip)
+    {
+        if (_currentRow >= _meta.rows) {
+            return false;
+        }
+
+        strip.firstRow   = _currentRow;
+        strip.rows       = std::min(_stripRows, _meta.rows - _currentRow);
+        strip.haloTop    = std::min(_haloRows, strip.firstRow);
+        strip.haloBottom = std::min(_haloRows, _meta.rows - (strip.firstRow + strip.rows));
+
+        auto extent = row_window_metadata(_meta, strip.firstRow - strip.haloTop, strip.haloTop + strip.rows + strip.haloBottom);
+        strip.data  = DenseRaster<T>(extent);
+        strip.data.set_metadata(inf::gdal::io::read_raster_data<T>(_dataSet, extent, strip.data));
+        strip.data.init_nodata_values();
+
+        _currentRow += strip.rows;
+        return true;
+    }
+
+private:
+    inf::gdal::RasterDataSet _dataSet;
+    RasterMetadata _meta;
+    int32_t _haloRows;
+    int32_t _stripRows;
+    int32_t _currentRow = 0;
+};
+
+// Writes a raster strip by strip, the strips can be written in any order
+// The output format needs to support random write access (e.g. GeoTiff)
+template <typename T>
+class DenseRasterStripWriter
+{
+public:
+    DenseRasterStripWriter(const fs::path& filename, const RasterMetadata& meta, std::span<const std::string> driverOptions = {})
+    : _dataSet(inf::gdal::RasterDriver::create(filename).template create_dataset<T>(meta.rows, meta.cols, 1, filename, driverOptions))
+    , _meta(meta)
+    {
+        _dataSet.write_geometadata(meta);
+    }
+
+    const RasterMetadata& metadata() const noexcept
+    {
+        return _meta;
+    }
+
+    // Writes the rows of the strip data starting at raster row firstRow
+    void write(const DenseRaster<T>& stripData, int32_t firstRow)
+    {
+        if (stripData.cols() != _meta.cols || firstRow < 0 || firstRow + stripData.rows() > _meta.rows) {
+            throw InvalidArgument("Strip of {}x{} at row {} does not fit in the raster of {}x{}", stripData.rows(), stripData.cols(), firstRow, _meta.rows, _meta.cols);
+        }
+
+        detail::write_rows_to_dataset_band(stripData, _meta.nodata, _dataSet, 1, firstRow);
+    }
+
+    // Writes the strip rows, the halo rows are not written
+    void write(const RasterStrip<T>& strip)
+    {
+        if (strip.haloTop == 0 && strip.haloBottom == 0) {
+            write(strip.data, strip.firstRow);
+            return;
+        }
+
+        DenseRaster<T> rows(row_window_metadata(_meta, strip.firstRow, strip.rows));
+        std::copy_n(strip.data.data() + size_t(strip.haloTop) * size_t(_meta.cols), rows.size(), rows.data());
+        write(rows, strip.firstRow);
+    }
+
+private:
+    inf::gdal::RasterDataSet _dataSet;
+    RasterMetadata _meta;
+};
+
+// Streams the input raster strip by strip through the callback and writes the resulting strips to the output raster
+// The callback receives a RasterStrip<TIn> (including the requested halo rows) and returns a DenseRaster<TOut>
+// containing only the strip rows. Peak memory is bounded by the strip size instead of the raster size.
+template <typename TOut, typename TIn, typename Callable>
+void process_raster_strips(const fs::path& input, const fs::path& output, int32_t haloRows, Callable&& cb, std::span<const std::string> driverOptions = {})
+{
+    DenseRasterStripReader<TIn> reader(input, haloRows);
+    DenseRasterStripWriter<TOut> writer(output, reader.metadata(), driverOptions);
+
+    RasterStrip<TIn> strip;
+    while (reader.read_next(strip)) {
+        DenseRaster<TOut> result = cb(std::as_const(strip));
+        if (result.rows() != strip.rows || result.cols() != strip.data.cols()) {
+            throw RuntimeError("Strip processing should return {}x{} cells, got {}x{}", strip.rows, strip.data.cols(), result.rows(), result.cols());
+        }
+
+        writer.write(result, strip.firstRow);
+    }
+}
+
 template <typename T>
 DenseRaster<T> warp_raster(const DenseRaster<T>& raster, const std::string& destProjection, inf::gdal::ResampleAlgorithm algo = inf::gdal::ResampleAlgorithm::NearestNeighbour)
 {
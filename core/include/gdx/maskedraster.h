@@ -3,8 +3,10 @@
 #include "cpupredicates-private.h"
 #include "eigeniterationsupport-private.h"
 #include "gdx/cell.h"
+#include "gdx/cpudispatch.h"
 #include "gdx/exception.h"
 #include "gdx/maskedrasteriterator.h"
+#include "gdx/nodatamask.h"
 #include "gdx/rasterchecks.h"
 #include "gdx/rastermetadata.h"
 #include "infra/cast.h"
@@ -13,24 +15,27 @@
 #include <Eigen/Core>
 #include <algorithm>
 #include <cassert>
+#include <utility>
 #include <vector>
 
 namespace gdx {
 
-using mask_type = Eigen::Array<bool, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+using mask_type = NodataMask;
 
 inline mask_type combine_mask(const mask_type& lhs, const mask_type& rhs)
 {
-    if (rhs.size() == 0) {
+    if (rhs.size() == 0 || (lhs.size() != 0 && !rhs.any())) {
         return lhs;
     }
 
-    if (lhs.size() == 0) {
+    if (lhs.size() == 0 || !lhs.any()) {
         return rhs;
     }
 
     assert(lhs.size() == rhs.size());
-    return lhs || rhs;
+    auto result = lhs;
+    result |= rhs;
+    return result;
 }
 
 template <typename T>
@@ -68,8 +73,7 @@ public:
     , _data(_meta.rows, _meta.cols)
     {
         if (meta.nodata.has_value()) {
-            _nodataMask.resize(meta.rows, meta.cols);
-            _nodataMask.fill(false);
+            _nodataMask = mask_type(meta.rows, meta.cols);
         }
     }
 
@@ -111,7 +115,7 @@ public:
     MaskedRaster(const RasterMetadata& meta, mask_type&& mask)
     : _meta(meta)
     , _data(meta.rows, meta.cols)
-    , _nodataMask(mask)
+    , _nodataMask(std::move(mask))
     {
     }
 
@@ -124,15 +128,15 @@ public:
 
     MaskedRaster(const RasterMetadata& meta, data_type&& data)
     : _meta(meta)
-    , _data(data)
+    , _data(std::move(data))
     {
     }
 
     template <typename Data, typename Mask>
     MaskedRaster(const RasterMetadata& meta, Data&& data, Mask&& mask)
     : _meta(meta)
-    , _data(data)
-    , _nodataMask(mask)
+    , _data(std::forward<Data>(data))
+    , _nodataMask(std::forward<Mask>(mask))
     {
     }
 
@@ -228,14 +232,15 @@ public:
         return _data.data();
     }
 
-    const mask_value_type* mask() const noexcept
+    // Read only access to the mask, nullptr if none of the cells is nodata so the mask checks can be skipped
+    const mask_type* mask() const noexcept
     {
-        return _nodataMask.size() == 0 ? nullptr : _nodataMask.data();
+        return _nodataMask.any() ? &_nodataMask : nullptr;
     }
 
-    mask_value_type* mask() noexcept
+    mask_type* mask() noexcept
     {
-        return _nodataMask.size() == 0 ? nullptr : _nodataMask.data();
+        return _nodataMask.size() == 0 ? nullptr : &_nodataMask;
     }
 
     bool has_nodata() const noexcept
@@ -296,14 +301,14 @@ public:
 
     void collapse_data()
     {
-        if (_nodataMask.size() == 0) {
+        if (!_nodataMask.any()) {
             return;
         }
 
         assert(_meta.nodata.has_value());
         auto nodata = static_cast<value_type>(_meta.nodata.value());
-        std::transform(Eigen::begin(_nodataMask), Eigen::end(_nodataMask), Eigen::begin(_data), Eigen::begin(_data), [nodata](bool mask, value_type value) {
-            return mask ? nodata : value;
+        _nodataMask.for_each_nodata([this, nodata](mask_type::Index index) {
+            _data(index) = nodata;
         });
     }
 
@@ -388,23 +393,23 @@ public:
         return _meta.cols;
     }
 
+    // The mark_as_nodata and mark_as_data functions are not thread safe, not even for different cells: the cells share the
+    // words of the packed nodata mask. Parallel loops set the nodata cells with mask_data().set_block.
     void mark_as_nodata(std::size_t index)
     {
         if (_nodataMask.size() == 0) {
-            _nodataMask.resize(rows(), cols());
-            _nodataMask.fill(false);
+            _nodataMask = mask_type(rows(), cols());
         }
-        _nodataMask(index) = true;
+        _nodataMask.set(mask_type::Index(index), true);
     }
 
     void mark_as_nodata(int32_t row, int32_t col)
     {
         if (_nodataMask.size() == 0) {
-            _nodataMask.resize(rows(), cols());
-            _nodataMask.fill(false);
+            _nodataMask = mask_type(rows(), cols());
         }
 
-        _nodataMask(row, col) = true;
+        _nodataMask.set(row, col, true);
     }
 
     void mark_as_nodata(Cell cell)
@@ -414,15 +419,15 @@ public:
 
     void mark_as_data(std::size_t index)
     {
-        if (_nodataMask.size() > 0) {
-            _nodataMask(index) = false;
+        if (_nodataMask.any()) {
+            _nodataMask.set(mask_type::Index(index), false);
         }
     }
 
     void mark_as_data(Cell cell)
     {
-        if (_nodataMask.size() > 0) {
-            _nodataMask(cell.r, cell.c) = false;
+        if (_nodataMask.any()) {
+            _nodataMask.set(cell.r, cell.c, false);
         }
     }
 
@@ -453,7 +458,7 @@ public:
     bool is_nodata(std::size_t index) const noexcept
     {
         assert(_nodataMask.size() == 0 || inf::truncate<mask_type::Index>(index) < _nodataMask.size());
-        return _nodataMask.size() != 0 && _nodataMask(index);
+        return _nodataMask.any() && _nodataMask(mask_type::Index(index));
     }
 
     bool is_nodata(const Cell& cell) const noexcept
@@ -463,7 +468,7 @@ public:
 
     bool is_nodata(int32_t r, int32_t c) const noexcept
     {
-        return _nodataMask.size() != 0 && _nodataMask(r, c);
+        return _nodataMask.any() && _nodataMask(r, c);
     }
 
     bool tolerant_equal_to(const MaskedRaster<T>& other, value_type tolerance = std::numeric_limits<value_type>::epsilon()) const noexcept
@@ -866,13 +871,13 @@ public:
 private:
     static mask_type mask_from_data(const data_type& data, std::optional<double> nodata)
     {
-        mask_type mask(data.rows(), data.cols());
+        mask_type mask(int32_t(data.rows()), int32_t(data.cols()));
         if (!nodata.has_value()) {
-            mask.fill(false);
             return mask;
         }
 
-        std::transform(Eigen::begin(data), Eigen::end(data), Eigen::begin(mask), [nd = static_cast<T>(*nodata)](T value) {
+        mask.assign([&data, nd = static_cast<T>(*nodata)](mask_type::Index index) {
+            const auto value = data(index);
             if constexpr (raster_type_has_nan) {
                 return value == nd || std::isnan(value);
             } else {
@@ -905,11 +910,16 @@ private:
             result.set_nodata(static_cast<double>(std::numeric_limits<uint8_t>::max()));
         }
 
-        auto pred       = BinaryPredicate<T>();
-        const auto size = result.size();
+        constexpr auto kernelOperation = cpu::comparison_operation_v<BinaryPredicate<T>>;
+        if constexpr (cpu::has_kernels_v<T> && kernelOperation.has_value()) {
+            cpu::compare_scalar(*kernelOperation, data(), static_cast<T>(value), result.data(), result.size());
+        } else {
+            auto pred       = BinaryPredicate<T>();
+            const auto size = result.size();
 #pragma omp parallel for
-        for (std::size_t i = 0; i < size; ++i) {
-            result[i] = pred(_data(i), static_cast<T>(value));
+            for (std::size_t i = 0; i < size; ++i) {
+                result[i] = pred(_data(i), static_cast<T>(value));
+            }
         }
         return result;
     }
@@ -937,11 +947,17 @@ private:
             result.set_nodata(std::numeric_limits<uint8_t>::max());
         }
 
-        auto pred          = BinaryPredicate<WidestType>();
-        const int32_t size = static_cast<int32_t>(result.size());
+        // comparing in the widest type gives the same result, so equal types can use the kernels
+        constexpr auto kernelOperation = cpu::comparison_operation_v<BinaryPredicate<WidestType>>;
+        if constexpr (std::is_same_v<T, TOther> && cpu::has_kernels_v<T> && kernelOperation.has_value()) {
+            cpu::compare(*kernelOperation, data(), other.data(), result.data(), result.size());
+        } else {
+            auto pred          = BinaryPredicate<WidestType>();
+            const int32_t size = static_cast<int32_t>(result.size());
 #pragma omp parallel for
-        for (int32_t i = 0; i < size; ++i) {
-            result[i] = pred(static_cast<WidestType>(_data(i)), static_cast<WidestType>(other[i]));
+            for (int32_t i = 0; i < size; ++i) {
+                result[i] = pred(static_cast<WidestType>(_data(i)), static_cast<WidestType>(other[i]));
+            }
         }
         return result;
     }
@@ -950,9 +966,14 @@ private:
     auto perform_scalar_operation(TScalar scalar) const
     {
         using WidestType = decltype(T() * TScalar());
-        auto pred        = UnaryPredicate<WidestType>(static_cast<WidestType>(scalar));
         MaskedRaster<WidestType> result(_meta, _nodataMask);
-        std::transform(cbegin(), cend(), result.begin(), pred);
+
+        constexpr auto kernelOperation = cpu::arithmetic_operation_v<typename UnaryPredicate<WidestType>::operation_type>;
+        if constexpr (std::is_same_v<T, WidestType> && cpu::has_kernels_v<T> && kernelOperation.has_value()) {
+            cpu::arithmetic_scalar(*kernelOperation, data(), static_cast<T>(scalar), result.data(), result.size());
+        } else {
+            std::transform(cbegin(), cend(), result.begin(), UnaryPredicate<WidestType>(static_cast<WidestType>(scalar)));
+        }
         return result;
     }
 
@@ -965,9 +986,14 @@ private:
             result.set_nodata(*other.metadata().nodata);
         }
 
-        auto operation = BinaryPredicate<WidestType>();
-        for (std::size_t i = 0; i < size(); ++i) {
-            result[i] = operation(static_cast<WidestType>(_data(i)), static_cast<WidestType>(other[i]));
+        constexpr auto kernelOperation = cpu::arithmetic_operation_v<BinaryPredicate<WidestType>>;
+        if constexpr (std::is_same_v<T, TOther> && std::is_same_v<T, WidestType> && cpu::has_kernels_v<T> && kernelOperation.has_value()) {
+            cpu::arithmetic(*kernelOperation, data(), other.data(), result.data(), result.size());
+        } else {
+            auto operation = BinaryPredicate<WidestType>();
+            for (std::size_t i = 0; i < size(); ++i) {
+                result[i] = operation(static_cast<WidestType>(_data(i)), static_cast<WidestType>(other[i]));
+            }
         }
 
         return result;
@@ -18,15 +18,15 @@ using MissingValueMaskIterator = MissingValueIterator<T, is_const, MaskValueProx
 template <typename T>
 using MissingValueMaskConstIterator = MissingValueMaskIterator<T, true>;
 
-template <typename TData, bool is_const, typename TMask = bool>
-using MaskSkippingIterator = RasterIterator<TData, is_const, NodataMaskFilterPolicy<TData, TMask, is_const>, AllLocationsFilterPolicy, MaskValueProxy<TData, is_const>>;
+template <typename TData, bool is_const>
+using MaskSkippingIterator = RasterIterator<TData, is_const, NodataMaskFilterPolicy<TData, is_const>, AllLocationsFilterPolicy, MaskValueProxy<TData, is_const>>;
 
-template <typename TData, typename TMask = bool>
-using MaskSkippingConstIterator = MaskSkippingIterator<TData, true, TMask>;
+template <typename TData>
+using MaskSkippingConstIterator = MaskSkippingIterator<TData, true>;
 
 // NoData concept for a container type C
-// C::mask_value_type                                   type of the nodata mask
-// const mask_value_type* C::mask() const noexcept      function that returns the mask pointer
+// C::mask_value_type                                   value type of a cell in the nodata mask
+// const NodataMask* C::mask() const noexcept           function that returns the nodata mask (nullptr if there is no nodata)
 
 // supports skipping over containers that implement the masked nodata concept
 template <
@@ -36,10 +36,8 @@ auto value_begin(Container&& rasterData)
 {
     constexpr bool isConst = std::is_const_v<std::remove_reference_t<Container>>;
 
-    using Raster       = std::decay_t<Container>;
-    using T            = typename Raster::value_type;
-    using TMask        = typename Raster::mask_value_type;
-    using NodataPolicy = NodataMaskFilterPolicy<T, TMask, isConst>;
+    using T            = typename std::decay_t<Container>::value_type;
+    using NodataPolicy = NodataMaskFilterPolicy<T, isConst>;
 
     return MaskSkippingIterator<T, isConst>(
         rasterData.data(),
@@ -65,8 +63,7 @@ template <
 auto value_cbegin(Container&& data)
 {
     using T            = typename std::decay_t<Container>::value_type;
-    using TMask        = typename std::decay_t<Container>::mask_value_type;
-    using NodataPolicy = NodataMaskFilterPolicy<T, TMask, true>;
+    using NodataPolicy = NodataMaskFilterPolicy<T, true>;
 
     return MaskSkippingConstIterator<T>(data.data(), data.rows(), data.cols(), NodataPolicy(data.data(), data.mask()), AllLocationsFilterPolicy());
 }
@@ -207,13 +207,12 @@ template <
 auto neighbouring_cells_square(Container&& raster, Cell center, int32_t radius)
 {
     using T                = typename std::decay_t<Container>::value_type;
-    using TMask            = typename std::decay_t<Container>::mask_value_type;
     constexpr bool isConst = std::is_const_v<std::remove_reference_t<Container>>;
 
     auto areaInfo = detail::clip_area_to_raster(raster, center, radius);
-    NodataMaskFilterPolicy<T, TMask, isConst> valueFilter(raster.data(), raster.mask());
+    NodataMaskFilterPolicy<T, isConst> valueFilter(raster.data(), raster.mask());
     SingleCellLocationFilterPolicy locationFilter(center);
-    return RasterArea<T, isConst, NodataMaskFilterPolicy<T, TMask, isConst>, SingleCellLocationFilterPolicy, MaskValueProxy<T, isConst>>(raster.data(), areaInfo.topLeftPtr, areaInfo.rows, areaInfo.cols, raster.cols(), valueFilter, locationFilter);
+    return RasterArea<T, isConst, NodataMaskFilterPolicy<T, isConst>, SingleCellLocationFilterPolicy, MaskValueProxy<T, isConst>>(raster.data(), areaInfo.topLeftPtr, areaInfo.rows, areaInfo.cols, raster.cols(), valueFilter, locationFilter);
 }
 
 template <
@@ -243,12 +242,11 @@ template <
 auto cells_square(Container&& raster, Cell center, int32_t radius)
 {
     using T                = typename std::decay_t<Container>::value_type;
-    using TMask            = typename std::decay_t<Container>::mask_value_type;
     constexpr bool isConst = std::is_const_v<std::remove_reference_t<Container>>;
 
     auto areaInfo = detail::clip_area_to_raster(raster, center, radius);
-    NodataMaskFilterPolicy<T, TMask, isConst> valueFilter(raster.data(), raster.mask());
-    return RasterArea<T, isConst, NodataMaskFilterPolicy<T, TMask, isConst>, AllLocationsFilterPolicy, MaskValueProxy<T, isConst>>(raster.data(), areaInfo.topLeftPtr, areaInfo.rows, areaInfo.cols, raster.cols(), valueFilter, AllLocationsFilterPolicy());
+    NodataMaskFilterPolicy<T, isConst> valueFilter(raster.data(), raster.mask());
+    return RasterArea<T, isConst, NodataMaskFilterPolicy<T, isConst>, AllLocationsFilterPolicy, MaskValueProxy<T, isConst>>(raster.data(), areaInfo.topLeftPtr, areaInfo.rows, areaInfo.cols, raster.cols(), valueFilter, AllLocationsFilterPolicy());
 }
 
 template <
@@ -287,14 +285,13 @@ template <
 auto neighbouring_cells_circular(Container&& raster, Cell center, int radius)
 {
     using T                = typename std::decay_t<Container>::value_type;
-    using TMask            = typename std::decay_t<Container>::mask_value_type;
     constexpr bool isConst = std::is_const_v<std::remove_reference_t<Container>>;
 
     auto areaInfo = detail::clip_area_to_raster(raster, center, radius);
-    NodataMaskFilterPolicy<T, TMask, isConst> valueFilter(raster.data(), raster.mask());
+    NodataMaskFilterPolicy<T, isConst> valueFilter(raster.data(), raster.mask());
     CircularLocationFilterPolicy<CenterCellHandling::Exclude> locationFilter(center, radius);
 
-    return RasterArea<T, isConst, NodataMaskFilterPolicy<T, TMask, isConst>, CircularLocationFilterPolicy<CenterCellHandling::Exclude>, MaskValueProxy<T, isConst>>(
+    return RasterArea<T, isConst, NodataMaskFilterPolicy<T, isConst>, CircularLocationFilterPolicy<CenterCellHandling::Exclude>, MaskValueProxy<T, isConst>>(
         raster.data(),
         areaInfo.topLeftPtr,
         areaInfo.rows,
@@ -338,14 +335,13 @@ template <
 auto cells_circular(Container&& raster, Cell center, int radius)
 {
     using T                = typename std::decay_t<Container>::value_type;
-    using TMask            = typename std::decay_t<Container>::mask_value_type;
     constexpr bool isConst = std::is_const_v<std::remove_reference_t<Container>>;
 
     auto areaInfo = detail::clip_area_to_raster(raster, center, radius);
-    NodataMaskFilterPolicy<T, TMask, isConst> valueFilter(raster.data(), raster.mask());
+    NodataMaskFilterPolicy<T, isConst> valueFilter(raster.data(), raster.mask());
     CircularLocationFilterPolicy<CenterCellHandling::Include> locationFilter(center, radius);
 
-    return RasterArea<T, isConst, NodataMaskFilterPolicy<T, TMask, isConst>, CircularLocationFilterPolicy<CenterCellHandling::Include>, MaskValueProxy<T, isConst>>(
+    return RasterArea<T, isConst, NodataMaskFilterPolicy<T, isConst>, CircularLocationFilterPolicy<CenterCellHandling::Include>, MaskValueProxy<T, isConst>>(
         raster.data(),
         areaInfo.topLeftPtr,
         areaInfo.rows,
@@ -417,17 +413,16 @@ template <
 auto sub_area_values(Container&& raster, Cell topLeft, int32_t rows, int32_t cols)
 {
     using T                = typename std::decay_t<Container>::value_type;
-    using TMask            = typename std::decay_t<Container>::mask_value_type;
     constexpr bool isConst = std::is_const_v<std::remove_reference_t<Container>>;
 
     auto areaInfo = detail::clip_area_to_raster(raster, topLeft, rows, cols);
-    return RasterArea<T, isConst, NodataMaskFilterPolicy<T, TMask, isConst>, AllLocationsFilterPolicy, MaskValueProxy<T, isConst>>(
+    return RasterArea<T, isConst, NodataMaskFilterPolicy<T, isConst>, AllLocationsFilterPolicy, MaskValueProxy<T, isConst>>(
         raster.data(),
         areaInfo.topLeftPtr,
         areaInfo.rows,
         areaInfo.cols,
         raster.cols(),
-        NodataMaskFilterPolicy<T, TMask, isConst>(raster.data(), raster.mask()),
+        NodataMaskFilterPolicy<T, isConst>(raster.data(), raster.mask()),
         AllLocationsFilterPolicy());
 }
 }
@@ -0,0 +1,107 @@
+#include "gdx/test/testbase.h"
+
+#include "gdx/cpudispatch.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace gdx::test {
+
+using namespace cpu;
+
+TEST_CASE("cpu dispatch instruction sets")
+{
+    const auto supported = supported_instruction_sets();
+    REQUIRE_FALSE(supported.empty());
+    CHECK(supported.front() == InstructionSet::Generic);
+
+    // the best supported instruction set is selected by default
+    CHECK(active_instruction_set() == supported.back());
+
+    CHECK(instruction_set_name(InstructionSet::Generic) == "generic");
+    CHECK(instruction_set_name(InstructionSet::Sse4_2) == "sse4.2");
+    CHECK(instruction_set_name(InstructionSet::Avx2) == "avx2");
+    CHECK(instruction_set_name(InstructionSet::Avx512) == "avx512");
+}
+
+TEST_CASE_TEMPLATE("cpu dispatch kernels", T, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, float, double)
+{
+    // multiple parallel chunks and a partial last chunk
+    const std::size_t count = 2 * 64 * 1024 + 17;
+
+    std::vector<T> lhs(count), rhs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        lhs[i] = static_cast<T>(i % 97);
+        rhs[i] = static_cast<T>(i % 89);
+    }
+
+    const T scalar                   = T(44);
+    const auto initialInstructionSet = active_instruction_set();
+
+    auto matches = [count](const auto& result, auto&& expected) {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (result[i] != expected(i)) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    for (auto instructionSet : supported_instruction_sets()) {
+        const auto name = std::string(instruction_set_name(instructionSet));
+        CAPTURE(name);
+        set_instruction_set(instructionSet);
+        CHECK(active_instruction_set() == instructionSet);
+
+        std::vector<T> result(count);
+        arithmetic(ArithmeticOperation::Add, lhs.data(), rhs.data(), result.data(), count);
+        CHECK(matches(result, [&](std::size_t i) { return T(lhs[i] + rhs[i]); }));
+
+        arithmetic(ArithmeticOperation::Subtract, lhs.data(), rhs.data(), result.data(), count);
+        CHECK(matches(result, [&](std::size_t i) { return T(lhs[i] - rhs[i]); }));
+
+        arithmetic_scalar(ArithmeticOperation::Multiply, lhs.data(), scalar, result.data(), count);
+        CHECK(matches(result, [&](std::size_t i) { return T(lhs[i] * scalar); }));
+
+        // in place
+        result = lhs;
+        arithmetic_scalar(ArithmeticOperation::Subtract, result.data(), scalar, result.data(), count);
+        CHECK(matches(result, [&](std::size_t i) { return T(lhs[i] - scalar); }));
+
+        std::vector<uint8_t> flags(count);
+        compare(ComparisonOperation::Less, lhs.data(), rhs.data(), flags.data(), count);
+        CHECK(matches(flags, [&](std::size_t i) { return uint8_t(lhs[i] < rhs[i]); }));
+
+        compare_scalar(ComparisonOperation::GreaterEqual, lhs.data(), scalar, flags.data(), count);
+        CHECK(std::count(flags.begin(), flags.end(), uint8_t(1)) == std::count_if(lhs.begin(), lhs.end(), [&](T v) { return v >= scalar; }));
+
+        compare_scalar(ComparisonOperation::NotEqual, lhs.data(), scalar, flags.data(), count);
+        CHECK(std::count(flags.begin(), flags.end(), uint8_t(0)) == std::count(lhs.begin(), lhs.end(), scalar));
+    }
+
+    set_instruction_set(initialInstructionSet);
+}
+
+TEST_CASE("cpu dispatch masked raster operations")
+{
+    RasterMetadata meta(2, 3, -1);
+    RasterMetadata resultMeta(2, 3, 255);
+    const MaskedRaster<float> lhs(meta, std::vector<float>{1, 2, -1, 4, 5, 6});
+    const MaskedRaster<float> rhs(meta, std::vector<float>{6, 5, 4, -1, 2, 1});
+
+    for (auto instructionSet : supported_instruction_sets()) {
+        const auto name = std::string(instruction_set_name(instructionSet));
+        CAPTURE(name);
+        set_instruction_set(instructionSet);
+
+        CHECK_RASTER_EQ(MaskedRaster<float>(meta, std::vector<float>{7, 7, -1, -1, 7, 7}), lhs + rhs);
+        CHECK_RASTER_EQ(MaskedRaster<float>(meta, std::vector<float>{3, 4, -1, 6, 7, 8}), lhs + 2.f);
+        CHECK_RASTER_EQ(MaskedRaster<uint8_t>(resultMeta, std::vector<uint8_t>{1, 1, 255, 255, 0, 0}), lhs < rhs);
+        CHECK_RASTER_EQ(MaskedRaster<uint8_t>(resultMeta, std::vector<uint8_t>{0, 0, 255, 1, 1, 1}), lhs > 3.f);
+    }
+
+    set_instruction_set(supported_instruction_sets().back());
+}
+}
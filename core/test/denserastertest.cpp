@@ -1,11 +1,24 @@
 #include "gdx/denseraster.h"
+#include "gdx/denserasterexpression.h"
 #include "gdx/test/testbase.h"
 #include "infra/cast.h"
 
 #include <set>
+#include <type_traits>
+#include <utility>
 
 namespace gdx::test {
 
+template <typename Lhs, typename Rhs, typename = void>
+struct is_addable : std::false_type
+{
+};
+
+template <typename Lhs, typename Rhs>
+struct is_addable<Lhs, Rhs, std::void_t<decltype(std::declval<Lhs>() + std::declval<Rhs>())>> : std::true_type
+{
+};
+
 TEST_CASE_TEMPLATE("dense raster", T, uint8_t, int16_t, int32_t, int64_t, float, double)
 {
     using RasterType = DenseRaster<T>;
@@ -188,4 +201,89 @@ TEST_CASE_TEMPLATE("dense raster", T, uint8_t, int16_t, int32_t, int64_t, float,
         }
     }
 }
+
+TEST_CASE_TEMPLATE("dense raster expressions", T, uint8_t, int32_t, int64_t, float, double)
+{
+    using RasterType = DenseRaster<T>;
+
+    // more cells than an expression chunk, the results are compared with the eager operations
+    const double nod = 99.0;
+    RasterMetadata meta(40, 60, nod);
+    RasterType ras1(meta, T(0));
+    RasterType ras2(meta, T(0));
+    RasterType ras3(RasterMetadata(40, 60), T(0));
+
+    for (std::size_t i = 0; i < ras1.size(); ++i) {
+        ras1[i] = T(i % 7 + 1);
+        ras2[i] = T(i % 5);
+        ras3[i] = T(i % 3);
+
+        if (i % 13 == 0) {
+            ras1.mark_as_nodata(i);
+        }
+
+        if (i % 17 == 0) {
+            ras2.mark_as_nodata(i);
+        }
+    }
+
+    SUBCASE("arithmetic")
+    {
+        auto expected = (ras1 + ras2) * ras3 - ras1;
+        auto actual   = evaluate((lazy(ras1) + ras2) * ras3 - ras1);
+
+        CHECK(expected.metadata().nodata == actual.metadata().nodata);
+        CHECK_RASTER_EQ(expected, actual);
+    }
+
+    SUBCASE("arithmetic without nodata")
+    {
+        auto expected = ras3 * ras3 + ras3;
+        auto actual   = evaluate(lazy(ras3) * ras3 + ras3);
+
+        CHECK(!actual.metadata().nodata.has_value());
+        CHECK_RASTER_EQ(expected, actual);
+    }
+
+    SUBCASE("scalar arithmetic")
+    {
+        auto expected = (ras1 * 3 + 2) - ras2 / 2;
+        auto actual   = evaluate((lazy(ras1) * 3 + 2) - lazy(ras2) / 2);
+
+        CHECK(expected.metadata().nodata == actual.metadata().nodata);
+        CHECK_RASTER_EQ(expected, actual);
+
+        CHECK_THROWS_AS(lazy(ras1) / 0, InvalidArgument);
+    }
+
+    SUBCASE("division by zero cells")
+    {
+        auto expected = ras1 / ras3;
+        auto actual   = evaluate(lazy(ras1) / ras3);
+
+        CHECK(std::isnan(*actual.metadata().nodata));
+        CHECK_RASTER_EQ(expected, actual);
+    }
+
+    SUBCASE("comparison")
+    {
+        DenseRaster<uint8_t> expected = (ras1 + ras2) > ras3;
+        DenseRaster<uint8_t> actual   = (lazy(ras1) + ras2) > ras3;
+
+        CHECK(actual.metadata().nodata == std::optional<double>(255.0));
+        CHECK_RASTER_EQ(expected, actual);
+
+        CHECK_RASTER_EQ(ras1 * 2 >= 5, evaluate(lazy(ras1) * 2 >= 5));
+        CHECK_RASTER_EQ(ras3 < 1, evaluate(lazy(ras3) < 1));
+    }
+
+    SUBCASE("temporary raster operands")
+    {
+        // the expression would keep a reference to the temporary raster
+        using Operand = decltype(lazy(ras1));
+        static_assert(is_addable<Operand, const DenseRaster<T>&>::value, "Raster operands should be accepted");
+        static_assert(!is_addable<Operand, DenseRaster<T>>::value, "Temporary raster operands should be rejected");
+        static_assert(is_addable<Operand, decltype(lazy(ras2) * 2)>::value, "Expression operands should be accepted");
+    }
+}
 }
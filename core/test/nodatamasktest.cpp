@@ -0,0 +1,204 @@
+#include "gdx/test/testbase.h"
+
+#include "gdx/nodatamask.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace gdx::test {
+
+TEST_CASE("nodata mask")
+{
+    // 3 words, the last one only partially used
+    const int32_t rows = 10;
+    const int32_t cols = 15;
+
+    SUBCASE("set and count")
+    {
+        NodataMask mask(rows, cols);
+        CHECK(mask.size() == rows * cols);
+        CHECK(mask.word_count() == 3);
+        CHECK_FALSE(mask.any());
+
+        mask.set(0, true);
+        mask.set(63, true);
+        mask.set(64, true);
+        mask.set(9, 14, true);
+        mask.set(9, 14, true);
+        CHECK(mask.nodata_count() == 4);
+        CHECK(mask(0));
+        CHECK(mask(63));
+        CHECK(mask(4, 4));
+        CHECK(mask(rows * cols - 1));
+        CHECK_FALSE(mask(1));
+        CHECK_FALSE(mask(65));
+
+        mask.set(0, false);
+        mask.set(1, false);
+        CHECK(mask.nodata_count() == 3);
+
+        std::vector<NodataMask::Index> nodataCells;
+        mask.for_each_nodata([&](NodataMask::Index index) { nodataCells.push_back(index); });
+        CHECK_CONTAINER_EQ(std::vector<NodataMask::Index>({63, 64, 149}), nodataCells);
+    }
+
+    SUBCASE("fill")
+    {
+        NodataMask mask(rows, cols, true);
+        CHECK(mask.nodata_count() == rows * cols);
+
+        // the unused bits of the last word are not counted
+        NodataMask other(rows, cols);
+        mask |= other;
+        CHECK(mask.nodata_count() == rows * cols);
+
+        mask.fill(false);
+        CHECK_FALSE(mask.any());
+
+        mask.resize(cols, rows);
+        mask.set(0, true);
+        CHECK(mask.nodata_count() == 1);
+        mask.resize(rows + 1, cols);
+        CHECK_FALSE(mask.any());
+    }
+
+    SUBCASE("assign")
+    {
+        NodataMask mask(rows, cols);
+        mask.assign([](NodataMask::Index index) { return index % 3 == 0; });
+        CHECK(mask.nodata_count() == 50);
+
+        for (NodataMask::Index i = 0; i < mask.size(); ++i) {
+            CHECK(mask(i) == (i % 3 == 0));
+        }
+    }
+
+    SUBCASE("combine")
+    {
+        NodataMask lhs(rows, cols), rhs(rows, cols), empty;
+        lhs.set(3, true);
+        rhs.set(100, true);
+
+        auto combined = combine_mask(lhs, rhs);
+        CHECK(combined.nodata_count() == 2);
+        CHECK(combined(3));
+        CHECK(combined(100));
+
+        CHECK(combine_mask(lhs, empty) == lhs);
+        CHECK(combine_mask(empty, rhs) == rhs);
+        CHECK(combine_mask(empty, empty).size() == 0);
+
+        // a mask without nodata cells does not change the result, but the allocated mask is kept
+        const NodataMask valid(rows, cols);
+        CHECK(combine_mask(lhs, valid) == lhs);
+        CHECK(combine_mask(valid, rhs) == rhs);
+        CHECK(combine_mask(empty, valid).size() == rows * cols);
+    }
+
+    SUBCASE("byte view")
+    {
+        NodataMask mask(rows, cols);
+        mask.set(5, true);
+
+        auto view = mask.byte_view();
+        REQUIRE(view->size() == std::size_t(rows * cols));
+        CHECK(std::count(view->begin(), view->end(), uint8_t(1)) == 1);
+        CHECK((*view)[5] == 1);
+
+        // changes to the mask are written through
+        mask.set(70, true);
+        CHECK((*view)[70] == 1);
+        mask = combine_mask(mask, NodataMask(rows, cols, true));
+        CHECK(std::count(view->begin(), view->end(), uint8_t(1)) == rows * cols);
+        mask.fill(false);
+        CHECK(std::count(view->begin(), view->end(), uint8_t(1)) == 0);
+        mask.assign([](NodataMask::Index index) { return index == 3; });
+        NodataMask other(rows, cols);
+        other.set(100, true);
+        mask |= other;
+        CHECK(std::count(view->begin(), view->end(), uint8_t(1)) == 2);
+        CHECK((*view)[3] == 1);
+        CHECK((*view)[100] == 1);
+        mask.fill(false);
+
+        // a view without changes leaves the mask untouched
+        mask.update_from_byte_view();
+        CHECK_FALSE(mask.any());
+
+        // changes to the view are applied on request, the view stays shared while it has other owners
+        (*view)[149] = 1;
+        CHECK_FALSE(mask(149));
+        mask.update_from_byte_view();
+        CHECK(mask(149));
+        CHECK(mask.nodata_count() == 1);
+        CHECK(mask.byte_view() == view);
+
+        // copies do not share the view
+        NodataMask copy(mask);
+        copy.set(0, true);
+        CHECK((*view)[0] == 0);
+
+        // the view is released once the mask is its only owner
+        (*view)[0] = 1;
+        view.reset();
+        mask.update_from_byte_view();
+        CHECK(mask(0));
+        mask.set(1, true);
+        CHECK(mask.byte_view()->at(1) == 1);
+    }
+}
+
+TEST_CASE("nodata mask set blocks in parallel")
+{
+    // the last block ends in the middle of a word
+    const int32_t rows = 317;
+    const int32_t cols = 211;
+    auto isNodata      = [](NodataMask::Index index) { return index % 7 == 0 || index % 64 == 63; };
+
+    NodataMask expected(rows, cols);
+    expected.assign(isNodata);
+
+    NodataMask mask(rows, cols, true);
+    auto view = mask.byte_view();
+
+    const NodataMask::Index blockSize = 4 * NodataMask::s_wordBits;
+    const auto blockCount             = int64_t((mask.size() + blockSize - 1) / blockSize);
+#pragma omp parallel for
+    for (int64_t block = 0; block < blockCount; ++block) {
+        const auto first = NodataMask::Index(block) * blockSize;
+        mask.set_block(first, std::min(blockSize, mask.size() - first), isNodata);
+    }
+
+    CHECK(mask == expected);
+    CHECK(mask.nodata_count() == expected.nodata_count());
+    for (NodataMask::Index i = 0; i < mask.size(); ++i) {
+        CHECK((*view)[std::size_t(i)] == uint8_t(isNodata(i)));
+    }
+}
+
+TEST_CASE("masked raster nodata mask")
+{
+    MaskedRaster<int32_t> ras(RasterMetadata(3, 3, -1), std::vector<int32_t>{1, 2, 3, 4, 5, 6, 7, 8, 9});
+    const auto& constRas = ras;
+
+    // no nodata cells, so the mask can be skipped
+    CHECK(ras.has_nodata());
+    CHECK(constRas.mask() == nullptr);
+    CHECK(ras.mask() != nullptr);
+
+    std::for_each(optional_value_begin(ras), optional_value_end(ras), [](auto& value) {
+        if (*value % 2 == 0) {
+            value.reset();
+        }
+    });
+
+    CHECK(constRas.mask() != nullptr);
+    CHECK(ras.mask_data().nodata_count() == 4);
+    CHECK(ras.is_nodata(Cell(0, 1)));
+    CHECK_FALSE(ras.is_nodata(Cell(0, 0)));
+
+    ras.collapse_data();
+    CHECK(ras(1, 0) == -1);
+    CHECK(ras(1, 1) == 5);
+}
+}
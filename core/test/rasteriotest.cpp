@@ -575,6 +575,83 @@ TEST_CASE("store double dense raster as float, nodata needs adjustment")
         CHECK(resultRas.is_nodata(0, 0));
     }
 }
+
+TEST_CASE("process dense raster in strips")
+{
+    RasterMetadata meta(150, 20, -1.0);
+    meta.set_cell_size(10.0);
+
+    gdx::DenseRaster<float> ras(meta, 0.f);
+    for (int32_t i = 0; i < int32_t(ras.size()); ++i) {
+        if (i % 17 == 0) {
+            ras.mark_as_nodata(i);
+        } else {
+            ras[i] = float(i);
+        }
+    }
+
+    gdx::write_raster(ras, "/vsimem/strips_input.tif");
+
+    // sum of the cell with the cells above and below, needs one halo row
+    auto vertical_sum = [](const gdx::DenseRaster<float>& data, int32_t r, int32_t c) {
+        float sum = 0.f;
+        for (int32_t row = std::max(0, r - 1); row <= std::min(data.rows() - 1, r + 1); ++row) {
+            if (!data.is_nodata(row, c)) {
+                sum += data(row, c);
+            }
+        }
+        return sum;
+    };
+
+    gdx::process_raster_strips<float, float>("/vsimem/strips_input.tif", "/vsimem/strips_output.tif", 1, [&](const RasterStrip<float>& strip) {
+        CHECK(strip.data.rows() == strip.haloTop + strip.rows + strip.haloBottom);
+
+        gdx::DenseRaster<float> result(row_window_metadata(strip.data.metadata(), strip.haloTop, strip.rows));
+        for (int32_t r = 0; r < strip.rows; ++r) {
+            for (int32_t c = 0; c < strip.data.cols(); ++c) {
+                if (strip.data.is_nodata(r + strip.haloTop, c)) {
+                    result.mark_as_nodata(r, c);
+                } else {
+                    result(r, c) = vertical_sum(strip.data, r + strip.haloTop, c);
+                }
+            }
+        }
+        return result;
+    });
+
+    gdx::DenseRaster<float> expected(meta, 0.f);
+    for (int32_t r = 0; r < meta.rows; ++r) {
+        for (int32_t c = 0; c < meta.cols; ++c) {
+            if (ras.is_nodata(r, c)) {
+                expected.mark_as_nodata(r, c);
+            } else {
+                expected(r, c) = vertical_sum(ras, r, c);
+            }
+        }
+    }
+
+    CHECK_RASTER_NEAR(expected, gdx::read_dense_raster<float>("/vsimem/strips_output.tif"));
+}
+
+TEST_CASE("write const float dense raster with nodata in chunks")
+{
+    // more rows than fit in a single conversion chunk
+    RasterMetadata meta(1100, 1000, -9999.0);
+    meta.set_cell_size(10.0);
+
+    gdx::DenseRaster<float> ras(meta, 4.f);
+    for (int32_t i = 0; i < int32_t(ras.size()); i += 13) {
+        ras.mark_as_nodata(i);
+    }
+
+    const auto& constRas = ras;
+    gdx::write_raster(constRas, "/vsimem/chunked_nodata.tif");
+
+    // the nodata conversion should not modify the raster that is written
+    CHECK(std::isnan(ras[0]));
+    CHECK(inf::gdal::io::read_metadata("/vsimem/chunked_nodata.tif").nodata == -9999.0);
+    CHECK_RASTER_EQ(ras, gdx::read_dense_raster<float>("/vsimem/chunked_nodata.tif"));
+}
 #endif
 
 TEST_CASE("store double masked raster as float, nodata needs adjustment")
@@ -10,6 +10,7 @@ static_assert(false, "pybind11 did not detect c++17 support");
 #endif
 
 #include "gdx/config.h"
+#include "gdx/cpudispatch.h"
 #include "gdx/exception.h"
 #include "gdx/log.h"
 #include "gdx/point.h"
@@ -35,7 +36,7 @@ PYBIND11_MODULE(geodynamix, mod)
 {
     using namespace gdx;
 
-    Log::add_custom_sink(std::make_shared<gdx::python::LogSinkMt>());
+    Log::add_custom_sink(std::make_shared<gdx::python::LogSinkSt>());
     Log::initialize("geodynamix");
     inf::gdal::RegistrationConfig cfg;
     cfg.setLogHandler = false;
@@ -94,6 +95,10 @@ PYBIND11_MODULE(geodynamix, mod)
         .value("circular", BufferStyle::Circular)
         .value("square", BufferStyle::Square);
 
+    py::enum_<DistanceMethod>(mod, "distance_method")
+        .value("chamfer", DistanceMethod::Chamfer)
+        .value("euclidean", DistanceMethod::Euclidean);
+
     py::class_<gdx::RasterMetadata>(mod, "raster_metadata", "Raster metadata data structure.")
         .def(py::init<>())
         .def(py::init<const gdx::RasterMetadata&>())
@@ -145,7 +150,7 @@ PYBIND11_MODULE(geodynamix, mod)
         .def_readonly("max_value", &gdx::RasterStats<512>::highestValue)
         .def_readonly("min_value", &gdx::RasterStats<512>::lowestValue);
 
-    py::class_<Raster>(mod, "raster")
+    py::class_<Raster>(mod, "raster", py::buffer_protocol())
         // Customized init funtions because we need to convert the dataType first
         .def(py::init([](int32_t rows, int32_t cols, py::object dataType) {
                  return Raster(rows, cols, dtypeToRasterType(py::dtype::from_args(dataType)));
@@ -163,6 +168,7 @@ PYBIND11_MODULE(geodynamix, mod)
                  return Raster(meta, dtypeToRasterType(py::dtype::from_args(dataType)), assignValue);
              }),
              py::arg("metadata"), py::arg("dtype") = py::dtype::of<float>(), py::arg("fill"))
+        .def_buffer(&rasterBuffer)
         .def("__repr__", &rasterRepresentation)
         .def("_repr_html_", [](py::object instance) {
             // use the representation of the foilum map
@@ -248,6 +254,21 @@ PYBIND11_MODULE(geodynamix, mod)
             &Log::set_level,
             "Set the log level (default = Warning)");
 
+    mod.def("set_num_threads",
+            &setThreadCount,
+            "count"_a,
+            "Set the number of threads that are used by the parallel algorithms. "
+            "The algorithms release the GIL, lower the count when running algorithms from multiple python threads");
+
+    mod.def("get_num_threads",
+            &threadCount,
+            "The number of threads that are used by the parallel algorithms");
+
+    mod.def("cpu_instruction_set",
+            []() { return std::string(cpu::instruction_set_name(cpu::active_instruction_set())); },
+            "The instruction set of the raster arithmetic and comparison kernels, the best one the processor supports is selected at load time "
+            "(generic, sse4.2, avx2 or avx512)");
+
     mod.def("read",
             py::overload_cast<py::object>(&read_raster),
             "raster_path"_a,
@@ -331,7 +352,8 @@ PYBIND11_MODULE(geodynamix, mod)
             "targets"_a,
             "obstacles"_a        = py::none(),
             "include_diagonal"_a = false,
-            "Calculate the distance from a cell to the nearest target");
+            "method"_a           = DistanceMethod::Chamfer,
+            "Calculate the distance from a cell to the nearest target, the euclidean method is not supported with obstacles");
 
     mod.def("travel_distance",
             &pyalgo::travelDistance,
@@ -358,12 +380,14 @@ PYBIND11_MODULE(geodynamix, mod)
     mod.def("closest_target",
             &pyalgo::closestTarget,
             "targets"_a,
+            "method"_a = DistanceMethod::Chamfer,
             "Calculate the nearest target");
 
     mod.def("value_at_closest_target",
             &pyalgo::valueAtClosestTarget,
             "targets"_a,
             "values"_a,
+            "method"_a = DistanceMethod::Chamfer,
             "Calculate the values at the nearest target");
 
     mod.def("value_at_closest_travel_target",
@@ -501,14 +525,23 @@ PYBIND11_MODULE(geodynamix, mod)
             &pyalgo::maxInBuffer,
             "raster"_a,
             "radius"_a,
+            "buffer_style"_a = BufferStyle::Circular,
             "Resulting raster will have per cell the max of all values within its radius.  Radius is in meters");
 
+    mod.def("min_in_buffer",
+            &pyalgo::minInBuffer,
+            "raster"_a,
+            "radius"_a,
+            "buffer_style"_a = BufferStyle::Circular,
+            "Resulting raster will have per cell the min of all values within its radius.  Radius is in meters");
+
     mod.def("raster_from_ndarray",
             &createFromNdArray,
             "array"_a,
             "metadata"_a,
             "Create a raster that contains the data from the python array."
-            "The data will be copied, so modifying the python array will not change the raster");
+            "The data is copied once directly from the array memory (strided arrays are supported), "
+            "so modifying the python array will not change the raster");
 
     mod.def("blur_filter",
             &pyalgo::blurFilter,
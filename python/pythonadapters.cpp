@@ -189,15 +189,24 @@ py::list rasterBounds(const RasterMetadata& meta, bool projected)
     return bounds;
 }
 
+void applyNumpyMaskChanges(Raster& raster)
+{
+    std::visit([](auto& ras) { ras.mask_data().update_from_byte_view(); }, raster.get());
+}
+
 template <typename T>
 std::pair<py::array, py::object> createDataMaskPair(Raster& raster)
 {
     py::object parent = py::cast(raster);
     py::object mask;
 
+    // numpy needs a byte per cell, the raster shares a byte view of its mask that is kept up to date with the raster
+    // and changes made in python are applied to the raster mask when it is passed to c++ again (see rastercaster.h)
     auto& mask_data = raster.mask_data<T>();
     if (mask_data.size() > 0) {
-        mask = py::cast(mask_data, py::return_value_policy::reference_internal, parent);
+        auto* view = new std::shared_ptr<std::vector<uint8_t>>(mask_data.byte_view());
+        py::capsule owner(view, [](void* ptr) { delete static_cast<std::shared_ptr<std::vector<uint8_t>>*>(ptr); });
+        mask = py::array_t<bool>({mask_data.rows(), mask_data.cols()}, reinterpret_cast<const bool*>((*view)->data()), owner);
     }
 
     return {py::cast(raster.eigen_data<T>(), py::return_value_policy::reference_internal, parent), mask};
@@ -281,10 +290,35 @@ void write_raster(py::object dataType, Raster& raster, const std::string& filepa
 }
 
 template <typename T>
-Raster createFromNdArray(py::array_t<T> arrayData, const gdx::RasterMetadata& meta)
+Raster createFromNdArray(const py::array& arrayData, const gdx::RasterMetadata& meta)
 {
-    auto dataSpan = std::span<const T>(reinterpret_cast<const T*>(arrayData.data()), arrayData.size());
-    return Raster(MaskedRaster<T>(meta, dataSpan));
+    using data_type  = typename MaskedRaster<T>::data_type;
+    using StridedMap = Eigen::Map<const data_type, Eigen::Unaligned, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+
+    const auto itemSize = py::ssize_t(sizeof(T));
+
+    // the stride of an axis with extent 1 is never used and can be anything (e.g. 0 for x[None, :]), numpy considers those arrays contiguous
+    const auto rowStride = meta.rows == 1 ? meta.cols * itemSize : arrayData.strides(0);
+    const auto colStride = meta.cols == 1 ? itemSize : arrayData.strides(1);
+
+    data_type data;
+    if (arrayData.itemsize() != itemSize || rowStride <= 0 || colStride <= 0 || rowStride % itemSize != 0 || colStride % itemSize != 0) {
+        // The element type differs from the raster type (e.g. int64) or the layout can not be expressed in elements (broadcasted, reversed),
+        // let numpy convert it to a contiguous array of the raster type first
+        auto converted = py::array_t<T, py::array::c_style | py::array::forcecast>::ensure(arrayData);
+        if (!converted) {
+            throw py::error_already_set();
+        }
+
+        data = Eigen::Map<const data_type>(converted.data(), meta.rows, meta.cols);
+    } else {
+        // The numpy memory is read in place (also for sliced or transposed arrays), the only copy is the one into the raster storage
+        data = StridedMap(static_cast<const T*>(arrayData.data()), meta.rows, meta.cols, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(rowStride / itemSize, colStride / itemSize));
+    }
+
+    MaskedRaster<T> raster(meta, std::move(data));
+    raster.init_nodata_values();
+    return Raster(std::move(raster));
 }
 
 Raster createFromNdArray(py::array arrayData, const gdx::RasterMetadata& meta)
@@ -314,6 +348,32 @@ Raster createFromNdArray(py::array arrayData, const gdx::RasterMetadata& meta)
     throw InvalidArgument("Invalid raster data type");
 }
 
+template <typename T>
+py::buffer_info createBufferInfo(Raster& raster)
+{
+    auto& data = raster.eigen_data<T>();
+    return py::buffer_info(data.data(),
+                           py::ssize_t(sizeof(T)),
+                           py::format_descriptor<T>::format(),
+                           2,
+                           {py::ssize_t(data.rows()), py::ssize_t(data.cols())},
+                           {py::ssize_t(sizeof(T) * data.cols()), py::ssize_t(sizeof(T))});
+}
+
+py::buffer_info rasterBuffer(Raster& raster)
+{
+    auto& type = raster.type();
+    if (type == typeid(uint8_t)) return createBufferInfo<uint8_t>(raster);
+    if (type == typeid(int16_t)) return createBufferInfo<int16_t>(raster);
+    if (type == typeid(uint16_t)) return createBufferInfo<uint16_t>(raster);
+    if (type == typeid(int32_t)) return createBufferInfo<int32_t>(raster);
+    if (type == typeid(uint32_t)) return createBufferInfo<uint32_t>(raster);
+    if (type == typeid(float)) return createBufferInfo<float>(raster);
+    if (type == typeid(double)) return createBufferInfo<double>(raster);
+
+    throw InvalidArgument("Invalid raster data type");
+}
+
 pybind11::str showMetadata(const RasterMetadata& meta)
 {
     std::stringstream ss;
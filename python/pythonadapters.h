@@ -2,6 +2,7 @@
 
 #include "gdx/rastermetadata.h"
 #include "infra/gdalalgo.h"
+#include "rastercaster.h"
 
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
@@ -37,6 +38,7 @@ void write_raster(Raster& raster, const std::string& filepath, pybind11::object
 void write_raster(pybind11::object dataType, Raster& raster, const std::string& filepath, pybind11::object colorMap);
 
 Raster createFromNdArray(pybind11::array arrayData, const gdx::RasterMetadata& meta);
+pybind11::buffer_info rasterBuffer(Raster& raster);
 
 pybind11::str showMetadata(const RasterMetadata& raster);
 pybind11::str showRasterStats(const RasterStats<512>& stats);
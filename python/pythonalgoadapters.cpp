@@ -30,6 +30,10 @@
 
 #include <fmt/ostream.h>
 
+#include <algorithm>
+#include <array>
+#include <tuple>
+
 namespace gdx {
 namespace pyalgo {
 
@@ -54,12 +58,51 @@ void throwOnRasterTypeMismatch(const Raster& raster1, const Raster& raster2)
         throw InvalidArgument("Expected raster types to be the same ({} <-> {})", raster1.type().name(), raster2.type().name());
     }
 }
+
+template <typename BinaryOperation>
+Raster combineRasters(BinaryOperation& op, const Raster& lhs, const Raster& rhs)
+{
+    return op(lhs, rhs);
+}
+
+template <typename BinaryOperation, typename... Rasters>
+Raster combineRasters(BinaryOperation& op, const Raster& lhs, const Raster& rhs, const Rasters&... others)
+{
+    return combineRasters(op, op(lhs, rhs), others...);
+}
+
+// Resolves the raster arguments while holding the GIL and combines them from left to right without holding it
+template <typename BinaryOperation, typename... PyObjects>
+Raster combineRasterArguments(BinaryOperation op, PyObjects... rasterArgs)
+{
+    std::array<RasterArgument, sizeof...(PyObjects)> args{RasterArgument(rasterArgs)...};
+    std::array<const Raster*, sizeof...(PyObjects)> rasters;
+    std::transform(args.begin(), args.end(), rasters.begin(), [](RasterArgument& arg) {
+        return &arg.raster();
+    });
+
+    return withoutGil([&]() {
+        return std::apply([&](auto*... ras) { return combineRasters(op, *ras...); }, rasters);
+    });
+}
+
+template <typename... PyObjects>
+Raster logicalAndOf(PyObjects... rasterArgs)
+{
+    return combineRasterArguments([](const Raster& lhs, const Raster& rhs) { return lhs && rhs; }, rasterArgs...);
+}
+
+template <typename... PyObjects>
+Raster logicalOrOf(PyObjects... rasterArgs)
+{
+    return combineRasterArguments([](const Raster& lhs, const Raster& rhs) { return lhs || rhs; }, rasterArgs...);
+}
 }
 
 Raster blurFilter(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::blur_filter(raster));
+        return Raster(withoutGil([&]() { return gdx::blur_filter(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -67,7 +110,7 @@ Raster blurFilter(py::object rasterArg)
 Raster majorityFilter(py::object rasterArg, double radiusInMeter)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::majority_filter(raster, static_cast<float>(radiusInMeter)));
+        return Raster(withoutGil([&]() { return gdx::majority_filter(raster, static_cast<float>(radiusInMeter)); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -107,7 +150,8 @@ Raster min(py::args args)
     }
 
     return std::visit([&args](auto&& raster) {
-        return Raster(gdx::minimum(createRasterVectorFromArgs<std::remove_reference_t<decltype(raster)>>(args)));
+        auto rasters = createRasterVectorFromArgs<std::remove_reference_t<decltype(raster)>>(args);
+        return Raster(withoutGil([&]() { return gdx::minimum(rasters); }));
     },
                       rasterPtr->get());
 }
@@ -124,7 +168,8 @@ Raster max(py::args args)
     }
 
     return std::visit([&args](auto&& raster) {
-        return Raster(gdx::maximum(createRasterVectorFromArgs<std::remove_reference_t<decltype(raster)>>(args)));
+        auto rasters = createRasterVectorFromArgs<std::remove_reference_t<decltype(raster)>>(args);
+        return Raster(withoutGil([&]() { return gdx::maximum(rasters); }));
     },
                       rasterPtr->get());
 }
@@ -133,7 +178,7 @@ Raster clip(pybind11::object rasterArg, double low, double high)
 {
     return std::visit([&](auto&& raster) {
         using T = value_type<decltype(raster)>;
-        return Raster(gdx::clip(raster, static_cast<T>(low), static_cast<T>(high)));
+        return Raster(withoutGil([&]() { return gdx::clip(raster, static_cast<T>(low), static_cast<T>(high)); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -142,7 +187,7 @@ Raster clipLow(pybind11::object rasterArg, double low)
 {
     return std::visit([&](auto&& raster) {
         using T = value_type<decltype(raster)>;
-        return Raster(gdx::clip_low(raster, static_cast<T>(low)));
+        return Raster(withoutGil([&]() { return gdx::clip_low(raster, static_cast<T>(low)); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -151,7 +196,7 @@ Raster clipHigh(pybind11::object rasterArg, double high)
 {
     return std::visit([&](auto&& raster) {
         using T = value_type<decltype(raster)>;
-        return Raster(gdx::clip_high(raster, static_cast<T>(high)));
+        return Raster(withoutGil([&]() { return gdx::clip_high(raster, static_cast<T>(high)); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -159,7 +204,7 @@ Raster clipHigh(pybind11::object rasterArg, double high)
 Raster abs(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::abs(raster));
+        return Raster(withoutGil([&]() { return gdx::abs(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -167,7 +212,7 @@ Raster abs(py::object rasterArg)
 Raster round(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::round(raster));
+        return Raster(withoutGil([&]() { return gdx::round(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -175,7 +220,7 @@ Raster round(py::object rasterArg)
 Raster sin(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::sin(raster));
+        return Raster(withoutGil([&]() { return gdx::sin(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -183,7 +228,7 @@ Raster sin(py::object rasterArg)
 Raster cos(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::cos(raster));
+        return Raster(withoutGil([&]() { return gdx::cos(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -191,7 +236,7 @@ Raster cos(py::object rasterArg)
 Raster log(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::log(raster));
+        return Raster(withoutGil([&]() { return gdx::log(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -199,7 +244,7 @@ Raster log(py::object rasterArg)
 Raster log10(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::log10(raster));
+        return Raster(withoutGil([&]() { return gdx::log10(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -207,7 +252,7 @@ Raster log10(py::object rasterArg)
 Raster exp(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::exp(raster));
+        return Raster(withoutGil([&]() { return gdx::exp(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -217,19 +262,21 @@ Raster pow(py::object rasterArg1, py::object rasterArg2)
     RasterArgument r1(rasterArg1);
     RasterArgument r2(rasterArg2);
 
-    throwOnRasterTypeMismatch(r1.raster(), r2.raster(r1.raster()));
+    auto& raster1 = r1.raster();
+    auto& raster2 = r2.raster(raster1);
+    throwOnRasterTypeMismatch(raster1, raster2);
 
     return std::visit([&](auto&& raster) {
         using T = value_type<decltype(raster)>;
-        return Raster(gdx::pow(raster, r2.get<T>(r1.raster())));
+        return Raster(withoutGil([&]() { return gdx::pow(raster, raster2.get<T>()); }));
     },
-                      RasterArgument(rasterArg1).variant());
+                      raster1.get());
 }
 
 Raster normalise(pybind11::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::normalise_min_max<float>(raster, 0.f, 1.f));
+        return Raster(withoutGil([&]() { return gdx::normalise_min_max<float>(raster, 0.f, 1.f); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -237,7 +284,7 @@ Raster normalise(pybind11::object rasterArg)
 Raster normaliseToByte(pybind11::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::normalise_min_max<uint8_t>(raster, 0, 254));
+        return Raster(withoutGil([&]() { return gdx::normalise_min_max<uint8_t>(raster, 0, 254); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -245,7 +292,7 @@ Raster normaliseToByte(pybind11::object rasterArg)
 bool any(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return gdx::any_of(raster);
+        return withoutGil([&]() { return gdx::any_of(raster); });
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -253,7 +300,7 @@ bool any(py::object rasterArg)
 bool all(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return gdx::all_of(raster);
+        return withoutGil([&]() { return gdx::all_of(raster); });
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -261,7 +308,7 @@ bool all(py::object rasterArg)
 py::object minimumValue(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return pybind11::cast(gdx::minimum(raster));
+        return pybind11::cast(withoutGil([&]() { return gdx::minimum(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -269,7 +316,7 @@ py::object minimumValue(py::object rasterArg)
 py::object maximumValue(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return pybind11::cast(gdx::maximum(raster));
+        return pybind11::cast(withoutGil([&]() { return gdx::maximum(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -277,7 +324,7 @@ py::object maximumValue(py::object rasterArg)
 double sum(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return gdx::sum(raster);
+        return withoutGil([&]() { return gdx::sum(raster); });
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -287,7 +334,7 @@ Raster clusterSize(py::object rasterArg, bool includeDiagonal)
     auto diagonalSetting = includeDiagonal ? ClusterDiagonals::Include : ClusterDiagonals::Exclude;
 
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::cluster_size(raster, diagonalSetting));
+        return Raster(withoutGil([&]() { return gdx::cluster_size(raster, diagonalSetting); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -297,7 +344,7 @@ Raster clusterSum(py::object rasterArg, py::object rasterToSumArg, bool includeD
     auto diagonalSetting = includeDiagonal ? ClusterDiagonals::Include : ClusterDiagonals::Exclude;
 
     return std::visit([diagonalSetting](auto&& raster, auto&& rasterToSum) {
-        return Raster(gdx::cluster_sum<float>(raster, rasterToSum, diagonalSetting));
+        return Raster(withoutGil([&]() { return gdx::cluster_sum<float>(raster, rasterToSum, diagonalSetting); }));
     },
                       RasterArgument(rasterArg).variant(), RasterArgument(rasterToSumArg).variant());
 }
@@ -307,7 +354,7 @@ Raster clusterId(py::object rasterArg, bool includeDiagonal)
     auto diagonalSetting = includeDiagonal ? ClusterDiagonals::Include : ClusterDiagonals::Exclude;
 
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::cluster_id(raster, diagonalSetting));
+        return Raster(withoutGil([&]() { return gdx::cluster_id(raster, diagonalSetting); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -323,7 +370,7 @@ Raster clusterIdWithObstacles(py::object rasterArg, py::object obstacleRasterArg
     return std::visit([&](auto&& raster) {
         // Categories and obstacles have fixed types, so cast them
         auto categories = raster_cast<int32_t>(raster);
-        return Raster(gdx::cluster_id_with_obstacles(categories, obstacles.get<uint8_t>()));
+        return Raster(withoutGil([&]() { return gdx::cluster_id_with_obstacles(categories, obstacles.get<uint8_t>()); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -332,7 +379,7 @@ Raster fuzzyClusterId(py::object rasterArg, float radius)
 {
     return std::visit([&](auto&& raster) {
         show_warning_if_clustering_on_floats(raster);
-        return Raster(gdx::fuzzy_cluster_id(raster, radius));
+        return Raster(withoutGil([&]() { return gdx::fuzzy_cluster_id(raster, radius); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -349,12 +396,12 @@ Raster fuzzyClusterIdWithObstacles(py::object rasterArg, py::object obstacleRast
         show_warning_if_clustering_on_floats(raster);
         // Categories and obstacles have fixed types, so cast them
         auto categories = raster_cast<int32_t>(raster);
-        return Raster(gdx::fuzzy_cluster_id_with_obstacles(categories, obstacles.get<uint8_t>(), radius));
+        return Raster(withoutGil([&]() { return gdx::fuzzy_cluster_id_with_obstacles(categories, obstacles.get<uint8_t>(), radius); }));
     },
                       RasterArgument(rasterArg).variant());
 }
 
-Raster distance(py::object targetArg, py::object obstaclesArg, bool includeDiagonal)
+Raster distance(py::object targetArg, py::object obstaclesArg, bool includeDiagonal, DistanceMethod method)
 {
     auto diagonalSetting = includeDiagonal ? BarrierDiagonals::Include : BarrierDiagonals::Exclude;
 
@@ -362,12 +409,16 @@ Raster distance(py::object targetArg, py::object obstaclesArg, bool includeDiago
     auto& target = targetRasterArg.raster();
 
     if (obstaclesArg.is_none()) {
-        return Raster(gdx::distance(target.get<uint8_t>()));
+        return Raster(withoutGil([&]() { return gdx::distance(target.get<uint8_t>(), method); }));
     } else {
+        if (method != DistanceMethod::Chamfer) {
+            throw InvalidArgument("Distances with obstacles are only supported with the chamfer method");
+        }
+
         RasterArgument obstaclesRasterArg(obstaclesArg);
 
         return std::visit([&](auto&& targetArg, auto&& obstaclesArg) {
-            return Raster(gdx::distance(targetArg, obstaclesArg, diagonalSetting));
+            return Raster(withoutGil([&]() { return gdx::distance(targetArg, obstaclesArg, diagonalSetting); }));
         },
                           targetRasterArg.variant(), obstaclesRasterArg.variant());
 
@@ -386,7 +437,7 @@ Raster travelDistance(py::object rasterArg, py::object anyTravelTimeArg)
     }
 
     return std::visit([&target](auto&& travelTime) {
-        return Raster(gdx::travel_distance(target.get<uint8_t>(), travelTime));
+        return Raster(withoutGil([&]() { return gdx::travel_distance(target.get<uint8_t>(), travelTime); }));
     },
                       RasterArgument(anyTravelTimeArg).variant());
 }
@@ -394,7 +445,7 @@ Raster travelDistance(py::object rasterArg, py::object anyTravelTimeArg)
 Raster sumWithinTravelDistance(py::object anyMask, py::object anyResistance, py::object anyValuesMap, double maxResistance, bool includeAdjacent)
 {
     return std::visit([maxResistance, includeAdjacent](auto&& mask, auto&& resistance, auto&& values) {
-        return Raster(gdx::sum_within_travel_distance<float>(mask, resistance, values, static_cast<float>(maxResistance), includeAdjacent));
+        return Raster(withoutGil([&]() { return gdx::sum_within_travel_distance<float>(mask, resistance, values, static_cast<float>(maxResistance), includeAdjacent); }));
     },
                       RasterArgument(anyMask).variant(), RasterArgument(anyResistance).variant(), RasterArgument(anyValuesMap).variant());
 }
@@ -402,23 +453,23 @@ Raster sumWithinTravelDistance(py::object anyMask, py::object anyResistance, py:
 Raster sumTargetsWithinTravelDistance(py::object anyTargets, py::object anyResistance, double maxResistance)
 {
     return std::visit([maxResistance](auto&& targets, auto&& resistance) {
-        return Raster(gdx::sum_targets_within_travel_distance<float>(targets, resistance, static_cast<float>(maxResistance)));
+        return Raster(withoutGil([&]() { return gdx::sum_targets_within_travel_distance<float>(targets, resistance, static_cast<float>(maxResistance)); }));
     },
                       RasterArgument(anyTargets).variant(), RasterArgument(anyResistance).variant());
 }
 
-Raster closestTarget(py::object rasterTargetsArg)
+Raster closestTarget(py::object rasterTargetsArg, DistanceMethod method)
 {
-    return std::visit([](auto&& target) {
-        return Raster(gdx::closest_target(target));
+    return std::visit([method](auto&& target) {
+        return Raster(withoutGil([&]() { return gdx::closest_target(target, method); }));
     },
                       RasterArgument(rasterTargetsArg).variant());
 }
 
-Raster valueAtClosestTarget(py::object rasterTargetsArg, py::object valuesArg)
+Raster valueAtClosestTarget(py::object rasterTargetsArg, py::object valuesArg, DistanceMethod method)
 {
-    return std::visit([](auto&& target, auto&& values) {
-        return Raster(gdx::value_at_closest_target(target, values));
+    return std::visit([method](auto&& target, auto&& values) {
+        return Raster(withoutGil([&]() { return gdx::value_at_closest_target(target, values, method); }));
     },
                       RasterArgument(rasterTargetsArg).variant(), RasterArgument(valuesArg).variant());
 }
@@ -426,7 +477,7 @@ Raster valueAtClosestTarget(py::object rasterTargetsArg, py::object valuesArg)
 Raster valueAtClosestTravelTarget(py::object rasterTargetsArg, py::object travelTimeArg, py::object valuesArg)
 {
     return std::visit([](auto&& target, auto&& travelTimes, auto&& values) {
-        return Raster(gdx::value_at_closest_travel_target(target, travelTimes, values));
+        return Raster(withoutGil([&]() { return gdx::value_at_closest_travel_target(target, travelTimes, values); }));
     },
                       RasterArgument(rasterTargetsArg).variant(), RasterArgument(travelTimeArg).variant(), RasterArgument(valuesArg).variant());
 }
@@ -434,7 +485,7 @@ Raster valueAtClosestTravelTarget(py::object rasterTargetsArg, py::object travel
 Raster valueAtClosestLessThenTravelTarget(py::object rasterTargetsArg, py::object travelTimeArg, double maxTravelTime, py::object valuesArg)
 {
     return std::visit([maxTravelTime](auto&& target, auto&& travelTimes, auto&& values) {
-        return Raster(gdx::value_at_closest_less_then_travel_target(target, travelTimes, static_cast<float>(maxTravelTime), values));
+        return Raster(withoutGil([&]() { return gdx::value_at_closest_less_then_travel_target(target, travelTimes, static_cast<float>(maxTravelTime), values); }));
     },
                       RasterArgument(rasterTargetsArg).variant(), RasterArgument(travelTimeArg).variant(), RasterArgument(valuesArg).variant());
 }
@@ -443,7 +494,7 @@ Raster nodeValueDistanceDecay(pybind11::object targetArg, pybind11::object trave
 {
     return std::visit([maxTravelTime, a, b](auto&& target, auto&& travelTimes) {
         using TTravelTime = value_type<decltype(travelTimes)>;
-        return Raster(gdx::node_value_distance_decay(target, travelTimes, truncate<TTravelTime>(maxTravelTime), truncate<float>(a), truncate<float>(b)));
+        return Raster(withoutGil([&]() { return gdx::node_value_distance_decay(target, travelTimes, truncate<TTravelTime>(maxTravelTime), truncate<float>(a), truncate<float>(b)); }));
     },
                       RasterArgument(targetArg).variant(), RasterArgument(travelTimeArg).variant());
 }
@@ -451,54 +502,59 @@ Raster nodeValueDistanceDecay(pybind11::object targetArg, pybind11::object trave
 Raster categorySum(py::object clusterArg, py::object valuesArg)
 {
     RasterArgument clusters(clusterArg);
-    throwOnInvalidClusterRaster(clusters.raster());
+    auto& clusterRaster = clusters.raster();
+    throwOnInvalidClusterRaster(clusterRaster);
 
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::category_sum(clusters.get<int32_t>(), raster));
+        return Raster(withoutGil([&]() { return gdx::category_sum(clusterRaster.get<int32_t>(), raster); }));
     },
-                      RasterArgument(valuesArg).variant(clusters.raster()));
+                      RasterArgument(valuesArg).variant(clusterRaster));
 }
 
 Raster categoryMin(py::object clusterArg, py::object valuesArg)
 {
     RasterArgument clusters(clusterArg);
-    throwOnInvalidClusterRaster(clusters.raster());
+    auto& clusterRaster = clusters.raster();
+    throwOnInvalidClusterRaster(clusterRaster);
 
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::category_min(clusters.get<int32_t>(), raster));
+        return Raster(withoutGil([&]() { return gdx::category_min(clusterRaster.get<int32_t>(), raster); }));
     },
-                      RasterArgument(valuesArg).variant(clusters.raster()));
+                      RasterArgument(valuesArg).variant(clusterRaster));
 }
 
 Raster categoryMax(py::object clusterArg, py::object valuesArg)
 {
     RasterArgument clusters(clusterArg);
-    throwOnInvalidClusterRaster(clusters.raster());
+    auto& clusterRaster = clusters.raster();
+    throwOnInvalidClusterRaster(clusterRaster);
 
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::category_max(clusters.get<int32_t>(), raster));
+        return Raster(withoutGil([&]() { return gdx::category_max(clusterRaster.get<int32_t>(), raster); }));
     },
-                      RasterArgument(valuesArg).variant(clusters.raster()));
+                      RasterArgument(valuesArg).variant(clusterRaster));
 }
 
 Raster categoryMode(py::object clusterArg, py::object valuesArg)
 {
     RasterArgument clusters(clusterArg);
-    throwOnInvalidClusterRaster(clusters.raster());
+    auto& clusterRaster = clusters.raster();
+    throwOnInvalidClusterRaster(clusterRaster);
 
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::category_mode(clusters.get<int32_t>(), raster));
+        return Raster(withoutGil([&]() { return gdx::category_mode(clusterRaster.get<int32_t>(), raster); }));
     },
-                      RasterArgument(valuesArg).variant(clusters.raster()));
+                      RasterArgument(valuesArg).variant(clusterRaster));
 }
 
 Raster categoryFilterOr(py::object clusterArg, py::object filterArg)
 {
     RasterArgument clusters(clusterArg);
-    throwOnInvalidClusterRaster(clusters.raster());
+    auto& clusterRaster = clusters.raster();
+    throwOnInvalidClusterRaster(clusterRaster);
 
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::category_filter_or(clusters.get<int32_t>(), raster));
+        return Raster(withoutGil([&]() { return gdx::category_filter_or(clusterRaster.get<int32_t>(), raster); }));
     },
                       RasterArgument(filterArg).variant());
 }
@@ -506,10 +562,11 @@ Raster categoryFilterOr(py::object clusterArg, py::object filterArg)
 Raster categoryFilterAnd(py::object clusterArg, py::object filterArg)
 {
     RasterArgument clusters(clusterArg);
-    throwOnInvalidClusterRaster(clusters.raster());
+    auto& clusterRaster = clusters.raster();
+    throwOnInvalidClusterRaster(clusterRaster);
 
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::category_filter_and(clusters.get<int32_t>(), raster));
+        return Raster(withoutGil([&]() { return gdx::category_filter_and(clusterRaster.get<int32_t>(), raster); }));
     },
                       RasterArgument(filterArg).variant());
 }
@@ -517,10 +574,11 @@ Raster categoryFilterAnd(py::object clusterArg, py::object filterArg)
 Raster categoryFilterNot(py::object clusterArg, py::object filterArg)
 {
     RasterArgument clusters(clusterArg);
-    throwOnInvalidClusterRaster(clusters.raster());
+    auto& clusterRaster = clusters.raster();
+    throwOnInvalidClusterRaster(clusterRaster);
 
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::category_filter_not(clusters.get<int32_t>(), raster));
+        return Raster(withoutGil([&]() { return gdx::category_filter_not(clusterRaster.get<int32_t>(), raster); }));
     },
                       RasterArgument(filterArg).variant());
 }
@@ -528,10 +586,11 @@ Raster categoryFilterNot(py::object clusterArg, py::object filterArg)
 Raster categorySumInBuffer(py::object clusterArg, py::object valuesArg, double radiusInMeter)
 {
     RasterArgument clusters(clusterArg);
-    throwOnInvalidClusterRaster(clusters.raster());
+    auto& clusterRaster = clusters.raster();
+    throwOnInvalidClusterRaster(clusterRaster);
 
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::category_sum_in_buffer(clusters.get<int32_t>(), raster, static_cast<float>(radiusInMeter)));
+        return Raster(withoutGil([&]() { return gdx::category_sum_in_buffer(clusterRaster.get<int32_t>(), raster, static_cast<float>(radiusInMeter)); }));
     },
                       RasterArgument(valuesArg).variant());
 }
@@ -539,15 +598,23 @@ Raster categorySumInBuffer(py::object clusterArg, py::object valuesArg, double r
 Raster sumInBuffer(const Raster& anyRaster, float radius, BufferStyle bufferStyle)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::sum_in_buffer(raster, radius, bufferStyle));
+        return Raster(withoutGil([&]() { return gdx::sum_in_buffer(raster, radius, bufferStyle); }));
     },
                       anyRaster.get());
 }
 
-Raster maxInBuffer(const Raster& anyRaster, float radius)
+Raster maxInBuffer(const Raster& anyRaster, float radius, BufferStyle bufferStyle)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::max_in_buffer(raster, radius));
+        return Raster(withoutGil([&]() { return gdx::max_in_buffer(raster, radius, bufferStyle); }));
+    },
+                      anyRaster.get());
+}
+
+Raster minInBuffer(const Raster& anyRaster, float radius, BufferStyle bufferStyle)
+{
+    return std::visit([&](auto&& raster) {
+        return Raster(withoutGil([&]() { return gdx::min_in_buffer(raster, radius, bufferStyle); }));
     },
                       anyRaster.get());
 }
@@ -560,7 +627,7 @@ Raster reclass(const std::string& mappingFilepath, py::object rasterArg)
         return std::visit([](auto&& resultRaster) {
             return Raster(std::move(resultRaster));
         },
-                          gdx::reclass(mappingFilepath, inputRaster));
+                          withoutGil([&]() { return gdx::reclass(mappingFilepath, inputRaster); }));
     },
                       r.variant());
 }
@@ -574,7 +641,7 @@ Raster reclass(const std::string& mappingFilepath, py::object rasterArg1, py::ob
         return std::visit([](auto&& resultRaster) {
             return Raster(std::move(resultRaster));
         },
-                          gdx::reclass(mappingFilepath, raster1, raster2));
+                          withoutGil([&]() { return gdx::reclass(mappingFilepath, raster1, raster2); }));
     },
                       r1.variant(), r2.variant());
 }
@@ -589,7 +656,7 @@ Raster reclass(const std::string& mappingFilepath, py::object rasterArg1, py::ob
         return std::visit([](auto&& resultRaster) {
             return Raster(std::move(resultRaster));
         },
-                          gdx::reclass(mappingFilepath, raster1, raster2, raster3));
+                          withoutGil([&]() { return gdx::reclass(mappingFilepath, raster1, raster2, raster3); }));
     },
                       r1.variant(), r2.variant(), r3.variant());
 }
@@ -602,7 +669,7 @@ Raster reclassi(const std::string& mappingFilepath, py::object rasterArg, int32_
         return std::visit([](auto&& resultRaster) {
             return Raster(std::move(resultRaster));
         },
-                          gdx::reclassi(mappingFilepath, raster, index));
+                          withoutGil([&]() { return gdx::reclassi(mappingFilepath, raster, index); }));
     },
                       r.variant());
 }
@@ -616,7 +683,7 @@ Raster reclassi(const std::string& mappingFilepath, py::object rasterArg1, py::o
         return std::visit([](auto&& resultRaster) {
             return Raster(std::move(resultRaster));
         },
-                          gdx::reclassi(mappingFilepath, raster1, raster2, index));
+                          withoutGil([&]() { return gdx::reclassi(mappingFilepath, raster1, raster2, index); }));
     },
                       r1.variant(), r2.variant());
 }
@@ -631,7 +698,7 @@ Raster reclassi(const std::string& mappingFilepath, py::object rasterArg1, py::o
         return std::visit([](auto&& resultRaster) {
             return Raster(std::move(resultRaster));
         },
-                          gdx::reclassi(mappingFilepath, raster1, raster2, raster3, index));
+                          withoutGil([&]() { return gdx::reclassi(mappingFilepath, raster1, raster2, raster3, index); }));
     },
                       r1.variant(), r2.variant(), r3.variant());
 }
@@ -639,138 +706,87 @@ Raster reclassi(const std::string& mappingFilepath, py::object rasterArg1, py::o
 Raster nreclass(const std::string& mappingFilepath, py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(gdx::nreclass(mappingFilepath, raster));
+        return Raster(withoutGil([&]() { return gdx::nreclass(mappingFilepath, raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
 
 Raster logicalAnd(py::object rasterArg1, py::object rasterArg2)
 {
-    return RasterArgument(rasterArg1).raster() && RasterArgument(rasterArg2).raster();
+    return logicalAndOf(rasterArg1, rasterArg2);
 }
 
 Raster logicalAnd(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3)
 {
-    return RasterArgument(rasterArg1).raster() &&
-           RasterArgument(rasterArg2).raster() &&
-           RasterArgument(rasterArg3).raster();
+    return logicalAndOf(rasterArg1, rasterArg2, rasterArg3);
 }
 
 Raster logicalAnd(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3, py::object rasterArg4)
 {
-    return RasterArgument(rasterArg1).raster() &&
-           RasterArgument(rasterArg2).raster() &&
-           RasterArgument(rasterArg3).raster() &&
-           RasterArgument(rasterArg4).raster();
+    return logicalAndOf(rasterArg1, rasterArg2, rasterArg3, rasterArg4);
 }
 
 Raster logicalAnd(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3, py::object rasterArg4, py::object rasterArg5)
 {
-    return RasterArgument(rasterArg1).raster() &&
-           RasterArgument(rasterArg2).raster() &&
-           RasterArgument(rasterArg3).raster() &&
-           RasterArgument(rasterArg4).raster() &&
-           RasterArgument(rasterArg5).raster();
+    return logicalAndOf(rasterArg1, rasterArg2, rasterArg3, rasterArg4, rasterArg5);
 }
 
 Raster logicalAnd(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3, py::object rasterArg4, py::object rasterArg5, py::object rasterArg6)
 {
-    return RasterArgument(rasterArg1).raster() &&
-           RasterArgument(rasterArg2).raster() &&
-           RasterArgument(rasterArg3).raster() &&
-           RasterArgument(rasterArg4).raster() &&
-           RasterArgument(rasterArg5).raster() &&
-           RasterArgument(rasterArg6).raster();
+    return logicalAndOf(rasterArg1, rasterArg2, rasterArg3, rasterArg4, rasterArg5, rasterArg6);
 }
 
 Raster logicalAnd(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3, py::object rasterArg4, py::object rasterArg5, py::object rasterArg6, py::object rasterArg7)
 {
-    return RasterArgument(rasterArg1).raster() &&
-           RasterArgument(rasterArg2).raster() &&
-           RasterArgument(rasterArg3).raster() &&
-           RasterArgument(rasterArg4).raster() &&
-           RasterArgument(rasterArg5).raster() &&
-           RasterArgument(rasterArg6).raster() &&
-           RasterArgument(rasterArg7).raster();
+    return logicalAndOf(rasterArg1, rasterArg2, rasterArg3, rasterArg4, rasterArg5, rasterArg6, rasterArg7);
 }
 
 Raster logicalAnd(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3, py::object rasterArg4, py::object rasterArg5, py::object rasterArg6, py::object rasterArg7, py::object rasterArg8)
 {
-    return RasterArgument(rasterArg1).raster() &&
-           RasterArgument(rasterArg2).raster() &&
-           RasterArgument(rasterArg3).raster() &&
-           RasterArgument(rasterArg4).raster() &&
-           RasterArgument(rasterArg5).raster() &&
-           RasterArgument(rasterArg6).raster() &&
-           RasterArgument(rasterArg7).raster() &&
-           RasterArgument(rasterArg8).raster();
+    return logicalAndOf(rasterArg1, rasterArg2, rasterArg3, rasterArg4, rasterArg5, rasterArg6, rasterArg7, rasterArg8);
 }
 
 Raster logicalOr(py::object rasterArg1, py::object rasterArg2)
 {
-    return RasterArgument(rasterArg1).raster() || RasterArgument(rasterArg2).raster();
+    return logicalOrOf(rasterArg1, rasterArg2);
 }
 
 Raster logicalOr(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3)
 {
-    return RasterArgument(rasterArg1).raster() ||
-           RasterArgument(rasterArg2).raster() ||
-           RasterArgument(rasterArg3).raster();
+    return logicalOrOf(rasterArg1, rasterArg2, rasterArg3);
 }
 
 Raster logicalOr(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3, py::object rasterArg4)
 {
-    return RasterArgument(rasterArg1).raster() ||
-           RasterArgument(rasterArg2).raster() ||
-           RasterArgument(rasterArg3).raster() ||
-           RasterArgument(rasterArg4).raster();
+    return logicalOrOf(rasterArg1, rasterArg2, rasterArg3, rasterArg4);
 }
 
 Raster logicalOr(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3, py::object rasterArg4, py::object rasterArg5)
 {
-    return RasterArgument(rasterArg1).raster() ||
-           RasterArgument(rasterArg2).raster() ||
-           RasterArgument(rasterArg3).raster() ||
-           RasterArgument(rasterArg4).raster() ||
-           RasterArgument(rasterArg5).raster();
+    return logicalOrOf(rasterArg1, rasterArg2, rasterArg3, rasterArg4, rasterArg5);
 }
 
 Raster logicalOr(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3, py::object rasterArg4, py::object rasterArg5, py::object rasterArg6)
 {
-    return RasterArgument(rasterArg1).raster() ||
-           RasterArgument(rasterArg2).raster() ||
-           RasterArgument(rasterArg3).raster() ||
-           RasterArgument(rasterArg4).raster() ||
-           RasterArgument(rasterArg5).raster() ||
-           RasterArgument(rasterArg6).raster();
+    return logicalOrOf(rasterArg1, rasterArg2, rasterArg3, rasterArg4, rasterArg5, rasterArg6);
 }
 
 Raster logicalOr(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3, py::object rasterArg4, py::object rasterArg5, py::object rasterArg6, py::object rasterArg7)
 {
-    return RasterArgument(rasterArg1).raster() ||
-           RasterArgument(rasterArg2).raster() ||
-           RasterArgument(rasterArg3).raster() ||
-           RasterArgument(rasterArg4).raster() ||
-           RasterArgument(rasterArg5).raster() ||
-           RasterArgument(rasterArg6).raster() ||
-           RasterArgument(rasterArg7).raster();
+    return logicalOrOf(rasterArg1, rasterArg2, rasterArg3, rasterArg4, rasterArg5, rasterArg6, rasterArg7);
 }
 
 Raster logicalOr(py::object rasterArg1, py::object rasterArg2, py::object rasterArg3, py::object rasterArg4, py::object rasterArg5, py::object rasterArg6, py::object rasterArg7, py::object rasterArg8)
 {
-    return RasterArgument(rasterArg1).raster() ||
-           RasterArgument(rasterArg2).raster() ||
-           RasterArgument(rasterArg3).raster() ||
-           RasterArgument(rasterArg4).raster() ||
-           RasterArgument(rasterArg5).raster() ||
-           RasterArgument(rasterArg6).raster() ||
-           RasterArgument(rasterArg7).raster() ||
-           RasterArgument(rasterArg8).raster();
+    return logicalOrOf(rasterArg1, rasterArg2, rasterArg3, rasterArg4, rasterArg5, rasterArg6, rasterArg7, rasterArg8);
 }
 
 Raster logicalNot(py::object rasterArg)
 {
-    return !RasterArgument(rasterArg).raster();
+    RasterArgument r(rasterArg);
+    auto& raster = r.raster();
+
+    return withoutGil([&]() { return !raster; });
 }
 
 Raster ifThenElse(py::object ifArg, py::object thenArg, py::object elseArg)
@@ -779,7 +795,7 @@ Raster ifThenElse(py::object ifArg, py::object thenArg, py::object elseArg)
     auto& ifRaster = ifRasterArg.raster();
 
     return std::visit([](auto&& rasterIf, auto&& rasterThen, auto&& rasterElse) -> Raster {
-        return Raster(gdx::if_then_else(rasterIf, rasterThen, rasterElse));
+        return Raster(withoutGil([&]() { return gdx::if_then_else(rasterIf, rasterThen, rasterElse); }));
     },
                       ifRaster.get(), RasterArgument(thenArg).variant(ifRaster.metadata()), RasterArgument(elseArg).variant(ifRaster.metadata()));
 }
@@ -787,9 +803,11 @@ Raster ifThenElse(py::object ifArg, py::object thenArg, py::object elseArg)
 bool rasterEqual(py::object rasterArg1, py::object rasterArg2)
 {
     RasterArgument r1(rasterArg1);
+    RasterArgument r2(rasterArg2);
     auto& raster1 = r1.raster();
+    auto& raster2 = r2.raster(raster1);
 
-    return raster1.equalTo(RasterArgument(rasterArg2).raster(raster1));
+    return withoutGil([&]() { return raster1.equalTo(raster2); });
 }
 
 Raster rasterEqualOneOf(py::object rasterArg, const std::vector<double>& values)
@@ -798,7 +816,7 @@ Raster rasterEqualOneOf(py::object rasterArg, const std::vector<double>& values)
         using T = value_type<decltype(raster)>;
         std::vector<T> tvalues(values.size());
         std::transform(values.begin(), values.end(), tvalues.begin(), [](auto v) { return static_cast<T>(v); });
-        return Raster(gdx::rasterEqualOneOf(raster, tvalues));
+        return Raster(withoutGil([&]() { return gdx::rasterEqualOneOf(raster, tvalues); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -806,9 +824,11 @@ Raster rasterEqualOneOf(py::object rasterArg, const std::vector<double>& values)
 bool allClose(py::object rasterArg1, py::object rasterArg2, double tolerance)
 {
     RasterArgument r1(rasterArg1);
+    RasterArgument r2(rasterArg2);
     auto& raster1 = r1.raster();
+    auto& raster2 = r2.raster(raster1);
 
-    return raster1.tolerant_data_equal_to(RasterArgument(rasterArg2).raster(raster1), tolerance);
+    return withoutGil([&]() { return raster1.tolerant_data_equal_to(raster2, tolerance); });
 }
 
 Raster isClose(py::object rasterArg1, py::object rasterArg2, double relTolerance)
@@ -823,7 +843,7 @@ Raster isClose(py::object rasterArg1, py::object rasterArg2, double relTolerance
 
     return std::visit([&raster2, relTolerance](auto&& raster1) -> Raster {
         using T = value_type<decltype(raster1)>;
-        return Raster(gdx::isClose(raster1, raster2.get<T>(), static_cast<T>(relTolerance)));
+        return Raster(withoutGil([&]() { return gdx::isClose(raster1, raster2.get<T>(), static_cast<T>(relTolerance)); }));
     },
                       raster1.get());
 }
@@ -842,7 +862,7 @@ static MaskedRaster<uint8_t> maskedis_nodata(const MaskedRaster<T>& input)
 Raster is_nodata(py::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
-        return Raster(maskedis_nodata(raster));
+        return Raster(withoutGil([&]() { return maskedis_nodata(raster); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -851,7 +871,9 @@ Raster replaceValue(py::object rasterArg, py::object searchValue, py::object rep
 {
     return std::visit([&](auto&& raster) {
         using T = value_type<decltype(raster)>;
-        return Raster(gdx::replace_value(raster, searchValue.cast<T>(), replaceValue.cast<T>()));
+        const auto search      = searchValue.cast<T>();
+        const auto replacement = replaceValue.cast<T>();
+        return Raster(withoutGil([&]() { return gdx::replace_value(raster, search, replacement); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -860,7 +882,8 @@ Raster replaceNodata(py::object rasterArg, py::object replaceValue)
 {
     return std::visit([&](auto&& raster) {
         using T = value_type<decltype(raster)>;
-        return Raster(gdx::replace_nodata(raster, replaceValue.cast<T>()));
+        const auto replacement = replaceValue.cast<T>();
+        return Raster(withoutGil([&]() { return gdx::replace_nodata(raster, replacement); }));
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -869,7 +892,7 @@ Raster& replaceNodataInPlace(Raster& raster, double replaceValue)
 {
     std::visit([replaceValue](auto&& ras) {
         using T = value_type<decltype(ras)>;
-        gdx::replace_nodata_in_place(ras, static_cast<T>(replaceValue));
+        withoutGil([&]() { gdx::replace_nodata_in_place(ras, static_cast<T>(replaceValue)); });
     },
                raster.get());
     return raster;
@@ -878,7 +901,7 @@ Raster& replaceNodataInPlace(Raster& raster, double replaceValue)
 void drawShapeFileOnRaster(Raster& anyRaster, const std::string& shapeFilepath)
 {
     return std::visit([&](auto&& raster) {
-        gdx::draw_shapefile_on_raster(raster, shapeFilepath);
+        withoutGil([&]() { gdx::draw_shapefile_on_raster(raster, shapeFilepath); });
     },
                       anyRaster.get());
 }
@@ -892,7 +915,8 @@ bool lddValidate(py::object rasterArg,
     return std::visit([&](auto&& raster) -> bool {
         using T = value_type<decltype(raster)>;
         if constexpr (std::is_same_v<T, uint8_t>) {
-            return gdx::validate_ldd(raster, loopCb, invalidValueCb, endsInNodataCb, outsideOfMapCb);
+            // the callbacks are invoked from the worker threads, the python callback wrappers acquire the GIL on every call
+            return withoutGil([&]() { return gdx::validate_ldd(raster, loopCb, invalidValueCb, endsInNodataCb, outsideOfMapCb); });
         } else {
             throw InvalidArgument("Ldd raster should be of type uint8_t");
         }
@@ -909,7 +933,7 @@ Raster lddFix(py::object rasterArg)
             Point<int32_t> topLeft(int32_t(meta.xll), int32_t(meta.yll - meta.rows));
 
             std::set<Cell> errors;
-            auto res = gdx::fix_ldd(raster, errors);
+            auto res = withoutGil([&]() { return gdx::fix_ldd(raster, errors); });
             for (auto& cell : errors) {
                 auto point = inf::gdal::projected_to_geographic(31370, Point<double>(topLeft.x + cell.c, topLeft.y + cell.r));
                 fmt::print(stderr, "Error cell: {}x{} -> {}x{}\n", cell.r, cell.c, point.x, point.y);
@@ -943,7 +967,7 @@ Raster accuflux(py::object lddArg, py::object freightArg)
         throw InvalidArgument("Expected freightMap raster to be of type float (numpy.dtype('float32'))");
     }
 
-    return Raster(gdx::accuflux(lddRaster.get<uint8_t>(), freightRaster.get<float>()));
+    return Raster(withoutGil([&]() { return gdx::accuflux(lddRaster.get<uint8_t>(), freightRaster.get<float>()); }));
 }
 
 Raster accufractionflux(py::object lddArg, py::object freightArg, py::object fractionArg)
@@ -966,7 +990,7 @@ Raster accufractionflux(py::object lddArg, py::object freightArg, py::object fra
         throw InvalidArgument("Expected fraction map raster to be of type float (numpy.dtype('float32'))");
     }
 
-    return Raster(gdx::accufractionflux(lddRaster.get<uint8_t>(), freightRaster.get<float>(), fractionRaster.get<float>()));
+    return Raster(withoutGil([&]() { return gdx::accufractionflux(lddRaster.get<uint8_t>(), freightRaster.get<float>(), fractionRaster.get<float>()); }));
 }
 
 Raster fluxOrigin(py::object lddArg, py::object freightArg, py::object fractionArg, py::object stationArg)
@@ -996,7 +1020,7 @@ Raster fluxOrigin(py::object lddArg, py::object freightArg, py::object fractionA
         throw InvalidArgument("Expected station map raster to be of type int (numpy.dtype('int32'))");
     }
 
-    return Raster(gdx::flux_origin(lddRaster.get<uint8_t>(), freightRaster.get<float>(), fractionRaster.get<float>(), stationRaster.get<int32_t>()));
+    return Raster(withoutGil([&]() { return gdx::flux_origin(lddRaster.get<uint8_t>(), freightRaster.get<float>(), fractionRaster.get<float>(), stationRaster.get<int32_t>()); }));
 }
 
 Raster lddCluster(py::object lddArg, py::object idArg)
@@ -1014,7 +1038,7 @@ Raster lddCluster(py::object lddArg, py::object idArg)
         throw InvalidArgument("Expected id map raster to be of type int (numpy.dtype('int32'))");
     }
 
-    return Raster(gdx::ldd_cluster(lddRaster.get<uint8_t>(), idsRaster.get<int32_t>()));
+    return Raster(withoutGil([&]() { return gdx::ldd_cluster(lddRaster.get<uint8_t>(), idsRaster.get<int32_t>()); }));
 }
 
 Raster lddDist(py::object lddArg, py::object pointsArg, py::object frictionArg)
@@ -1038,7 +1062,7 @@ Raster lddDist(py::object lddArg, py::object pointsArg, py::object frictionArg)
         throw InvalidArgument("Expected friction map raster to be of type float (numpy.dtype('float32'))");
     }
 
-    return Raster(gdx::ldd_dist(lddRaster.get<uint8_t>(), pointsRaster.get<float>(), frictionRaster.get<float>()));
+    return Raster(withoutGil([&]() { return gdx::ldd_dist(lddRaster.get<uint8_t>(), pointsRaster.get<float>(), frictionRaster.get<float>()); }));
 }
 
 Raster slopeLength(py::object lddArg, py::object frictionArg)
@@ -1055,7 +1079,7 @@ Raster slopeLength(py::object lddArg, py::object frictionArg)
         throw InvalidArgument("Expected friction map raster to be of type float (numpy.dtype('float32'))");
     }
 
-    return Raster(gdx::slope_length(lddRaster.get<uint8_t>(), frictionRaster.get<float>()));
+    return Raster(withoutGil([&]() { return gdx::slope_length(lddRaster.get<uint8_t>(), frictionRaster.get<float>()); }));
 }
 
 Raster max_upstream_dist(py::object lddArg)
@@ -1066,14 +1090,14 @@ Raster max_upstream_dist(py::object lddArg)
         throw InvalidArgument("Expected ldd raster to be of type uint8 (numpy.dtype('B'))");
     }
 
-    return Raster(gdx::max_upstream_dist(lddRaster.get<uint8_t>()));
+    return Raster(withoutGil([&]() { return gdx::max_upstream_dist(lddRaster.get<uint8_t>()); }));
 }
 
 RasterStats<512> statistics(pybind11::object rasterArg)
 {
     return std::visit([&](auto&& raster) {
         using T = value_type<decltype(raster)>;
-        return gdx::statistics<decltype(raster), 512>(raster, std::numeric_limits<T>::max());
+        return withoutGil([&]() { return gdx::statistics<decltype(raster), 512>(raster, std::numeric_limits<T>::max()); });
     },
                       RasterArgument(rasterArg).variant());
 }
@@ -1084,7 +1108,7 @@ void tableRow(const std::string& output, pybind11::object rasterArg, pybind11::o
     RasterArgument r2(categoryArg);
 
     return std::visit([&](auto&& raster, auto&& categories) {
-        return gdx::table_row(raster, categories, op, output, label, append);
+        withoutGil([&]() { gdx::table_row(raster, categories, op, output, label, append); });
     },
                       r1.variant(), r2.variant());
 }
@@ -1102,7 +1126,7 @@ Raster& randomFill(Raster& raster, double minValue, double maxValue)
             throw InvalidArgument("maximum value does not fit in the raster datatype ({} > {})", maxValue, std::numeric_limits<T>::max());
         }
 
-        gdx::fill_random(typedRaster, truncate<T>(minValue), truncate<T>(maxValue));
+        withoutGil([&]() { gdx::fill_random(typedRaster, truncate<T>(minValue), truncate<T>(maxValue)); });
     },
                raster.get());
     return raster;
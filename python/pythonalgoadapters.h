@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gdx/algo/bufferstyle.h"
+#include "gdx/algo/distancemethod.h"
 #include "gdx/algo/statistics.h"
 #include "gdx/algo/tablerow.h"
 #include "gdx/raster.h"
@@ -41,12 +42,12 @@ Raster clusterIdWithObstacles(pybind11::object rasterArg, pybind11::object obsta
 Raster fuzzyClusterId(pybind11::object rasterArg, float radius);
 Raster fuzzyClusterIdWithObstacles(pybind11::object rasterArg, pybind11::object obstacleRasterArg, float radius);
 
-Raster distance(pybind11::object targetArg, pybind11::object barrierArg, bool includeDiagonal);
+Raster distance(pybind11::object targetArg, pybind11::object barrierArg, bool includeDiagonal, DistanceMethod method);
 Raster travelDistance(pybind11::object rasterArg, pybind11::object anyTravelTime);
 Raster sumWithinTravelDistance(pybind11::object anyMask, pybind11::object anyResistance, pybind11::object anyValuesMap, double maxResistance, bool includeAdjacent);
 Raster sumTargetsWithinTravelDistance(pybind11::object anyTargets, pybind11::object anyResistance, double maxResistance);
-Raster closestTarget(pybind11::object rasterArg);
-Raster valueAtClosestTarget(pybind11::object rasterArg, pybind11::object valuesArg);
+Raster closestTarget(pybind11::object rasterArg, DistanceMethod method);
+Raster valueAtClosestTarget(pybind11::object rasterArg, pybind11::object valuesArg, DistanceMethod method);
 Raster valueAtClosestTravelTarget(pybind11::object rasterArg, pybind11::object travelTimeArg, pybind11::object valuesArg);
 Raster valueAtClosestLessThenTravelTarget(pybind11::object rasterArg, pybind11::object travelTimeArg, double maxTravelTime, pybind11::object valuesArg);
 Raster nodeValueDistanceDecay(pybind11::object targetArg, pybind11::object travelTimeArg, double maxTravelTime, double a, double b);
@@ -61,7 +62,8 @@ Raster categoryFilterNot(pybind11::object clusterArg, pybind11::object filterArg
 Raster categorySumInBuffer(pybind11::object clusterArg, pybind11::object valuesArg, double radiusInMeter);
 
 Raster sumInBuffer(const Raster& anyRaster, float radius, BufferStyle bufferStyle);
-Raster maxInBuffer(const Raster& anyRaster, float radius);
+Raster maxInBuffer(const Raster& anyRaster, float radius, BufferStyle bufferStyle);
+Raster minInBuffer(const Raster& anyRaster, float radius, BufferStyle bufferStyle);
 Raster reclass(const std::string& mappingFilepath, pybind11::object rasterArg);
 Raster reclass(const std::string& mappingFilepath, pybind11::object rasterArg1, pybind11::object rasterArg2);
 Raster reclass(const std::string& mappingFilepath, pybind11::object rasterArg1, pybind11::object rasterArg2, pybind11::object rasterArg3);
@@ -16,6 +16,9 @@ LogSink<Mutex>::LogSink()
 template <typename Mutex>
 void LogSink<Mutex>::sink_it_(const spdlog::details::log_msg& msg)
 {
+    // the algorithms run without holding the GIL, it is needed to call the python logger
+    py::gil_scoped_acquire acquire;
+
     spdlog::memory_buf_t formatted;
     spdlog::sinks::base_sink<Mutex>::formatter_->format(msg, formatted);
 
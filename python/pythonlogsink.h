@@ -24,6 +24,8 @@ private:
     pybind11::object _warnings;
 };
 
+// The sink acquires the GIL, which also serialises the log calls: use LogSinkSt to avoid
+// a deadlock between the sink mutex and the GIL when algorithms log without holding the GIL
 using LogSinkMt = LogSink<std::mutex>;
 using LogSinkSt = LogSink<spdlog::details::null_mutex>;
 }
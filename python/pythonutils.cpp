@@ -2,11 +2,20 @@
 
 #include "gdx/exception.h"
 
+#include <atomic>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace gdx {
 
 namespace py = pybind11;
 using namespace py::literals;
 
+// 0: use the OpenMP default
+static std::atomic<int> s_threadCount = 0;
+
 const std::type_info& dtypeToRasterType(py::dtype type)
 {
     auto typeStr = static_cast<std::string>(py::str(type));
@@ -48,4 +57,33 @@ fs::path handle_path(py::object arg)
         return fs::u8path(std::string(py::str(arg.attr("__str__")())));
     }
 }
+
+void setThreadCount(int count)
+{
+    if (count <= 0) {
+        throw InvalidArgument("The number of threads should be positive ({})", count);
+    }
+
+    s_threadCount = count;
+    applyThreadCount();
+}
+
+int threadCount()
+{
+#ifdef _OPENMP
+    applyThreadCount();
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+void applyThreadCount()
+{
+#ifdef _OPENMP
+    if (const auto count = s_threadCount.load(); count > 0) {
+        omp_set_num_threads(count);
+    }
+#endif
+}
 }
@@ -28,4 +28,23 @@ auto visitArray(const pybind11::array& arr, Callable&& visitor)
 
 fs::path handle_path(pybind11::object arg);
 
+/* The number of threads that are used by the parallel algorithms
+ * OpenMP keeps the thread count per calling thread, so the configured count is applied
+ * on the calling python thread before every computation
+ */
+void setThreadCount(int count);
+int threadCount();
+void applyThreadCount();
+
+/* Runs the computation without holding the python GIL, so other python threads can run concurrently
+ * The computation can not access python objects, resolve the RasterArguments before calling this
+ */
+template <typename Callable>
+auto withoutGil(Callable&& computation)
+{
+    pybind11::gil_scoped_release release;
+    applyThreadCount();
+    return computation();
+}
+
 }
@@ -2,6 +2,7 @@
 #include "gdx/config.h"
 #include "gdx/raster.h"
 #include "infra/filesystem.h"
+#include "pythonutils.h"
 
 namespace gdx {
 
@@ -22,7 +23,7 @@ Raster& RasterArgument::raster()
             if (!fs::exists(path)) {
                 throw InvalidArgument("Provided raster path is not valid: {}", _ob.cast<std::string>());
             }
-            _raster = std::make_unique<Raster>(Raster::read(path));
+            _raster = std::make_unique<Raster>(withoutGil([&]() { return Raster::read(path); }));
         }
 
         return *_raster;
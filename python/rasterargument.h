@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gdx/raster.h"
+#include "rastercaster.h"
 
 #include "gdx/algo/maximum.h"
 #include "gdx/maskedraster.h"
@@ -21,6 +22,8 @@ struct NodataType
 // - An actual raster instance
 // - strings: this should be the path of the raster file
 // - numeric values: if there is a context raster provided from which we can determine the size and type
+// The argument inspects the python object, so it has to be resolved while holding the GIL.
+// Resolve all the arguments before releasing the GIL for the computation (see withoutGil).
 
 class RasterArgument
 {
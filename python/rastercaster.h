@@ -0,0 +1,38 @@
+#pragma once
+
+#include "gdx/raster.h"
+
+#include <pybind11/pybind11.h>
+
+namespace gdx {
+
+// Applies the changes python made to the numpy mask of the raster (the mask of Raster.array) to the raster nodata mask
+void applyNumpyMaskChanges(Raster& raster);
+
+}
+
+namespace pybind11::detail {
+
+// Every raster that is passed from python to c++ first receives the nodata changes made through its numpy mask
+// numpy needs a byte per cell, so it gets a byte view of the packed raster mask that can not be written back immediately
+// Included from pythonadapters.h, so every translation unit that converts rasters uses this caster.
+// Only rasters with a living Raster.array mask are compared with their byte view, only changed words are written.
+template <>
+class type_caster<gdx::Raster> : public type_caster_base<gdx::Raster>
+{
+public:
+    bool load(handle src, bool convert)
+    {
+        if (!type_caster_base<gdx::Raster>::load(src, convert)) {
+            return false;
+        }
+
+        if (value != nullptr) {
+            gdx::applyNumpyMaskChanges(*static_cast<gdx::Raster*>(value));
+        }
+
+        return true;
+    }
+};
+
+}
@@ -278,6 +278,46 @@ class TestGdx(unittest.TestCase):
         result = gdx.raster_from_ndarray(array == 0, meta)
         np.testing.assert_array_equal(result.array, np.ones((2, 2)))
 
+    def test_create_from_strided_array(self):
+        meta = gdx.raster_metadata(rows=3, cols=4)
+        wide = np.arange(24, dtype="i").reshape(3, 8)
+
+        np.testing.assert_array_equal(wide[:, ::2], gdx.raster_from_ndarray(wide[:, ::2], meta).array)
+        np.testing.assert_array_equal(wide[:, 4:], gdx.raster_from_ndarray(wide[:, 4:], meta).array)
+        np.testing.assert_array_equal(wide[:, ::-2], gdx.raster_from_ndarray(wide[:, ::-2], meta).array)
+
+        square = np.arange(16, dtype="f").reshape(4, 4)
+        meta = gdx.raster_metadata(rows=4, cols=4)
+        np.testing.assert_array_equal(square.T, gdx.raster_from_ndarray(square.T, meta).array)
+
+    def test_create_from_array_with_single_row_or_column(self):
+        # the stride of the inserted axis is 0
+        x = np.arange(5, dtype="f")
+
+        row = gdx.raster_from_ndarray(x[None, :], gdx.raster_metadata(rows=1, cols=5))
+        np.testing.assert_array_equal(x[None, :], row.array)
+
+        col = gdx.raster_from_ndarray(x[:, None], gdx.raster_metadata(rows=5, cols=1))
+        np.testing.assert_array_equal(x[:, None], col.array)
+
+        # int64 is converted to the raster type first
+        col = gdx.raster_from_ndarray(np.expand_dims(np.arange(5), 1), gdx.raster_metadata(rows=5, cols=1))
+        np.testing.assert_array_equal(np.arange(5)[:, None], col.array)
+
+    def test_raster_buffer_protocol(self):
+        meta = gdx.raster_metadata(rows=3, cols=4)
+        ras = gdx.raster_from_ndarray(np.arange(12, dtype="f").reshape(3, 4), meta)
+
+        view = np.asarray(ras)
+        self.assertEqual(np.dtype("float32"), view.dtype)
+        self.assertTrue(np.shares_memory(view, ras.array.data))
+
+        view[0, 0] = 42
+        self.assertEqual(42, ras.array[0, 0])
+
+    def test_cpu_instruction_set(self):
+        self.assertIn(gdx.cpu_instruction_set(), ["generic", "sse4.2", "avx2", "avx512"])
+
     def test_create_from_float_array_bad_dimension(self):
         array = np.array(
             [[0, 0, 0, 0, 0], [0, 1, 1, 1, 1], [0, 0, 0, 0, 0], [0, 0, 0, 0, 0]],
@@ -461,6 +501,27 @@ class TestGdx(unittest.TestCase):
         ras = gdx.raster_from_ndarray(array, meta)
         self.assertTrue(gdx.all(gdx.is_nodata(ras)))
 
+    def test_mask_cells_through_array(self):
+        meta = gdx.raster_metadata(rows=2, cols=3)
+        meta.nodata = -1
+        ras = gdx.raster_from_ndarray(np.arange(6, dtype="f").reshape(2, 3), meta)
+
+        # the raster has no nodata cells yet, the mask is still shared
+        ras.array[0, 1] = np.ma.masked
+        arr = ras.array
+        arr.mask[1, 2] = True
+
+        expected = np.array([[False, True, False], [False, False, True]])
+        np.testing.assert_array_equal(expected, gdx.is_nodata(ras).array)
+        np.testing.assert_array_equal(expected, ras.array.mask)
+
+        # changes made by the raster are visible in the existing array
+        ras.set_value(0, 1, 7)
+        self.assertFalse(arr.mask[0, 1])
+
+        arr[1, 2] = 9
+        np.testing.assert_array_equal(np.zeros((2, 3), dtype=bool), gdx.is_nodata(ras).array)
+
     def test_min_max(self):
         meta = gdx.raster_metadata(rows=3, cols=3)
         array1 = gdx.raster_from_ndarray(np.full((3, 3), 2, dtype=int), meta)
@@ -588,6 +649,54 @@ class TestGdx(unittest.TestCase):
         b = gdx.if_then_else(a > 0, a, a)
         self.assertTrue(a.metadata.nodata == b.metadata.nodata)
 
+    def test_ldd_validate(self):
+        # every column flows down to the pits in the last row, the rows are validated in parallel
+        meta = gdx.raster_metadata(rows=40, cols=10)
+        meta.cell_size = 10
+        arr = np.full((40, 10), 2, dtype=np.uint8)
+        arr[-1, :] = 5
+        self.assertTrue(gdx.ldd_validate(gdx.raster_from_ndarray(arr, meta)))
+
+        # columns 3 and 4 flow into a loop, column 7 into an invalid value
+        arr[10, 3] = 6
+        arr[10, 4] = 4
+        arr[30, 7] = 12
+        loops = set()
+        invalid_values = set()
+        valid = gdx.ldd_validate(
+            gdx.raster_from_ndarray(arr, meta),
+            loop_cb=lambda r, c: loops.add((r, c)),
+            invalid_value_cb=lambda r, c: invalid_values.add((r, c)),
+        )
+
+        self.assertFalse(valid)
+        self.assertEqual({(10, 3), (10, 4)}, loops)
+        self.assertEqual({(30, 7)}, invalid_values)
+
+    def test_algorithms_from_python_threads(self):
+        from concurrent.futures import ThreadPoolExecutor
+
+        threads = gdx.get_num_threads()
+        gdx.set_num_threads(1)
+        self.assertEqual(1, gdx.get_num_threads())
+        self.assertRaises(ValueError, gdx.set_num_threads, 0)
+
+        meta = gdx.raster_metadata(rows=50, cols=40)
+        meta.cell_size = 10
+        rasters = []
+        for i in range(8):
+            arr = np.zeros((50, 40), dtype=np.int32)
+            arr[i::7, i::5] = 1
+            rasters.append(gdx.raster_from_ndarray(arr, meta))
+
+        expected = [gdx.cluster_id(ras, True) for ras in rasters]
+        with ThreadPoolExecutor(max_workers=4) as pool:
+            results = list(pool.map(lambda ras: gdx.cluster_id(ras, True), rasters))
+
+        gdx.set_num_threads(threads)
+        for exp, res in zip(expected, results):
+            self.assertTrue(np.array_equal(exp.array, res.array))
+
 
 if __name__ == "__main__":
     unittest.main()